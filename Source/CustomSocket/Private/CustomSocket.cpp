@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CustomSocket.h"
+
+#include "CustomSocketRuntimeStats.h"
+
+DEFINE_STAT(STAT_CustomSocket_InitializeSeatBlob);
+DEFINE_STAT(STAT_CustomSocket_OpenMappedSeatBlob);
+DEFINE_STAT(STAT_CustomSocket_InitializeSeatMapView);
+DEFINE_STAT(STAT_CustomSocket_OccupantRaycast);
+DEFINE_STAT(STAT_CustomSocket_OccupantOverlap);
+
+DEFINE_LOG_CATEGORY(LogCustomSocketRuntime);
+
+void FCustomSocketModule::StartupModule()
+{
+}
+
+void FCustomSocketModule::ShutdownModule()
+{
+}
+
+IMPLEMENT_MODULE(FCustomSocketModule, CustomSocket)
@@ -0,0 +1,22 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("CustomSocketRuntime"), STATGROUP_CustomSocketRuntime, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Initialize Seat Blob"), STAT_CustomSocket_InitializeSeatBlob, STATGROUP_CustomSocketRuntime, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Open Mapped Seat Blob"), STAT_CustomSocket_OpenMappedSeatBlob, STATGROUP_CustomSocketRuntime, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Initialize Seat Map View"), STAT_CustomSocket_InitializeSeatMapView, STATGROUP_CustomSocketRuntime, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Occupant Raycast"), STAT_CustomSocket_OccupantRaycast, STATGROUP_CustomSocketRuntime, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Occupant Overlap"), STAT_CustomSocket_OccupantOverlap, STATGROUP_CustomSocketRuntime, );
+
+/** Times the scope for stat CustomSocketRuntime, builds without stats still get a named trace scope. */
+#if STATS
+#define SEAT_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define SEAT_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
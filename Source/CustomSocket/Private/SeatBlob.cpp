@@ -0,0 +1,560 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatBlob.h"
+
+#include "CustomSocket.h"
+#include "CustomSocketRuntimeStats.h"
+#include "SeatOccupantBVH.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SeatBlob
+{
+	uint64 MakeMeshId(const FSoftObjectPath& MeshPath)
+	{
+		const FTCHARToUTF8 Path(*MeshPath.ToString().ToUpper());
+		return CityHash64(Path.Get(), Path.Length());
+	}
+
+	bool GetFireArcCell(float YawScope, float PitchScope, const FVector& SeatDirection, int32& OutCell)
+	{
+		if (YawScope <= 0.f || PitchScope <= 0.f || SeatDirection.IsNearlyZero())
+			return false;
+
+		const float Yaw = FMath::RadiansToDegrees(FMath::Atan2(SeatDirection.Y, SeatDirection.X));
+		const float Pitch = FMath::RadiansToDegrees(FMath::Atan2(SeatDirection.Z, SeatDirection.Size2D()));
+		const float U = Yaw / YawScope + 0.5f;
+		const float V = Pitch / PitchScope + 0.5f;
+		if (U < 0.f || U > 1.f || V < 0.f || V > 1.f)
+			return false;
+
+		const int32 YawCell = FMath::Min(FMath::FloorToInt(U * FireArcYawCells), FireArcYawCells - 1);
+		const int32 PitchCell = FMath::Min(FMath::FloorToInt(V * FireArcPitchCells), FireArcPitchCells - 1);
+		OutCell = YawCell * FireArcPitchCells + PitchCell;
+		return true;
+	}
+
+	FVector GetFireArcDirection(float YawScope, float PitchScope, float YawCell, float PitchCell)
+	{
+		const float Yaw = (YawCell / FireArcYawCells - 0.5f) * YawScope;
+		const float Pitch = (PitchCell / FireArcPitchCells - 0.5f) * PitchScope;
+		return FRotator(Pitch, Yaw, 0.f).Vector();
+	}
+
+	/** Sections start at multiples of this, so the mesh ids can be read in place. */
+	const uint32 SectionAlignment = 8;
+
+	bool IsSectionInBounds(uint64 Offset, uint64 Size, int64 BlobSize)
+	{
+		return Offset % SectionAlignment == 0 && Offset + Size <= static_cast<uint64>(BlobSize);
+	}
+
+	/** Paths are cut off at the longest a seat's boarding entry can describe. */
+	uint8 GetNumPathPoints(const TArray<FVector>& Path)
+	{
+		return FMath::Min<int32>(Path.Num(), MAX_uint8);
+	}
+
+	/** Arcs of another resolution than the blob's are left out, the seat is then only limited by its scopes. */
+	bool HasFireArc(const FSeatBlobSeatDesc& Seat)
+	{
+		return Seat.FireArc.Num() == FireArcWords;
+	}
+
+	/** Occupant capsules of the seats of a mesh, seats whose posture has no shape are left out. */
+	TArray<FSeatBlobOccupantProxy> MakeOccupantProxies(const TArray<FSeatBlobSeatDesc>& Seats,
+	                                                  const TArray<FSeatBlobPostureShape>& PostureShapes)
+	{
+		TArray<FSeatBlobOccupantProxy> Proxies;
+		for (int32 SeatIndex = 0; SeatIndex < Seats.Num(); ++SeatIndex)
+		{
+			const FSeatBlobSeatDesc& Seat = Seats[SeatIndex];
+			if (!PostureShapes.IsValidIndex(Seat.Posture) || PostureShapes[Seat.Posture].Radius <= 0.f)
+				continue;
+
+			FVector Start;
+			FVector End;
+			const FSeatBlobPostureShape& Shape = PostureShapes[Seat.Posture];
+			Shape.GetCapsuleSegment(FTransform(Seat.Rotation, Seat.Location), Start, End);
+
+			FSeatBlobOccupantProxy& Proxy = Proxies.AddDefaulted_GetRef();
+			Proxy.Start[0] = Start.X;
+			Proxy.Start[1] = Start.Y;
+			Proxy.Start[2] = Start.Z;
+			Proxy.End[0] = End.X;
+			Proxy.End[1] = End.Y;
+			Proxy.End[2] = End.Z;
+			Proxy.Radius = Shape.Radius;
+			Proxy.SeatIndex = SeatIndex;
+		}
+		return Proxies;
+	}
+}
+
+bool FSeatBlobView::Initialize(const uint8* InData, int64 InSize)
+{
+	using namespace SeatBlob;
+
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_InitializeSeatBlob);
+
+	Header = nullptr;
+
+#if !PLATFORM_LITTLE_ENDIAN
+	// Seat blobs are read in place, converting them would defeat the point.
+	return false;
+#endif
+
+	if (!InData || InSize < static_cast<int64>(sizeof(FSeatBlobHeader)) || !IsAligned(InData, SectionAlignment))
+		return false;
+
+	const FSeatBlobHeader* InHeader = reinterpret_cast<const FSeatBlobHeader*>(InData);
+	if (InHeader->Magic != Magic || InHeader->Version != Version)
+		return false;
+
+	if (!IsSectionInBounds(InHeader->MeshesOffset, uint64(InHeader->NumMeshes) * sizeof(FSeatBlobMesh), InSize) ||
+		!IsSectionInBounds(InHeader->SeatsOffset, uint64(InHeader->NumSeats) * sizeof(FSeatBlobSeat), InSize) ||
+		!IsSectionInBounds(InHeader->BoardingOffset, uint64(InHeader->NumSeats) * sizeof(FSeatBlobBoarding), InSize) ||
+		!IsSectionInBounds(InHeader->PointsOffset, uint64(InHeader->NumPoints) * sizeof(FSeatBlobPoint), InSize) ||
+		!IsSectionInBounds(InHeader->FireArcsOffset, uint64(InHeader->NumFireArcs) * sizeof(FSeatBlobFireArc), InSize) ||
+		!IsSectionInBounds(InHeader->PostureShapesOffset,
+		                   uint64(InHeader->NumPostureShapes) * sizeof(FSeatBlobPostureShape), InSize) ||
+		!IsSectionInBounds(InHeader->OccupantTreesOffset,
+		                   uint64(InHeader->NumMeshes) * sizeof(FSeatBlobOccupantTree), InSize) ||
+		!IsSectionInBounds(InHeader->OccupantNodesOffset,
+		                   uint64(InHeader->NumOccupantNodes) * sizeof(FSeatBlobOccupantNode), InSize) ||
+		!IsSectionInBounds(InHeader->OccupantProxiesOffset,
+		                   uint64(InHeader->NumOccupantProxies) * sizeof(FSeatBlobOccupantProxy), InSize) ||
+		!IsSectionInBounds(InHeader->NamesOffset, InHeader->NamesSize, InSize))
+		return false;
+
+	const FSeatBlobMesh* InMeshes = reinterpret_cast<const FSeatBlobMesh*>(InData + InHeader->MeshesOffset);
+	const FSeatBlobOccupantTree* InOccupantTrees =
+		reinterpret_cast<const FSeatBlobOccupantTree*>(InData + InHeader->OccupantTreesOffset);
+	const ANSICHAR* InNames = reinterpret_cast<const ANSICHAR*>(InData + InHeader->NamesOffset);
+	if (InHeader->NamesSize > 0 && InNames[InHeader->NamesSize - 1] != '\0')
+		return false;
+
+	// Meshes are few next to seats, checking their ranges keeps every lookup in bounds.
+	for (uint32 MeshIndex = 0; MeshIndex < InHeader->NumMeshes; ++MeshIndex)
+	{
+		const FSeatBlobMesh& Mesh = InMeshes[MeshIndex];
+		if (uint64(Mesh.FirstSeat) + Mesh.NumSeats > InHeader->NumSeats)
+			return false;
+
+		if (MeshIndex > 0 && InMeshes[MeshIndex - 1].MeshId >= Mesh.MeshId)
+			return false;
+
+		// Node links and proxy ranges within a hierarchy are checked while it is walked.
+		const FSeatBlobOccupantTree& Tree = InOccupantTrees[MeshIndex];
+		if (uint64(Tree.FirstNode) + Tree.NumNodes > InHeader->NumOccupantNodes ||
+			uint64(Tree.FirstProxy) + Tree.NumProxies > InHeader->NumOccupantProxies)
+			return false;
+	}
+
+	Header = InHeader;
+	Meshes = InMeshes;
+	Seats = reinterpret_cast<const FSeatBlobSeat*>(InData + InHeader->SeatsOffset);
+	Boarding = reinterpret_cast<const FSeatBlobBoarding*>(InData + InHeader->BoardingOffset);
+	Points = reinterpret_cast<const FSeatBlobPoint*>(InData + InHeader->PointsOffset);
+	FireArcs = reinterpret_cast<const FSeatBlobFireArc*>(InData + InHeader->FireArcsOffset);
+	PostureShapes = reinterpret_cast<const FSeatBlobPostureShape*>(InData + InHeader->PostureShapesOffset);
+	OccupantTrees = InOccupantTrees;
+	OccupantNodes = reinterpret_cast<const FSeatBlobOccupantNode*>(InData + InHeader->OccupantNodesOffset);
+	OccupantProxies = reinterpret_cast<const FSeatBlobOccupantProxy*>(InData + InHeader->OccupantProxiesOffset);
+	Names = InNames;
+	return true;
+}
+
+int32 FSeatBlobView::FindMeshIndex(uint64 MeshId) const
+{
+	const TArrayView<const FSeatBlobMesh> AllMeshes = GetMeshes();
+	const int32 MeshIndex = Algo::LowerBoundBy(AllMeshes, MeshId, &FSeatBlobMesh::MeshId);
+	if (!AllMeshes.IsValidIndex(MeshIndex) || AllMeshes[MeshIndex].MeshId != MeshId)
+		return INDEX_NONE;
+
+	return MeshIndex;
+}
+
+TArrayView<const FSeatBlobSeat> FSeatBlobView::FindSeats(uint64 MeshId) const
+{
+	const int32 MeshIndex = FindMeshIndex(MeshId);
+	if (MeshIndex == INDEX_NONE)
+		return TArrayView<const FSeatBlobSeat>();
+
+	return GetSeats().Slice(Meshes[MeshIndex].FirstSeat, Meshes[MeshIndex].NumSeats);
+}
+
+TArrayView<const FSeatBlobSeat> FSeatBlobView::FindSeats(const FSoftObjectPath& MeshPath) const
+{
+	return FindSeats(SeatBlob::MakeMeshId(MeshPath));
+}
+
+TArrayView<const FSeatBlobMesh> FSeatBlobView::GetMeshes() const
+{
+	return Header ? MakeArrayView(Meshes, Header->NumMeshes) : TArrayView<const FSeatBlobMesh>();
+}
+
+TArrayView<const FSeatBlobSeat> FSeatBlobView::GetSeats() const
+{
+	return Header ? MakeArrayView(Seats, Header->NumSeats) : TArrayView<const FSeatBlobSeat>();
+}
+
+const ANSICHAR* FSeatBlobView::GetSeatName(const FSeatBlobSeat& Seat) const
+{
+	return Header && Seat.NameOffset < Header->NamesSize ? Names + Seat.NameOffset : "";
+}
+
+FSeatBlobBoardingPaths FSeatBlobView::GetBoardingPaths(const FSeatBlobSeat& Seat) const
+{
+	FSeatBlobBoardingPaths Paths;
+	const int64 SeatIndex = &Seat - Seats;
+	if (!Header || SeatIndex < 0 || SeatIndex >= Header->NumSeats)
+		return Paths;
+
+	// Checked here rather than when the blob is opened, which then stays independent of the number of seats.
+	const FSeatBlobBoarding& SeatBoarding = Boarding[SeatIndex];
+	if (uint64(SeatBoarding.FirstPoint) + SeatBoarding.NumEntryPoints + SeatBoarding.NumExitPoints > Header->NumPoints)
+		return Paths;
+
+	Paths.EntryPath = MakeArrayView(Points + SeatBoarding.FirstPoint, SeatBoarding.NumEntryPoints);
+	Paths.ExitPath = MakeArrayView(Points + SeatBoarding.FirstPoint + SeatBoarding.NumEntryPoints,
+	                               SeatBoarding.NumExitPoints);
+	return Paths;
+}
+
+const FSeatBlobFireArc* FSeatBlobView::GetFireArc(const FSeatBlobSeat& Seat) const
+{
+	return Header && Seat.FireArc < Header->NumFireArcs ? FireArcs + Seat.FireArc : nullptr;
+}
+
+bool FSeatBlobView::CanFireAt(const FSeatBlobSeat& Seat, const FVector& Target) const
+{
+	const FSeatBlobFireArc* FireArc = GetFireArc(Seat);
+	const FVector Origin = FireArc ? FireArc->GetOrigin() : Seat.GetLocation();
+	const FVector SeatDirection = Seat.GetRotation().UnrotateVector(Target - Origin);
+
+	int32 Cell;
+	if (!SeatBlob::GetFireArcCell(Seat.YawScope, Seat.PitchScope, SeatDirection, Cell))
+		return false;
+
+	return !FireArc || FireArc->IsCellVisible(Cell);
+}
+
+const FSeatBlobPostureShape* FSeatBlobView::GetPostureShape(const FSeatBlobSeat& Seat) const
+{
+	if (!Header || Seat.Posture >= Header->NumPostureShapes || PostureShapes[Seat.Posture].Radius <= 0.f)
+		return nullptr;
+
+	return PostureShapes + Seat.Posture;
+}
+
+const FSeatBlobOccupantTree* FSeatBlobView::FindOccupantTree(uint64 MeshId) const
+{
+	const int32 MeshIndex = FindMeshIndex(MeshId);
+	return MeshIndex != INDEX_NONE ? OccupantTrees + MeshIndex : nullptr;
+}
+
+TArrayView<const FSeatBlobOccupantNode> FSeatBlobView::GetOccupantNodes(const FSeatBlobOccupantTree& Tree) const
+{
+	return MakeArrayView(OccupantNodes + Tree.FirstNode, Tree.NumNodes);
+}
+
+TArrayView<const FSeatBlobOccupantProxy> FSeatBlobView::GetOccupantProxies(const FSeatBlobOccupantTree& Tree) const
+{
+	return MakeArrayView(OccupantProxies + Tree.FirstProxy, Tree.NumProxies);
+}
+
+bool FSeatBlobWriter::AddMesh(const FSoftObjectPath& MeshPath, TArray<FSeatBlobSeatDesc> InSeats)
+{
+	const uint64 MeshId = SeatBlob::MakeMeshId(MeshPath);
+	if (Meshes.Contains(MeshId))
+	{
+		UE_LOG(LogCustomSocketRuntime, Warning, TEXT("%s was added to the seat blob before or its id is taken."),
+		       *MeshPath.ToString());
+		return false;
+	}
+
+	if (InSeats.Num() > 0)
+	{
+		Meshes.Add(MeshId, MoveTemp(InSeats));
+	}
+	return true;
+}
+
+void FSeatBlobWriter::SetPostureShape(uint8 Posture, float Radius, float HalfHeight, bool bLying)
+{
+	if (!PostureShapes.IsValidIndex(Posture))
+	{
+		PostureShapes.AddZeroed(Posture + 1 - PostureShapes.Num());
+	}
+
+	FSeatBlobPostureShape& Shape = PostureShapes[Posture];
+	Shape.Radius = Radius;
+	Shape.HalfHeight = HalfHeight;
+	Shape.bLying = bLying ? 1 : 0;
+}
+
+void FSeatBlobWriter::Write(TArray<uint8>& OutBlob) const
+{
+	using namespace SeatBlob;
+
+	TArray<uint64> MeshIds;
+	Meshes.GenerateKeyArray(MeshIds);
+	MeshIds.Sort();
+
+	TArray<uint8> NameBytes;
+	TMap<FName, uint32> NameOffsets;
+	uint32 NumSeats = 0;
+	uint32 NumPoints = 0;
+	uint32 NumFireArcs = 0;
+	for (const uint64 MeshId : MeshIds)
+	{
+		for (const FSeatBlobSeatDesc& Seat : Meshes[MeshId])
+		{
+			NumPoints += GetNumPathPoints(Seat.EntryPath) + GetNumPathPoints(Seat.ExitPath);
+			NumFireArcs += HasFireArc(Seat) ? 1 : 0;
+
+			if (!NameOffsets.Contains(Seat.Name))
+			{
+				NameOffsets.Add(Seat.Name, NameBytes.Num());
+				const FTCHARToUTF8 Name(*Seat.Name.ToString());
+				NameBytes.Append(reinterpret_cast<const uint8*>(Name.Get()), Name.Length());
+				NameBytes.Add(0);
+			}
+		}
+		NumSeats += Meshes[MeshId].Num();
+	}
+
+	// Built once here, loading the blob only points at the hierarchies.
+	TArray<FSeatBlobOccupantTree> OccupantTrees;
+	TArray<FSeatBlobOccupantNode> OccupantNodes;
+	TArray<FSeatBlobOccupantProxy> OccupantProxies;
+	for (const uint64 MeshId : MeshIds)
+	{
+		TArray<FSeatBlobOccupantProxy> MeshProxies = MakeOccupantProxies(Meshes[MeshId], PostureShapes);
+		TArray<FSeatBlobOccupantNode> MeshNodes;
+		FSeatOccupantBVH::Build(MeshProxies, MeshNodes);
+
+		FSeatBlobOccupantTree& Tree = OccupantTrees.AddDefaulted_GetRef();
+		Tree.FirstNode = OccupantNodes.Num();
+		Tree.NumNodes = MeshNodes.Num();
+		Tree.FirstProxy = OccupantProxies.Num();
+		Tree.NumProxies = MeshProxies.Num();
+		OccupantNodes.Append(MeshNodes);
+		OccupantProxies.Append(MeshProxies);
+	}
+
+	FSeatBlobHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumMeshes = MeshIds.Num();
+	Header.NumSeats = NumSeats;
+	Header.MeshesOffset = sizeof(FSeatBlobHeader);
+	Header.SeatsOffset = Align(Header.MeshesOffset + Header.NumMeshes * sizeof(FSeatBlobMesh), SectionAlignment);
+	Header.BoardingOffset = Align(Header.SeatsOffset + Header.NumSeats * sizeof(FSeatBlobSeat), SectionAlignment);
+	Header.NumPoints = NumPoints;
+	Header.PointsOffset = Align(Header.BoardingOffset + Header.NumSeats * sizeof(FSeatBlobBoarding), SectionAlignment);
+	Header.NumFireArcs = NumFireArcs;
+	Header.FireArcsOffset = Align(Header.PointsOffset + Header.NumPoints * sizeof(FSeatBlobPoint), SectionAlignment);
+	Header.NumPostureShapes = PostureShapes.Num();
+	Header.PostureShapesOffset = Align(Header.FireArcsOffset + Header.NumFireArcs * sizeof(FSeatBlobFireArc),
+	                                   SectionAlignment);
+	Header.OccupantTreesOffset = Align(Header.PostureShapesOffset +
+	                                   Header.NumPostureShapes * sizeof(FSeatBlobPostureShape), SectionAlignment);
+	Header.NumOccupantNodes = OccupantNodes.Num();
+	Header.OccupantNodesOffset = Align(Header.OccupantTreesOffset + Header.NumMeshes * sizeof(FSeatBlobOccupantTree),
+	                                   SectionAlignment);
+	Header.NumOccupantProxies = OccupantProxies.Num();
+	Header.OccupantProxiesOffset = Align(Header.OccupantNodesOffset +
+	                                     Header.NumOccupantNodes * sizeof(FSeatBlobOccupantNode), SectionAlignment);
+	Header.NamesOffset = Align(Header.OccupantProxiesOffset +
+	                           Header.NumOccupantProxies * sizeof(FSeatBlobOccupantProxy), SectionAlignment);
+	Header.NamesSize = NameBytes.Num();
+
+	OutBlob.Reset(Header.NamesOffset + Header.NamesSize);
+	FMemoryWriter Ar(OutBlob);
+	Ar.SetByteSwapping(!PLATFORM_LITTLE_ENDIAN);
+
+	auto PadTo = [&Ar](uint32 Offset)
+	{
+		uint8 Zero = 0;
+		while (Ar.Tell() < Offset)
+		{
+			Ar << Zero;
+		}
+	};
+
+	Ar << Header.Magic << Header.Version << Header.NumMeshes << Header.NumSeats;
+	Ar << Header.MeshesOffset << Header.SeatsOffset << Header.NamesOffset << Header.NamesSize;
+	Ar << Header.BoardingOffset << Header.NumPoints << Header.PointsOffset << Header.NumFireArcs;
+	Ar << Header.FireArcsOffset << Header.NumPostureShapes << Header.PostureShapesOffset << Header.OccupantTreesOffset;
+	Ar << Header.NumOccupantNodes << Header.OccupantNodesOffset << Header.NumOccupantProxies;
+	Ar << Header.OccupantProxiesOffset;
+
+	uint32 FirstSeat = 0;
+	for (uint64 MeshId : MeshIds)
+	{
+		uint32 MeshSeats = Meshes[MeshId].Num();
+		Ar << MeshId << FirstSeat << MeshSeats;
+		FirstSeat += MeshSeats;
+	}
+
+	PadTo(Header.SeatsOffset);
+	uint32 NextFireArc = 0;
+	for (const uint64 MeshId : MeshIds)
+	{
+		for (const FSeatBlobSeatDesc& Seat : Meshes[MeshId])
+		{
+			float Location[3] = {Seat.Location.X, Seat.Location.Y, Seat.Location.Z};
+			float Rotation[3] = {Seat.Rotation.Pitch, Seat.Rotation.Yaw, Seat.Rotation.Roll};
+			float YawScope = Seat.YawScope;
+			float PitchScope = Seat.PitchScope;
+			uint32 NameOffset = NameOffsets[Seat.Name];
+			uint8 SeatType = Seat.SeatType;
+			uint8 Posture = Seat.Posture;
+			uint8 Padding = 0;
+			uint32 FireArc = HasFireArc(Seat) ? NextFireArc++ : NoFireArc;
+
+			Ar << Location[0] << Location[1] << Location[2];
+			Ar << Rotation[0] << Rotation[1] << Rotation[2];
+			Ar << YawScope << PitchScope << NameOffset;
+			Ar << SeatType << Posture << Padding << Padding;
+			Ar << FireArc;
+		}
+	}
+
+	PadTo(Header.BoardingOffset);
+	uint32 FirstPoint = 0;
+	for (const uint64 MeshId : MeshIds)
+	{
+		for (const FSeatBlobSeatDesc& Seat : Meshes[MeshId])
+		{
+			uint8 NumEntryPoints = GetNumPathPoints(Seat.EntryPath);
+			uint8 NumExitPoints = GetNumPathPoints(Seat.ExitPath);
+			uint8 Padding = 0;
+			Ar << FirstPoint << NumEntryPoints << NumExitPoints << Padding << Padding;
+			FirstPoint += NumEntryPoints + NumExitPoints;
+		}
+	}
+
+	PadTo(Header.PointsOffset);
+	auto WritePoints = [&Ar](const TArray<FVector>& Path)
+	{
+		for (int32 PointIndex = 0; PointIndex < GetNumPathPoints(Path); ++PointIndex)
+		{
+			float X = Path[PointIndex].X;
+			float Y = Path[PointIndex].Y;
+			float Z = Path[PointIndex].Z;
+			Ar << X << Y << Z;
+		}
+	};
+	for (const uint64 MeshId : MeshIds)
+	{
+		for (const FSeatBlobSeatDesc& Seat : Meshes[MeshId])
+		{
+			WritePoints(Seat.EntryPath);
+			WritePoints(Seat.ExitPath);
+		}
+	}
+
+	PadTo(Header.FireArcsOffset);
+	for (const uint64 MeshId : MeshIds)
+	{
+		for (const FSeatBlobSeatDesc& Seat : Meshes[MeshId])
+		{
+			if (!HasFireArc(Seat))
+				continue;
+
+			float Origin[3] = {Seat.FireArcOrigin.X, Seat.FireArcOrigin.Y, Seat.FireArcOrigin.Z};
+			Ar << Origin[0] << Origin[1] << Origin[2];
+			for (uint32 Word : Seat.FireArc)
+			{
+				Ar << Word;
+			}
+		}
+	}
+
+	PadTo(Header.PostureShapesOffset);
+	for (FSeatBlobPostureShape Shape : PostureShapes)
+	{
+		Ar << Shape.Radius << Shape.HalfHeight << Shape.bLying;
+		Ar << Shape.Padding[0] << Shape.Padding[1] << Shape.Padding[2];
+	}
+
+	PadTo(Header.OccupantTreesOffset);
+	for (FSeatBlobOccupantTree Tree : OccupantTrees)
+	{
+		Ar << Tree.FirstNode << Tree.NumNodes << Tree.FirstProxy << Tree.NumProxies;
+	}
+
+	PadTo(Header.OccupantNodesOffset);
+	for (FSeatBlobOccupantNode Node : OccupantNodes)
+	{
+		Ar << Node.Min[0] << Node.Min[1] << Node.Min[2];
+		Ar << Node.Max[0] << Node.Max[1] << Node.Max[2];
+		Ar << Node.RightChild << Node.FirstProxy << Node.NumProxies;
+	}
+
+	PadTo(Header.OccupantProxiesOffset);
+	for (FSeatBlobOccupantProxy Proxy : OccupantProxies)
+	{
+		Ar << Proxy.Start[0] << Proxy.Start[1] << Proxy.Start[2];
+		Ar << Proxy.End[0] << Proxy.End[1] << Proxy.End[2];
+		Ar << Proxy.Radius << Proxy.SeatIndex;
+	}
+
+	PadTo(Header.NamesOffset);
+	Ar.Serialize(NameBytes.GetData(), NameBytes.Num());
+}
+
+TUniquePtr<FMappedSeatBlob> FMappedSeatBlob::Open(const TCHAR* Filename)
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_OpenMappedSeatBlob);
+
+	TUniquePtr<FMappedSeatBlob> Blob(new FMappedSeatBlob());
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	Blob->MappedHandle.Reset(PlatformFile.OpenMapped(Filename));
+	if (Blob->MappedHandle)
+	{
+		Blob->MappedRegion.Reset(Blob->MappedHandle->MapRegion());
+	}
+
+	const uint8* Data;
+	int64 Size;
+	if (Blob->MappedRegion)
+	{
+		Data = Blob->MappedRegion->GetMappedPtr();
+		Size = Blob->MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Files inside pak files cannot be mapped on every platform.
+		if (!FFileHelper::LoadFileToArray(Blob->LoadedData, Filename, FILEREAD_Silent))
+			return nullptr;
+
+		Data = Blob->LoadedData.GetData();
+		Size = Blob->LoadedData.Num();
+	}
+
+	if (!Blob->View.Initialize(Data, Size))
+	{
+		UE_LOG(LogCustomSocketRuntime, Warning, TEXT("%s is no seat blob of version %u."), Filename,
+		       SeatBlob::Version);
+		return nullptr;
+	}
+
+	return Blob;
+}
+
+FMappedSeatBlob::~FMappedSeatBlob()
+{
+	// The region has to be unmapped before its file is closed.
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
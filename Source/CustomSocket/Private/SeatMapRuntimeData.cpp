@@ -0,0 +1,94 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMapRuntimeData.h"
+
+#include "CustomSocket.h"
+#include "CustomSocketRuntimeStats.h"
+
+bool USeatMapRuntimeData::SetBlob(TArray<uint8>&& InBlob)
+{
+	FSeatBlobView NewView;
+	if (!NewView.Initialize(InBlob.GetData(), InBlob.Num()))
+		return false;
+
+	const uint8* CurrentBlob = static_cast<const uint8*>(BlobData.LockReadOnly());
+	const bool bUnchanged = InBlob.Num() == BlobData.GetBulkDataSize() &&
+		FMemory::Memcmp(InBlob.GetData(), CurrentBlob, InBlob.Num()) == 0;
+	BlobData.Unlock();
+	if (bUnchanged)
+		return false;
+
+	BlobData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(BlobData.Realloc(InBlob.Num()), InBlob.GetData(), InBlob.Num());
+	BlobData.Unlock();
+
+	InitializeView();
+	return true;
+}
+
+FSeatOccupantBVH USeatMapRuntimeData::FindOccupantBVH(const FSoftObjectPath& MeshPath) const
+{
+	const FSeatBlobOccupantTree* Tree = View.FindOccupantTree(SeatBlob::MakeMeshId(MeshPath));
+	if (!Tree)
+		return FSeatOccupantBVH();
+
+	return FSeatOccupantBVH(View.GetOccupantNodes(*Tree), View.GetOccupantProxies(*Tree));
+}
+
+FString USeatMapRuntimeData::GetGeneratedFolder(const FString& SeatMapPackageName)
+{
+	FString Root;
+	SeatMapPackageName.RightChop(1).Split(TEXT("/"), &Root, nullptr);
+	return FString::Printf(TEXT("/%s/_Generated/SeatMaps"), *Root);
+}
+
+FString USeatMapRuntimeData::GetRuntimeDataPackageName(const FString& SeatMapPackageName)
+{
+	FString Path;
+	SeatMapPackageName.RightChop(1).Split(TEXT("/"), nullptr, &Path);
+	return FString::Printf(TEXT("%s/%s_Runtime"), *GetGeneratedFolder(SeatMapPackageName), *Path);
+}
+
+void USeatMapRuntimeData::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// Only the cooked payload is mapped, the editor's copy stays inline with the package.
+	if (Ar.IsCooking())
+	{
+		BlobData.SetBulkDataFlags(BULKDATA_MemoryMappedPayload);
+	}
+	else
+	{
+		BlobData.ClearBulkDataFlags(BULKDATA_MemoryMappedPayload);
+	}
+	BlobData.Serialize(Ar, this);
+}
+
+void USeatMapRuntimeData::PostLoad()
+{
+	Super::PostLoad();
+
+	InitializeView();
+}
+
+void USeatMapRuntimeData::InitializeView()
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_InitializeSeatMapView);
+
+	View = FSeatBlobView();
+	if (BlobData.GetBulkDataSize() == 0)
+		return;
+
+	// The payload stays resident after the lock, mapped or loaded, so the view keeps pointing into it.
+	const uint8* Data = static_cast<const uint8*>(BlobData.LockReadOnly());
+	const bool bValid = View.Initialize(Data, BlobData.GetBulkDataSize());
+	BlobData.Unlock();
+
+	if (!bValid)
+	{
+		UE_LOG(LogCustomSocketRuntime, Warning, TEXT("%s holds no seat blob of version %u, recook its seat map."),
+		       *GetPathName(), SeatBlob::Version);
+	}
+}
@@ -0,0 +1,270 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatOccupantBVH.h"
+
+#include "CustomSocketRuntimeStats.h"
+
+namespace SeatOccupantBVH
+{
+	/** Nodes with at most this many proxies are not split further. */
+	const int32 MaxLeafProxies = 4;
+
+	FBox GetProxyBounds(const FSeatBlobOccupantProxy& Proxy)
+	{
+		FBox Bounds(ForceInit);
+		Bounds += Proxy.GetStart();
+		Bounds += Proxy.GetEnd();
+		return Bounds.ExpandBy(Proxy.Radius);
+	}
+
+	FVector GetProxyCenter(const FSeatBlobOccupantProxy& Proxy)
+	{
+		return (Proxy.GetStart() + Proxy.GetEnd()) * 0.5f;
+	}
+
+	int32 BuildNode(TArray<FSeatBlobOccupantProxy>& Proxies, TArray<FSeatBlobOccupantNode>& Nodes, int32 FirstProxy,
+	                int32 NumProxies)
+	{
+		const int32 NodeIndex = Nodes.AddZeroed();
+		FBox Bounds(ForceInit);
+		FBox CenterBounds(ForceInit);
+		for (int32 ProxyIndex = FirstProxy; ProxyIndex < FirstProxy + NumProxies; ++ProxyIndex)
+		{
+			Bounds += GetProxyBounds(Proxies[ProxyIndex]);
+			CenterBounds += GetProxyCenter(Proxies[ProxyIndex]);
+		}
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Nodes[NodeIndex].Min[Axis] = Bounds.Min[Axis];
+			Nodes[NodeIndex].Max[Axis] = Bounds.Max[Axis];
+		}
+
+		if (NumProxies <= MaxLeafProxies)
+		{
+			Nodes[NodeIndex].RightChild = INDEX_NONE;
+			Nodes[NodeIndex].FirstProxy = FirstProxy;
+			Nodes[NodeIndex].NumProxies = NumProxies;
+			return NodeIndex;
+		}
+
+		// Median split along the axis the proxy centers spread most on.
+		const FVector Extent = CenterBounds.GetExtent();
+		const int32 SplitAxis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : Extent.Y >= Extent.Z ? 1 : 2;
+		TArrayView<FSeatBlobOccupantProxy> Range = MakeArrayView(Proxies.GetData() + FirstProxy, NumProxies);
+		Range.Sort([SplitAxis](const FSeatBlobOccupantProxy& A, const FSeatBlobOccupantProxy& B)
+		{
+			return GetProxyCenter(A)[SplitAxis] < GetProxyCenter(B)[SplitAxis];
+		});
+
+		const int32 NumLeft = NumProxies / 2;
+		BuildNode(Proxies, Nodes, FirstProxy, NumLeft);
+		const int32 RightChild = BuildNode(Proxies, Nodes, FirstProxy + NumLeft, NumProxies - NumLeft);
+
+		Nodes[NodeIndex].RightChild = RightChild;
+		Nodes[NodeIndex].FirstProxy = 0;
+		Nodes[NodeIndex].NumProxies = 0;
+		return NodeIndex;
+	}
+
+	/** Whether the segment passes through the box, the slab test. */
+	bool SegmentIntersectsBox(const FVector& Start, const FVector& Delta, const FBox& Box)
+	{
+		float EntryTime = 0.f;
+		float ExitTime = 1.f;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMath::IsNearlyZero(Delta[Axis]))
+			{
+				if (Start[Axis] < Box.Min[Axis] || Start[Axis] > Box.Max[Axis])
+					return false;
+
+				continue;
+			}
+
+			float AxisEntry = (Box.Min[Axis] - Start[Axis]) / Delta[Axis];
+			float AxisExit = (Box.Max[Axis] - Start[Axis]) / Delta[Axis];
+			if (AxisEntry > AxisExit)
+			{
+				Swap(AxisEntry, AxisExit);
+			}
+
+			EntryTime = FMath::Max(EntryTime, AxisEntry);
+			ExitTime = FMath::Min(ExitTime, AxisExit);
+			if (EntryTime > ExitTime)
+				return false;
+		}
+		return true;
+	}
+
+	/** Earliest time in [0, 1] the segment Start + Delta * Time enters the sphere. */
+	bool SegmentSphereTime(const FVector& Start, const FVector& Delta, const FVector& Center, float Radius,
+	                       float& OutTime)
+	{
+		const FVector ToStart = Start - Center;
+		const float A = Delta.SizeSquared();
+		const float B = FVector::DotProduct(Delta, ToStart);
+		const float C = ToStart.SizeSquared() - Radius * Radius;
+		const float Discriminant = B * B - A * C;
+		if (A <= SMALL_NUMBER || Discriminant < 0.f)
+			return false;
+
+		OutTime = (-B - FMath::Sqrt(Discriminant)) / A;
+		return OutTime >= 0.f && OutTime <= 1.f;
+	}
+
+	/** Earliest time in [0, 1] the segment Start + Delta * Time enters the capsule, 0 if it starts inside. */
+	bool SegmentCapsuleTime(const FVector& Start, const FVector& Delta, const FSeatBlobOccupantProxy& Proxy,
+	                        float& OutTime)
+	{
+		const FVector ProxyStart = Proxy.GetStart();
+		const FVector ProxyEnd = Proxy.GetEnd();
+		const FVector Axis = ProxyEnd - ProxyStart;
+		if (FMath::PointDistToSegmentSquared(Start, ProxyStart, ProxyEnd) <= Proxy.Radius * Proxy.Radius)
+		{
+			OutTime = 0.f;
+			return true;
+		}
+
+		// Side of the capsule, an infinite cylinder cut to the axis.
+		const FVector ToStart = Start - ProxyStart;
+		const float AxisSquared = Axis.SizeSquared();
+		const float AxisDelta = FVector::DotProduct(Axis, Delta);
+		const float AxisToStart = FVector::DotProduct(Axis, ToStart);
+		const float A = AxisSquared * Delta.SizeSquared() - AxisDelta * AxisDelta;
+		const float B = AxisSquared * FVector::DotProduct(Delta, ToStart) - AxisToStart * AxisDelta;
+		const float C = AxisSquared * ToStart.SizeSquared() - AxisToStart * AxisToStart -
+			Proxy.Radius * Proxy.Radius * AxisSquared;
+		const float Discriminant = B * B - A * C;
+		if (A > SMALL_NUMBER && Discriminant >= 0.f)
+		{
+			const float Time = (-B - FMath::Sqrt(Discriminant)) / A;
+			const float AlongAxis = AxisToStart + Time * AxisDelta;
+			if (AlongAxis > 0.f && AlongAxis < AxisSquared)
+			{
+				OutTime = Time;
+				return Time >= 0.f && Time <= 1.f;
+			}
+		}
+
+		// Otherwise the segment enters through one of the end spheres.
+		float StartTime;
+		float EndTime;
+		const bool bHitsStart = SegmentSphereTime(Start, Delta, ProxyStart, Proxy.Radius, StartTime);
+		const bool bHitsEnd = SegmentSphereTime(Start, Delta, ProxyEnd, Proxy.Radius, EndTime);
+		if (!bHitsStart && !bHitsEnd)
+			return false;
+
+		OutTime = bHitsStart && bHitsEnd ? FMath::Min(StartTime, EndTime) : bHitsStart ? StartTime : EndTime;
+		return true;
+	}
+}
+
+void FSeatOccupantBVH::Build(TArray<FSeatBlobOccupantProxy>& InOutProxies, TArray<FSeatBlobOccupantNode>& OutNodes)
+{
+	OutNodes.Reset();
+	if (InOutProxies.Num() == 0)
+		return;
+
+	// A binary tree with full leaves has fewer than twice as many nodes as leaves.
+	OutNodes.Reserve(2 * FMath::DivideAndRoundUp(InOutProxies.Num(), SeatOccupantBVH::MaxLeafProxies));
+	SeatOccupantBVH::BuildNode(InOutProxies, OutNodes, 0, InOutProxies.Num());
+}
+
+bool FSeatOccupantBVH::IsNodeValid(int32 NodeIndex) const
+{
+	const FSeatBlobOccupantNode& Node = Nodes[NodeIndex];
+	if (Node.IsLeaf())
+		return uint64(Node.FirstProxy) + Node.NumProxies <= uint64(Proxies.Num());
+
+	// Children follow their parent, so walking a valid hierarchy always ends.
+	return Node.RightChild > NodeIndex + 1 && Node.RightChild < Nodes.Num();
+}
+
+int32 FSeatOccupantBVH::Raycast(const FVector& Start, const FVector& End, float& OutTime) const
+{
+	using namespace SeatOccupantBVH;
+
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_OccupantRaycast);
+
+	int32 HitSeatIndex = INDEX_NONE;
+	if (Nodes.Num() == 0)
+		return HitSeatIndex;
+
+	const FVector Delta = End - Start;
+	OutTime = 1.f;
+
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FSeatBlobOccupantNode& Node = Nodes[NodeIndex];
+
+		// Shortening the segment to the closest hit so far prunes everything behind it.
+		if (!IsNodeValid(NodeIndex) || !SegmentIntersectsBox(Start, Delta * OutTime, Node.GetBounds()))
+			continue;
+
+		if (!Node.IsLeaf())
+		{
+			Stack.Add(NodeIndex + 1);
+			Stack.Add(Node.RightChild);
+			continue;
+		}
+
+		for (uint32 ProxyIndex = Node.FirstProxy; ProxyIndex < Node.FirstProxy + Node.NumProxies; ++ProxyIndex)
+		{
+			float Time;
+			if (SegmentCapsuleTime(Start, Delta, Proxies[ProxyIndex], Time) && Time <= OutTime)
+			{
+				OutTime = Time;
+				HitSeatIndex = Proxies[ProxyIndex].SeatIndex;
+			}
+		}
+	}
+
+	return HitSeatIndex;
+}
+
+void FSeatOccupantBVH::OverlapCapsule(const FVector& Start, const FVector& End, float Radius,
+                                      TArray<int32>& OutSeatIndices) const
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_OccupantOverlap);
+
+	if (Nodes.Num() == 0)
+		return;
+
+	FBox QueryBounds(ForceInit);
+	QueryBounds += Start;
+	QueryBounds += End;
+	QueryBounds = QueryBounds.ExpandBy(Radius);
+
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FSeatBlobOccupantNode& Node = Nodes[NodeIndex];
+		if (!IsNodeValid(NodeIndex) || !Node.GetBounds().Intersect(QueryBounds))
+			continue;
+
+		if (!Node.IsLeaf())
+		{
+			Stack.Add(NodeIndex + 1);
+			Stack.Add(Node.RightChild);
+			continue;
+		}
+
+		for (uint32 ProxyIndex = Node.FirstProxy; ProxyIndex < Node.FirstProxy + Node.NumProxies; ++ProxyIndex)
+		{
+			const FSeatBlobOccupantProxy& Proxy = Proxies[ProxyIndex];
+			FVector OnQuery;
+			FVector OnProxy;
+			FMath::SegmentDistToSegmentSafe(Start, End, Proxy.GetStart(), Proxy.GetEnd(), OnQuery, OnProxy);
+			if (FVector::DistSquared(OnQuery, OnProxy) < FMath::Square(Radius + Proxy.Radius))
+			{
+				OutSeatIndices.Add(Proxy.SeatIndex);
+			}
+		}
+	}
+}
@@ -0,0 +1,355 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Seat data of every mesh in one flat little endian blob the runtime reads in place.
+ *
+ * Layout, every section starts 8 byte aligned:
+ *   FSeatBlobHeader
+ *   FSeatBlobMesh[NumMeshes]		sorted by MeshId, each one a range of the seats
+ *   FSeatBlobSeat[NumSeats]
+ *   FSeatBlobBoarding[NumSeats]	entry and exit path of the seat of the same index
+ *   FSeatBlobPoint[NumPoints]		path points of all seats
+ *   FSeatBlobFireArc[NumFireArcs]	firing arc visibility of fireable seats
+ *   FSeatBlobPostureShape[NumPostureShapes]	occupant capsule per posture value
+ *   FSeatBlobOccupantTree[NumMeshes]	occupant hierarchy of the mesh of the same index
+ *   FSeatBlobOccupantNode[NumOccupantNodes]	nodes of all occupant hierarchies
+ *   FSeatBlobOccupantProxy[NumOccupantProxies]	occupant capsules of all occupant hierarchies
+ *   Names							null terminated UTF-8 seat names
+ *
+ * Bump Version whenever the layout changes, readers reject blobs of another version.
+ */
+namespace SeatBlob
+{
+	const uint32 Magic = 0x4C425453; // "STBL"
+	const uint32 Version = 5;
+
+	/** Identifies a mesh by its object path, case insensitive like the path itself. */
+	CUSTOMSOCKET_API uint64 MakeMeshId(const FSoftObjectPath& MeshPath);
+
+	/** A firing arc spans the seat's yaw and pitch scope in this many cells, one visibility bit each. */
+	const int32 FireArcYawCells = 32;
+	const int32 FireArcPitchCells = 16;
+	const int32 FireArcWords = FireArcYawCells * FireArcPitchCells / 32;
+
+	/** FSeatBlobSeat::FireArc of seats without a baked arc. */
+	const uint32 NoFireArc = MAX_uint32;
+
+	/**
+	 * Cell of the firing arc a direction falls into, yaw major.
+	 *
+	 * @param SeatDirection		Direction relative to the seat, X forward and Z up.
+	 * @return					FALSE if the direction lies outside the scopes.
+	 */
+	CUSTOMSOCKET_API bool GetFireArcCell(float YawScope, float PitchScope, const FVector& SeatDirection, int32& OutCell);
+
+	/** Direction relative to the seat through a point of the firing arc given in fractional cells. */
+	CUSTOMSOCKET_API FVector GetFireArcDirection(float YawScope, float PitchScope, float YawCell, float PitchCell);
+}
+
+struct FSeatBlobHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 NumMeshes;
+	uint32 NumSeats;
+	uint32 MeshesOffset;
+	uint32 SeatsOffset;
+	uint32 NamesOffset;
+	uint32 NamesSize;
+	uint32 BoardingOffset;
+	uint32 NumPoints;
+	uint32 PointsOffset;
+	uint32 NumFireArcs;
+	uint32 FireArcsOffset;
+	uint32 NumPostureShapes;
+	uint32 PostureShapesOffset;
+	uint32 OccupantTreesOffset;
+	uint32 NumOccupantNodes;
+	uint32 OccupantNodesOffset;
+	uint32 NumOccupantProxies;
+	uint32 OccupantProxiesOffset;
+};
+
+struct FSeatBlobMesh
+{
+	uint64 MeshId;
+	uint32 FirstSeat;
+	uint32 NumSeats;
+};
+
+struct FSeatBlobSeat
+{
+	/** Relative to the mesh, template placement already applied. */
+	float Location[3];
+
+	/** Pitch, yaw and roll in degrees. */
+	float Rotation[3];
+
+	float YawScope;
+	float PitchScope;
+
+	/** Offset of the seat name into the names section. */
+	uint32 NameOffset;
+
+	/** ESeatType and EPosture values. */
+	uint8 SeatType;
+	uint8 Posture;
+	uint8 Padding[2];
+
+	/** Index into the fire arcs, SeatBlob::NoFireArc if none was baked. */
+	uint32 FireArc;
+
+	FVector GetLocation() const { return FVector(Location[0], Location[1], Location[2]); }
+	FRotator GetRotation() const { return FRotator(Rotation[0], Rotation[1], Rotation[2]); }
+	FTransform GetTransform() const { return FTransform(GetRotation(), GetLocation()); }
+};
+
+/** Mesh space position. */
+struct FSeatBlobPoint
+{
+	float Location[3];
+
+	FVector GetLocation() const { return FVector(Location[0], Location[1], Location[2]); }
+};
+
+/** A seat's entry path, anchor outside the mesh first, followed by its exit path, anchor last. */
+struct FSeatBlobBoarding
+{
+	uint32 FirstPoint;
+	uint8 NumEntryPoints;
+	uint8 NumExitPoints;
+	uint8 Padding[2];
+};
+
+/** Which directions of a fireable seat's scopes are not blocked by its own mesh. */
+struct FSeatBlobFireArc
+{
+	/** Mesh space point the arc was traced from, the occupant's eyes. */
+	float Origin[3];
+
+	/** One bit per cell, set where the way is clear. */
+	uint32 VisibleCells[SeatBlob::FireArcWords];
+
+	FVector GetOrigin() const { return FVector(Origin[0], Origin[1], Origin[2]); }
+	bool IsCellVisible(int32 Cell) const { return (VisibleCells[Cell >> 5] & (1u << (Cell & 31))) != 0; }
+};
+
+/** Capsule an occupant of a posture takes up, the collision proxy of seats of that posture. */
+struct FSeatBlobPostureShape
+{
+	float Radius;
+	float HalfHeight;
+
+	/** Lying postures extend the capsule along the seat forward axis instead of up. */
+	uint8 bLying;
+	uint8 Padding[3];
+
+	/** End points of the capsule's inner segment for a seat placed at SeatTransform. */
+	void GetCapsuleSegment(const FTransform& SeatTransform, FVector& OutStart, FVector& OutEnd) const
+	{
+		const float SegmentHalfLength = FMath::Max(HalfHeight - Radius, 0.f);
+		const FVector Center = bLying ? FVector(0.f, 0.f, Radius) : FVector(0.f, 0.f, HalfHeight);
+		const FVector Axis = bLying ? FVector::ForwardVector : FVector::UpVector;
+
+		OutStart = SeatTransform.TransformPosition(Center - Axis * SegmentHalfLength);
+		OutEnd = SeatTransform.TransformPosition(Center + Axis * SegmentHalfLength);
+	}
+};
+
+/** A mesh's occupant hierarchy, a range of the nodes and one of the proxies. */
+struct FSeatBlobOccupantTree
+{
+	uint32 FirstNode;
+	uint32 NumNodes;
+	uint32 FirstProxy;
+	uint32 NumProxies;
+};
+
+/** Node of an occupant hierarchy, the root comes first and inner nodes are followed by their left child. */
+struct FSeatBlobOccupantNode
+{
+	float Min[3];
+	float Max[3];
+
+	/** Indices within the node's hierarchy. Leaves cover NumProxies proxies from FirstProxy. */
+	int32 RightChild;
+	uint32 FirstProxy;
+	uint32 NumProxies;
+
+	FBox GetBounds() const { return FBox(FVector(Min[0], Min[1], Min[2]), FVector(Max[0], Max[1], Max[2])); }
+	bool IsLeaf() const { return NumProxies > 0; }
+};
+
+/** Occupant capsule of a seat, the segment between Start and End grown by Radius. */
+struct FSeatBlobOccupantProxy
+{
+	float Start[3];
+	float End[3];
+	float Radius;
+
+	/** Index into the seats of the proxy's mesh. */
+	uint32 SeatIndex;
+
+	FVector GetStart() const { return FVector(Start[0], Start[1], Start[2]); }
+	FVector GetEnd() const { return FVector(End[0], End[1], End[2]); }
+};
+
+static_assert(sizeof(FSeatBlobHeader) == 80, "FSeatBlobHeader is part of the seat blob format");
+static_assert(sizeof(FSeatBlobMesh) == 16, "FSeatBlobMesh is part of the seat blob format");
+static_assert(sizeof(FSeatBlobSeat) == 44, "FSeatBlobSeat is part of the seat blob format");
+static_assert(sizeof(FSeatBlobPoint) == 12, "FSeatBlobPoint is part of the seat blob format");
+static_assert(sizeof(FSeatBlobBoarding) == 8, "FSeatBlobBoarding is part of the seat blob format");
+static_assert(sizeof(FSeatBlobFireArc) == 76, "FSeatBlobFireArc is part of the seat blob format");
+static_assert(sizeof(FSeatBlobPostureShape) == 12, "FSeatBlobPostureShape is part of the seat blob format");
+static_assert(sizeof(FSeatBlobOccupantTree) == 16, "FSeatBlobOccupantTree is part of the seat blob format");
+static_assert(sizeof(FSeatBlobOccupantNode) == 36, "FSeatBlobOccupantNode is part of the seat blob format");
+static_assert(sizeof(FSeatBlobOccupantProxy) == 32, "FSeatBlobOccupantProxy is part of the seat blob format");
+
+/** Baked boarding paths of a seat, in mesh space. */
+struct FSeatBlobBoardingPaths
+{
+	TArrayView<const FSeatBlobPoint> EntryPath;
+	TArrayView<const FSeatBlobPoint> ExitPath;
+};
+
+/** Reads a seat blob where it lies in memory, nothing is copied or converted. */
+class CUSTOMSOCKET_API FSeatBlobView
+{
+public:
+	/**
+	 * Points the view at a blob, the memory has to outlive the view.
+	 *
+	 * @return		FALSE if the data is no seat blob of this version or its sections are out of bounds.
+	 */
+	bool Initialize(const uint8* InData, int64 InSize);
+
+	bool IsValid() const { return Header != nullptr; }
+
+	/** Seats of the mesh, empty if the blob has none for it. Binary search over the meshes. */
+	TArrayView<const FSeatBlobSeat> FindSeats(uint64 MeshId) const;
+	TArrayView<const FSeatBlobSeat> FindSeats(const FSoftObjectPath& MeshPath) const;
+
+	TArrayView<const FSeatBlobMesh> GetMeshes() const;
+	TArrayView<const FSeatBlobSeat> GetSeats() const;
+
+	/** UTF-8 name of the seat, empty if its offset lies outside the names. */
+	const ANSICHAR* GetSeatName(const FSeatBlobSeat& Seat) const;
+
+	/** Entry and exit path of a seat of this blob, both empty if none were baked. */
+	FSeatBlobBoardingPaths GetBoardingPaths(const FSeatBlobSeat& Seat) const;
+
+	/** Baked firing arc of a seat of this blob, null if it has none. */
+	const FSeatBlobFireArc* GetFireArc(const FSeatBlobSeat& Seat) const;
+
+	/**
+	 * Whether the seat can fire at a mesh space point, a lookup in its baked firing arc without any trace.
+	 * Seats without a baked arc are only limited by their scopes.
+	 */
+	bool CanFireAt(const FSeatBlobSeat& Seat, const FVector& Target) const;
+
+	/** Occupant capsule of the seat's posture, null if the blob has none for it. */
+	const FSeatBlobPostureShape* GetPostureShape(const FSeatBlobSeat& Seat) const;
+
+	/** Occupant hierarchy of the mesh, null if the blob has no seats for it. */
+	const FSeatBlobOccupantTree* FindOccupantTree(uint64 MeshId) const;
+
+	/** Nodes and proxies of an occupant hierarchy of this blob. */
+	TArrayView<const FSeatBlobOccupantNode> GetOccupantNodes(const FSeatBlobOccupantTree& Tree) const;
+	TArrayView<const FSeatBlobOccupantProxy> GetOccupantProxies(const FSeatBlobOccupantTree& Tree) const;
+
+private:
+	/** Index of the mesh in the meshes section, INDEX_NONE if the blob has no seats for it. */
+	int32 FindMeshIndex(uint64 MeshId) const;
+
+	const FSeatBlobHeader* Header = nullptr;
+	const FSeatBlobMesh* Meshes = nullptr;
+	const FSeatBlobSeat* Seats = nullptr;
+	const FSeatBlobBoarding* Boarding = nullptr;
+	const FSeatBlobPoint* Points = nullptr;
+	const FSeatBlobFireArc* FireArcs = nullptr;
+	const FSeatBlobPostureShape* PostureShapes = nullptr;
+	const FSeatBlobOccupantTree* OccupantTrees = nullptr;
+	const FSeatBlobOccupantNode* OccupantNodes = nullptr;
+	const FSeatBlobOccupantProxy* OccupantProxies = nullptr;
+	const ANSICHAR* Names = nullptr;
+};
+
+/** Input of FSeatBlobWriter, one seat as the editor sees it. */
+struct FSeatBlobSeatDesc
+{
+	FName Name;
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	uint8 SeatType = 0;
+	uint8 Posture = 0;
+	float YawScope = 0.f;
+	float PitchScope = 0.f;
+
+	/** Baked boarding paths, at most 255 points each. */
+	TArray<FVector> EntryPath;
+	TArray<FVector> ExitPath;
+
+	/** Baked firing arc, FireArcWords visibility words traced from FireArcOrigin. Empty if none was baked. */
+	FVector FireArcOrigin = FVector::ZeroVector;
+	TArray<uint32> FireArc;
+};
+
+/**
+ * Lays out seats per mesh as a seat blob, names shared between seats are stored once.
+ * The occupant hierarchies are built while writing, readers use them as stored.
+ */
+class CUSTOMSOCKET_API FSeatBlobWriter
+{
+public:
+	/**
+	 * Adds the seats of a mesh, meshes without seats are left out.
+	 *
+	 * @return		FALSE if the mesh was added before or its id collides with another mesh.
+	 */
+	bool AddMesh(const FSoftObjectPath& MeshPath, TArray<FSeatBlobSeatDesc> InSeats);
+
+	/** Sets the occupant capsule of a posture value, postures without one get no collision proxy. */
+	void SetPostureShape(uint8 Posture, float Radius, float HalfHeight, bool bLying);
+
+	/** Writes the blob little endian, whatever the endianness of the writing platform. */
+	void Write(TArray<uint8>& OutBlob) const;
+
+	int32 GetNumMeshes() const { return Meshes.Num(); }
+
+private:
+	TMap<uint64, TArray<FSeatBlobSeatDesc>> Meshes;
+
+	/** Indexed by posture value, a zero radius marks postures without a shape. */
+	TArray<FSeatBlobPostureShape> PostureShapes;
+};
+
+/** A seat blob file mapped into memory, read through its view for as long as this is alive. */
+class CUSTOMSOCKET_API FMappedSeatBlob
+{
+public:
+	/** Maps the file, or reads it where the platform cannot map it. Null if it is missing or no valid blob. */
+	static TUniquePtr<FMappedSeatBlob> Open(const TCHAR* Filename);
+
+	~FMappedSeatBlob();
+
+	const FSeatBlobView& GetView() const { return View; }
+
+private:
+	FMappedSeatBlob() = default;
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** The file contents when it could not be mapped. */
+	TArray<uint8> LoadedData;
+
+	FSeatBlobView View;
+};
@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SeatBlob.h"
+#include "SeatOccupantBVH.h"
+#include "Serialization/BulkData.h"
+#include "UObject/Object.h"
+#include "SeatMapRuntimeData.generated.h"
+
+/**
+ * Seats of a seat map as cooked builds carry them, one seat blob instead of one object per seat.
+ * The cook generates it for each seat map, which itself is never cooked, into a generated folder of the
+ * seat map's content root. That folder is build output and stays out of source control.
+ */
+UCLASS(BlueprintType)
+class CUSTOMSOCKET_API USeatMapRuntimeData : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Seats of the mesh, empty if the seat map has none for it. */
+	TArrayView<const FSeatBlobSeat> FindSeats(const FSoftObjectPath& MeshPath) const { return View.FindSeats(MeshPath); }
+
+	const FSeatBlobView& GetView() const { return View; }
+
+	/** Occupant capsules of the mesh's seats, empty if the seat map has none for it. Seat indices match FindSeats. */
+	FSeatOccupantBVH FindOccupantBVH(const FSoftObjectPath& MeshPath) const;
+
+	int64 GetBlobSize() const { return BlobData.GetBulkDataSize(); }
+
+	/**
+	 * Replaces the seats.
+	 *
+	 * @return		FALSE if the blob is no valid seat blob or equals the current one, the data is then unchanged.
+	 */
+	bool SetBlob(TArray<uint8>&& InBlob);
+
+	/** Folder the cook generates runtime data into, "/Game/_Generated/SeatMaps" for seat maps under /Game. */
+	static FString GetGeneratedFolder(const FString& SeatMapPackageName);
+
+	/** Package of the runtime data the cook generates for a seat map, its path mirrored in the generated folder. */
+	static FString GetRuntimeDataPackageName(const FString& SeatMapPackageName);
+
+	//~ Begin UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+	//~ End UObject Interface
+
+#if WITH_EDITORONLY_DATA
+	/** Seat map the data was generated from. */
+	UPROPERTY(VisibleAnywhere, Category = "SeatMap")
+	FSoftObjectPath SourceSeatMap;
+#endif
+
+private:
+	/** Points the view at the blob's payload, loading it if it is not resident yet. */
+	void InitializeView();
+
+	/**
+	 * Cooked as a memory mapped payload, platforms that can map it read the blob straight from the file.
+	 * Elsewhere it is loaded once. The view reads it in place either way.
+	 */
+	FByteBulkData BlobData;
+	FSeatBlobView View;
+};
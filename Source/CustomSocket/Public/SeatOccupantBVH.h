@@ -0,0 +1,56 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SeatBlob.h"
+
+/**
+ * Occupant capsules of a mesh's seats in a static bounding volume hierarchy, so ray and overlap
+ * queries against occupants take logarithmic time and need no physics body per occupant.
+ * Everything is in mesh space, callers bring their queries into it with the inverse vehicle transform.
+ * The seat blob writer builds the hierarchies, this reads them where the blob lies. Queries are safe from any thread.
+ */
+class CUSTOMSOCKET_API FSeatOccupantBVH
+{
+public:
+	/**
+	 * Builds the hierarchy of the proxies, as the seat blob stores it.
+	 *
+	 * @param InOutProxies	Reordered so that every node covers a contiguous range.
+	 * @param OutNodes		Root first, indices are relative to the proxies and nodes of this hierarchy.
+	 */
+	static void Build(TArray<FSeatBlobOccupantProxy>& InOutProxies, TArray<FSeatBlobOccupantNode>& OutNodes);
+
+	/** An empty hierarchy, every query misses. */
+	FSeatOccupantBVH() = default;
+
+	/** Reads a built hierarchy in place, the memory has to outlive this. */
+	FSeatOccupantBVH(TArrayView<const FSeatBlobOccupantNode> InNodes, TArrayView<const FSeatBlobOccupantProxy> InProxies)
+		: Nodes(InNodes)
+		, Proxies(InProxies)
+	{
+	}
+
+	/**
+	 * First occupant the segment hits.
+	 *
+	 * @param OutTime	Fraction of the segment up to the hit.
+	 * @return			Seat index of the occupant, INDEX_NONE if none is hit.
+	 */
+	int32 Raycast(const FVector& Start, const FVector& End, float& OutTime) const;
+
+	/** Adds the seat index of every occupant overlapping the capsule, a sphere if Start equals End. */
+	void OverlapCapsule(const FVector& Start, const FVector& End, float Radius, TArray<int32>& OutSeatIndices) const;
+
+	TArrayView<const FSeatBlobOccupantProxy> GetProxies() const { return Proxies; }
+
+	bool IsEmpty() const { return Nodes.Num() == 0; }
+
+private:
+	/** Whether the node's children and proxies lie within the hierarchy, so a damaged blob cannot be walked past. */
+	bool IsNodeValid(int32 NodeIndex) const;
+
+	TArrayView<const FSeatBlobOccupantNode> Nodes;
+	TArrayView<const FSeatBlobOccupantProxy> Proxies;
+};
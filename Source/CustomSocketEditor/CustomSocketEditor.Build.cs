@@ -43,7 +43,9 @@ public class CustomSocketEditor : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"Slate",
-				"SlateCore", "EditorStyle", "PropertyEditor", "DeveloperSettings", "ApplicationCore"
+				"SlateCore", "EditorStyle", "PropertyEditor", "DeveloperSettings", "ApplicationCore",
+				"MessageLog", "AssetRegistry", "ContentBrowser", "Json",
+				"CustomSocket", "DerivedDataCache", "SourceControl"
 				// ... add private dependencies that you statically link with here ...	
 			}
 		);
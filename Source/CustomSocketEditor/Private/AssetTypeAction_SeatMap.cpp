@@ -1,8 +1,22 @@
 ﻿#include "AssetTypeAction_SeatMap.h"
 
 #include "CustomSocketEditor.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "ScopedTransaction.h"
+#include "SeatBlob.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "ToolMenuSection.h"
+#include "Logging/MessageLog.h"
+#include "Merge/SeatMapMerge.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "Widgets/SCustomSocketEditorWidget.h"
 
+#define LOCTEXT_NAMESPACE "AssetTypeActions"
+
 uint32 FAssetTypeActions_SeatMap::GetCategories()
 {
 	return FCustomSocketEditorModule::BYCAssetCategoryBit;
@@ -18,3 +32,214 @@ void FAssetTypeActions_SeatMap::OpenAssetEditor(const TArray<UObject*>& InObject
 		SocketEditor->InitSocketEditor();
 	}
 }
+
+void FAssetTypeActions_SeatMap::GetActions(const TArray<UObject*>& InObjects, FToolMenuSection& Section)
+{
+	const TArray<TWeakObjectPtr<USeatMap>> SeatMaps = GetTypedWeakObjectPtrs<USeatMap>(InObjects);
+
+	Section.AddMenuEntry(
+		"SeatMap_DeduplicateSeats",
+		LOCTEXT("SeatMap_DeduplicateSeats", "Deduplicate Seats"),
+		LOCTEXT("SeatMap_DeduplicateSeatsTooltip", "Stores identical seat sets once and reports how much was saved."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateSP(this, &FAssetTypeActions_SeatMap::ExecuteDeduplicateSeats, SeatMaps)));
+
+	Section.AddMenuEntry(
+		"SeatMap_ExportSeatBlobs",
+		LOCTEXT("SeatMap_ExportSeatBlobs", "Export Seat Blob"),
+		LOCTEXT("SeatMap_ExportSeatBlobsTooltip", "Writes the seats as the binary blob the runtime maps into memory."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateSP(this, &FAssetTypeActions_SeatMap::ExecuteExportSeatBlobs, SeatMaps)));
+}
+
+void FAssetTypeActions_SeatMap::ExecuteDeduplicateSeats(TArray<TWeakObjectPtr<USeatMap>> SeatMaps)
+{
+	const FScopedTransaction Transaction(LOCTEXT("DeduplicateSeats", "Deduplicate Seats"));
+
+	FMessageLog SeatLog("CustomSocket");
+	SeatLog.NewPage(LOCTEXT("DeduplicationPage", "Seat deduplication"));
+
+	for (const TWeakObjectPtr<USeatMap>& SeatMap : SeatMaps)
+	{
+		if (!SeatMap.IsValid())
+			continue;
+
+		SeatMap->Modify();
+		SeatMap->PreEditChange(NULL);
+		const FSeatDeduplicationStats Stats = SeatMap->DeduplicateSeats();
+		SeatMap->PostEditChange();
+		if (Stats.NumSeatObjectsAfter != Stats.NumSeatObjectsBefore)
+		{
+			SeatMap->MarkPackageDirty();
+		}
+
+		FFormatNamedArguments Args;
+		Args.Add(TEXT("SeatMap"), FText::FromString(SeatMap->GetName()));
+		Args.Add(TEXT("NumMeshes"), Stats.NumMeshes);
+		Args.Add(TEXT("NumUniqueSeatSets"), Stats.NumUniqueSeatSets);
+		Args.Add(TEXT("NumBefore"), Stats.NumSeatObjectsBefore);
+		Args.Add(TEXT("NumAfter"), Stats.NumSeatObjectsAfter);
+		Args.Add(TEXT("Percent"), FText::AsPercent(Stats.NumSeatObjectsBefore > 0
+			                                          ? 1.f - float(Stats.NumSeatObjectsAfter) / Stats.NumSeatObjectsBefore
+			                                          : 0.f));
+		SeatLog.Info(FText::Format(
+			LOCTEXT("DeduplicationResult",
+			        "{SeatMap}: {NumMeshes} meshes share {NumUniqueSeatSets} distinct seat sets, seat objects {NumBefore} -> {NumAfter} ({Percent} saved)."),
+			Args));
+	}
+
+	SeatLog.Open();
+}
+
+void FAssetTypeActions_SeatMap::ExecuteExportSeatBlobs(TArray<TWeakObjectPtr<USeatMap>> SeatMaps)
+{
+	FMessageLog SeatLog("CustomSocket");
+	SeatLog.NewPage(LOCTEXT("ExportSeatBlobPage", "Seat blob export"));
+
+	for (const TWeakObjectPtr<USeatMap>& SeatMap : SeatMaps)
+	{
+		if (!SeatMap.IsValid())
+			continue;
+
+		TArray<uint8> Blob;
+		SeatMap->BuildSeatBlob(Blob);
+
+		const FString BlobPath = FPaths::ProjectSavedDir() / TEXT("SeatBlobs") / SeatMap->GetName() + TEXT(".seatblob");
+		if (!FFileHelper::SaveArrayToFile(Blob, *BlobPath))
+		{
+			SeatLog.Error(FText::Format(LOCTEXT("ExportSeatBlobFailed", "{0}: could not write {1}."),
+			                            FText::FromString(SeatMap->GetName()), FText::FromString(BlobPath)));
+			continue;
+		}
+
+		FSeatBlobView View;
+		View.Initialize(Blob.GetData(), Blob.Num());
+
+		FFormatNamedArguments Args;
+		Args.Add(TEXT("SeatMap"), FText::FromString(SeatMap->GetName()));
+		Args.Add(TEXT("NumMeshes"), View.GetMeshes().Num());
+		Args.Add(TEXT("NumSeats"), View.GetSeats().Num());
+		Args.Add(TEXT("Size"), FText::AsMemory(Blob.Num()));
+		Args.Add(TEXT("Path"), FText::FromString(FPaths::ConvertRelativePathToFull(BlobPath)));
+		SeatLog.Info(FText::Format(
+			LOCTEXT("ExportSeatBlobResult", "{SeatMap}: {NumSeats} seats of {NumMeshes} meshes, {Size} written to {Path}."),
+			Args));
+	}
+
+	SeatLog.Open();
+}
+
+void FAssetTypeActions_SeatMap::PerformAssetDiff(UObject* OldAsset, UObject* NewAsset,
+                                                 const FRevisionInfo& OldRevision,
+                                                 const FRevisionInfo& NewRevision) const
+{
+	const USeatMap* OldSeatMap = Cast<USeatMap>(OldAsset);
+	const USeatMap* NewSeatMap = Cast<USeatMap>(NewAsset);
+	if (!OldSeatMap || !NewSeatMap)
+		return;
+
+	TArray<FSeatMapDifference> Differences;
+	SeatMapMerge::Diff(FSeatMapSnapshot::Capture(OldSeatMap), FSeatMapSnapshot::Capture(NewSeatMap), Differences);
+
+	FMessageLog SeatLog("CustomSocket");
+	SeatLog.NewPage(FText::Format(LOCTEXT("DiffPage", "Seat map diff {0}"), FText::FromString(NewSeatMap->GetName())));
+	for (const FSeatMapDifference& Difference : Differences)
+	{
+		SeatLog.Info(Difference.ToText());
+	}
+	SeatLog.Info(FText::Format(LOCTEXT("DiffResult", "{0}: {1} differences."), FText::FromString(NewSeatMap->GetName()),
+	                           Differences.Num()));
+	SeatLog.Open();
+}
+
+void FAssetTypeActions_SeatMap::Merge(UObject* InObject)
+{
+	USeatMap* SeatMap = Cast<USeatMap>(InObject);
+	if (!SeatMap)
+		return;
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	const FString PackageFilename = SourceControlHelpers::PackageFilename(SeatMap->GetOutermost());
+
+	const TSharedRef<FUpdateStatus> UpdateStatus = ISourceControlOperation::Create<FUpdateStatus>();
+	UpdateStatus->SetUpdateHistory(true);
+	SourceControlProvider.Execute(UpdateStatus, PackageFilename);
+
+	const FSourceControlStatePtr State = SourceControlProvider.GetState(PackageFilename, EStateCacheUsage::Use);
+	if (!State.IsValid() || !State->IsConflicted())
+		return;
+
+	// The revision both sides started from, and the latest one the local changes conflict with.
+	USeatMap* BaseSeatMap = LoadRevision(State->GetBaseRevForMerge(), SeatMap->GetName());
+	USeatMap* RemoteSeatMap = LoadRevision(State->GetHistoryItem(0), SeatMap->GetName());
+	if (!BaseSeatMap || !RemoteSeatMap)
+	{
+		FMessageLog("CustomSocket").Error(FText::Format(
+			LOCTEXT("MergeRevisionsMissing", "{0}: could not load the revisions to merge."),
+			FText::FromString(SeatMap->GetName())));
+		return;
+	}
+
+	Merge(BaseSeatMap, RemoteSeatMap, SeatMap,
+	      FOnMergeResolved::CreateLambda([PackageFilename](UPackage* MergedPackage, EMergeResult::Type Result)
+	      {
+		      if (Result == EMergeResult::Completed)
+		      {
+			      ISourceControlModule::Get().GetProvider().Execute(ISourceControlOperation::Create<FResolve>(),
+			                                                        PackageFilename);
+		      }
+	      }));
+}
+
+void FAssetTypeActions_SeatMap::Merge(UObject* BaseAsset, UObject* RemoteAsset, UObject* LocalAsset,
+                                      const FOnMergeResolved& ResolutionCallback)
+{
+	const USeatMap* BaseSeatMap = Cast<USeatMap>(BaseAsset);
+	const USeatMap* RemoteSeatMap = Cast<USeatMap>(RemoteAsset);
+	USeatMap* LocalSeatMap = Cast<USeatMap>(LocalAsset);
+	if (!BaseSeatMap || !RemoteSeatMap || !LocalSeatMap)
+	{
+		ResolutionCallback.ExecuteIfBound(LocalAsset ? LocalAsset->GetOutermost() : nullptr, EMergeResult::Cancelled);
+		return;
+	}
+
+	TArray<FSeatMapDifference> Conflicts;
+	const FSeatMapSnapshot Merged = SeatMapMerge::Merge(FSeatMapSnapshot::Capture(BaseSeatMap),
+	                                                    FSeatMapSnapshot::Capture(LocalSeatMap),
+	                                                    FSeatMapSnapshot::Capture(RemoteSeatMap), Conflicts);
+
+	{
+		const FScopedTransaction Transaction(LOCTEXT("MergeSeatMap", "Merge Seat Map"));
+		LocalSeatMap->Modify();
+		LocalSeatMap->PreEditChange(NULL);
+		Merged.ApplyTo(LocalSeatMap);
+		LocalSeatMap->PostEditChange();
+		LocalSeatMap->MarkPackageDirty();
+	}
+
+	FMessageLog SeatLog("CustomSocket");
+	SeatLog.NewPage(FText::Format(LOCTEXT("MergePage", "Seat map merge {0}"), FText::FromString(LocalSeatMap->GetName())));
+	for (const FSeatMapDifference& Conflict : Conflicts)
+	{
+		SeatLog.Warning(FText::Format(LOCTEXT("MergeConflict", "Conflict, kept the local version: {0}"),
+		                              Conflict.ToText()));
+	}
+	SeatLog.Info(FText::Format(LOCTEXT("MergeResult", "{0}: merged with {1} conflicts, save the seat map to keep the result."),
+	                           FText::FromString(LocalSeatMap->GetName()), Conflicts.Num()));
+	SeatLog.Open();
+
+	ResolutionCallback.ExecuteIfBound(LocalSeatMap->GetOutermost(), EMergeResult::Completed);
+}
+
+USeatMap* FAssetTypeActions_SeatMap::LoadRevision(
+	const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, const FString& AssetName)
+{
+	FString TempFilename;
+	if (!Revision.IsValid() || !Revision->Get(TempFilename))
+		return nullptr;
+
+	UPackage* Package = LoadPackage(nullptr, *TempFilename, LOAD_ForDiff | LOAD_DisableCompileOnLoad);
+	return Package ? FindObject<USeatMap>(Package, *AssetName) : nullptr;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -13,4 +13,23 @@ public:
 	virtual uint32 GetCategories() override;
 	virtual FString GetObjectDisplayName(UObject* Object) const override { return CastChecked<USeatMap>(Object)->GetName(); }
 	virtual void OpenAssetEditor( const TArray<UObject*>& InObjects, TSharedPtr<class IToolkitHost> EditWithinLevelEditor = TSharedPtr<IToolkitHost>() ) override;
+	virtual bool HasActions(const TArray<UObject*>& InObjects) const override { return true; }
+	virtual void GetActions(const TArray<UObject*>& InObjects, FToolMenuSection& Section) override;
+	virtual void PerformAssetDiff(UObject* OldAsset, UObject* NewAsset, const FRevisionInfo& OldRevision,
+	                              const FRevisionInfo& NewRevision) const override;
+	virtual bool CanMerge() const override { return true; }
+	virtual void Merge(UObject* InObject) override;
+	virtual void Merge(UObject* BaseAsset, UObject* RemoteAsset, UObject* LocalAsset,
+	                   const FOnMergeResolved& ResolutionCallback) override;
+
+private:
+	/** Shares the seats of identical meshes and reports how much was saved to the CustomSocket message log. */
+	void ExecuteDeduplicateSeats(TArray<TWeakObjectPtr<USeatMap>> SeatMaps);
+
+	/** Writes the seat blob of each seat map to Saved/SeatBlobs and reports it to the CustomSocket message log. */
+	void ExecuteExportSeatBlobs(TArray<TWeakObjectPtr<USeatMap>> SeatMaps);
+
+	/** Loads the seat map of a source control revision of the package, null if that fails. */
+	static USeatMap* LoadRevision(const TSharedPtr<class ISourceControlRevision, ESPMode::ThreadSafe>& Revision,
+	                              const FString& AssetName);
 };
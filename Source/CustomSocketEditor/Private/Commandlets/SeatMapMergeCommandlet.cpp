@@ -0,0 +1,102 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMapMergeCommandlet.h"
+
+#include "CustomSocketEditor.h"
+#include "Merge/SeatMapMerge.h"
+#include "SeatSocket/SeatSocket.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+namespace SeatMapMergeCommandlet
+{
+	/** The seat map of a package file, which may lie outside the content folders like the files of a merge tool. */
+	USeatMap* LoadSeatMap(const FString& Filename)
+	{
+		UPackage* Package = LoadPackage(nullptr, *Filename, LOAD_ForDiff | LOAD_DisableCompileOnLoad);
+		USeatMap* SeatMap = Package ? Cast<USeatMap>(FindObjectWithOuter(Package, USeatMap::StaticClass())) : nullptr;
+		if (!SeatMap)
+		{
+			UE_LOG(LogCustomSocket, Error, TEXT("%s holds no seat map."), *Filename);
+		}
+		return SeatMap;
+	}
+}
+
+USeatMapMergeCommandlet::USeatMapMergeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USeatMapMergeCommandlet::Main(const FString& Params)
+{
+	using namespace SeatMapMergeCommandlet;
+
+	FString BaseFilename;
+	FString LocalFilename;
+	FString RemoteFilename;
+	FString OutputFilename;
+	FParse::Value(*Params, TEXT("Base="), BaseFilename);
+	FParse::Value(*Params, TEXT("Local="), LocalFilename);
+	FParse::Value(*Params, TEXT("Remote="), RemoteFilename);
+	FParse::Value(*Params, TEXT("Output="), OutputFilename);
+	if (LocalFilename.IsEmpty() || RemoteFilename.IsEmpty() || (!BaseFilename.IsEmpty() && OutputFilename.IsEmpty()))
+	{
+		UE_LOG(LogCustomSocket, Error,
+		       TEXT("Usage: -run=SeatMapMerge [-Base=<File> -Output=<File>] -Local=<File> -Remote=<File>"));
+		return 2;
+	}
+
+	USeatMap* LocalSeatMap = LoadSeatMap(LocalFilename);
+	const USeatMap* RemoteSeatMap = LoadSeatMap(RemoteFilename);
+	if (!LocalSeatMap || !RemoteSeatMap)
+		return 2;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FSeatMapSnapshot Local = FSeatMapSnapshot::Capture(LocalSeatMap);
+	const FSeatMapSnapshot Remote = FSeatMapSnapshot::Capture(RemoteSeatMap);
+
+	if (BaseFilename.IsEmpty())
+	{
+		TArray<FSeatMapDifference> Differences;
+		SeatMapMerge::Diff(Local, Remote, Differences);
+		for (const FSeatMapDifference& Difference : Differences)
+		{
+			UE_LOG(LogCustomSocket, Display, TEXT("%s"), *Difference.ToText().ToString());
+		}
+		UE_LOG(LogCustomSocket, Display, TEXT("%d differences, compared in %.1f ms."), Differences.Num(),
+		       (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		return 0;
+	}
+
+	const USeatMap* BaseSeatMap = LoadSeatMap(BaseFilename);
+	if (!BaseSeatMap)
+		return 2;
+
+	TArray<FSeatMapDifference> Conflicts;
+	const FSeatMapSnapshot Merged = SeatMapMerge::Merge(FSeatMapSnapshot::Capture(BaseSeatMap), Local, Remote,
+	                                                    Conflicts);
+	for (const FSeatMapDifference& Conflict : Conflicts)
+	{
+		UE_LOG(LogCustomSocket, Warning, TEXT("Conflict, kept the local version: %s"), *Conflict.ToText().ToString());
+	}
+
+	// The local package is saved under the output name, so the result keeps the asset's name and settings.
+	Merged.ApplyTo(LocalSeatMap);
+	UPackage* Package = LocalSeatMap->GetOutermost();
+	if (!UPackage::SavePackage(Package, LocalSeatMap, RF_Standalone, *OutputFilename, GError, nullptr, false, true,
+	                           SAVE_NoError))
+	{
+		UE_LOG(LogCustomSocket, Error, TEXT("Failed to save the merged seat map to %s."), *OutputFilename);
+		return 2;
+	}
+
+	UE_LOG(LogCustomSocket, Display, TEXT("Merged %d meshes and %d templates with %d conflicts in %.1f ms."),
+	       Merged.Meshes.Num(), Merged.Templates.Num(), Conflicts.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return Conflicts.Num() > 0 ? 1 : 0;
+}
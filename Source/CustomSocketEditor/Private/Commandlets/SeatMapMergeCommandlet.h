@@ -0,0 +1,24 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SeatMapMergeCommandlet.generated.h"
+
+/**
+ * Three way merge of seat map files for use as a source control merge tool, for git:
+ *   cmd = UE4Editor-Cmd <Project> -run=SeatMapMerge -Base="$BASE" -Local="$LOCAL" -Remote="$REMOTE" -Output="$MERGED"
+ * Without -Base it prints the differences from -Local to -Remote instead.
+ * Returns non zero when the merge had conflicts, which were resolved by keeping the local version.
+ */
+UCLASS()
+class USeatMapMergeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USeatMapMergeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,84 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMapValidateCommandlet.h"
+
+#include "CustomSocketEditor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "SeatAnalysis/SeatValidator.h"
+#include "SeatSocket/SeatSocket.h"
+
+USeatMapValidateCommandlet::USeatMapValidateCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USeatMapValidateCommandlet::Main(const FString& Params)
+{
+	TArray<FString> SeatMapFilter;
+	FString SeatMapParam;
+	if (FParse::Value(*Params, TEXT("SeatMap="), SeatMapParam, false))
+	{
+		SeatMapParam.ParseIntoArray(SeatMapFilter, TEXT("+"));
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> SeatMapAssets;
+	AssetRegistry.GetAssetsByClass(USeatMap::StaticClass()->GetFName(), SeatMapAssets);
+
+	int32 SeatMapCount = 0;
+	int32 IssueCount = 0;
+	for (const FAssetData& SeatMapAsset : SeatMapAssets)
+	{
+		if (SeatMapFilter.Num() > 0 &&
+			!SeatMapFilter.Contains(SeatMapAsset.PackageName.ToString()) &&
+			!SeatMapFilter.Contains(SeatMapAsset.ObjectPath.ToString()))
+			continue;
+
+		USeatMap* SeatMap = Cast<USeatMap>(SeatMapAsset.GetAsset());
+		if (!SeatMap)
+		{
+			UE_LOG(LogCustomSocket, Error, TEXT("Failed to load seat map %s."), *SeatMapAsset.ObjectPath.ToString());
+			++IssueCount;
+			continue;
+		}
+
+		TArray<FSeatMeshValidationResult> Results;
+		FSeatValidator::Get().ValidateSeatMap(SeatMap, Results);
+		++SeatMapCount;
+
+		for (const FSeatMeshValidationResult& Result : Results)
+		{
+			if (!Result.bMeshLoaded)
+			{
+				UE_LOG(LogCustomSocket, Error, TEXT("%s: %s failed to load, its seats were not checked."),
+				       *SeatMap->GetPathName(), *Result.StaticMesh.ToString());
+				++IssueCount;
+				continue;
+			}
+
+			if (!Result.bHasCollision)
+			{
+				UE_LOG(LogCustomSocket, Display, TEXT("%s: %s has no collision, its seats were not checked."),
+				       *SeatMap->GetPathName(), *Result.StaticMesh.ToString());
+			}
+
+			for (const FSeatValidationIssue& Issue : Result.Issues)
+			{
+				UE_LOG(LogCustomSocket, Warning, TEXT("%s: seat '%s' on %s clips into collision at %s."),
+				       *SeatMap->GetPathName(), *Issue.SeatName.ToString(), *Result.StaticMesh.ToString(),
+				       *Issue.Contact.ToCompactString());
+				++IssueCount;
+			}
+		}
+	}
+
+	UE_LOG(LogCustomSocket, Display, TEXT("Validated %d seat maps, found %d issues."), SeatMapCount, IssueCount);
+
+	return IssueCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SeatMapValidateCommandlet.generated.h"
+
+/**
+ * Validates seat placement of every seat map in the project, or of the ones given by -SeatMap=Path1+Path2.
+ * Returns non zero when any seat clips into collision so it can gate a build.
+ */
+UCLASS()
+class USeatMapValidateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USeatMapValidateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
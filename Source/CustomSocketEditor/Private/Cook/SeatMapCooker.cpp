@@ -0,0 +1,208 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMapCooker.h"
+
+#include "CustomSocketEditor.h"
+#include "SeatMapRuntimeData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "SeatAnalysis/SeatBoardingBaker.h"
+#include "SeatAnalysis/SeatFireArcBaker.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "SeatSocket/SeatSocket.h"
+#include "UObject/Package.h"
+
+namespace SeatMapCooker
+{
+	/** Size of the package on disk, INDEX_NONE if it does not exist. */
+	int64 GetPackageFileSize(const FString& PackageName)
+	{
+		FString Filename;
+		if (!FPackageName::DoesPackageExist(PackageName, nullptr, &Filename))
+			return INDEX_NONE;
+
+		return IFileManager::Get().FileSize(*Filename);
+	}
+
+	/** Keeps the generated folder out of git, the cook writes it anew whenever a seat map changes. */
+	void IgnoreGeneratedFolder(const FString& GeneratedFolder)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(GeneratedFolder / TEXT(".gitignore"));
+		if (!IFileManager::Get().FileExists(*Filename))
+		{
+			FFileHelper::SaveStringToFile(TEXT("# Generated by the seat map cook.\n*\n"), *Filename);
+		}
+	}
+
+	int32 CountSeatObjects(const USeatMap* SeatMap)
+	{
+		TSet<const USeatSocket*> SeatObjects;
+		for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+		{
+			SeatObjects.Append(Pair.Value.Seats);
+		}
+		for (const TPair<FName, FSeats>& Pair : SeatMap->Templates)
+		{
+			SeatObjects.Append(Pair.Value.Seats);
+		}
+		SeatObjects.Remove(nullptr);
+		return SeatObjects.Num();
+	}
+}
+
+FSeatMapCooker& FSeatMapCooker::Get()
+{
+	static FSeatMapCooker Cooker;
+	return Cooker;
+}
+
+void FSeatMapCooker::Register()
+{
+	if (bRegistered)
+		return;
+
+	FModifyCookDelegate& ModifyCookDelegate = FGameDelegates::Get().GetModifyCookDelegate();
+	PreviousModifyCook = ModifyCookDelegate;
+	ModifyCookDelegate.BindRaw(this, &FSeatMapCooker::ModifyCook);
+	bRegistered = true;
+}
+
+void FSeatMapCooker::Unregister()
+{
+	if (!bRegistered)
+		return;
+
+	FModifyCookDelegate& ModifyCookDelegate = FGameDelegates::Get().GetModifyCookDelegate();
+	if (ModifyCookDelegate.IsBoundToObject(this))
+	{
+		ModifyCookDelegate = PreviousModifyCook;
+	}
+	PreviousModifyCook.Unbind();
+	bRegistered = false;
+}
+
+USeatMapRuntimeData* FSeatMapCooker::CookSeatMap(USeatMap* SeatMap)
+{
+	using namespace SeatMapCooker;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// Paths and arcs baked in the editor are usually current, only meshes or seats changed since are baked here.
+	// The copy keeps the cook from dirtying seat maps open in the editor.
+	USeatMap* CookedSeatMap = DuplicateObject<USeatMap>(SeatMap, GetTransientPackage());
+	const FSeatBoardingBakeStats BoardingStats = FSeatBoardingBaker::Get().BakeSeatMap(CookedSeatMap);
+	if (BoardingStats.NumUnreachableSeats > 0)
+	{
+		UE_LOG(LogCustomSocket, Warning, TEXT("Seat map %s: %d seats have no boarding path."), *SeatMap->GetPathName(),
+		       BoardingStats.NumUnreachableSeats);
+	}
+
+	const FSeatFireArcBakeStats FireArcStats = FSeatFireArcBaker::Get().BakeSeatMap(CookedSeatMap);
+	if (FireArcStats.NumBlockedSeats > 0)
+	{
+		UE_LOG(LogCustomSocket, Warning, TEXT("Seat map %s: %d fireable seats are blocked in every direction."),
+		       *SeatMap->GetPathName(), FireArcStats.NumBlockedSeats);
+	}
+
+	// Meshes deleted or renamed since their seats were placed would only take space in the build.
+	int32 NumDroppedMeshes = 0;
+	TArray<uint8> Blob;
+	const auto DoesMeshExist = [&AssetRegistry, &NumDroppedMeshes](const TSoftObjectPtr<UStaticMesh>& StaticMesh)
+	{
+		const bool bExists = AssetRegistry.GetAssetByObjectPath(FName(*StaticMesh.ToString())).IsValid();
+		NumDroppedMeshes += bExists ? 0 : 1;
+		return bExists;
+	};
+	CookedSeatMap->BuildSeatBlob(Blob, DoesMeshExist);
+
+	const FString SeatMapPackageName = SeatMap->GetOutermost()->GetName();
+	const FString PackageName = USeatMapRuntimeData::GetRuntimeDataPackageName(SeatMapPackageName);
+	const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+
+	UPackage* Package = FPackageName::DoesPackageExist(PackageName)
+		                    ? LoadPackage(nullptr, *PackageName, LOAD_NoWarn | LOAD_Quiet)
+		                    : nullptr;
+	if (!Package)
+	{
+		Package = CreatePackage(*PackageName);
+	}
+
+	bool bChanged = false;
+	USeatMapRuntimeData* RuntimeData = FindObject<USeatMapRuntimeData>(Package, *AssetName);
+	if (!RuntimeData)
+	{
+		RuntimeData = NewObject<USeatMapRuntimeData>(Package, *AssetName, RF_Public | RF_Standalone);
+		RuntimeData->SourceSeatMap = SeatMap;
+		FAssetRegistryModule::AssetCreated(RuntimeData);
+		bChanged = true;
+	}
+	bChanged |= RuntimeData->SetBlob(MoveTemp(Blob));
+
+	if (bChanged)
+	{
+		IgnoreGeneratedFolder(USeatMapRuntimeData::GetGeneratedFolder(SeatMapPackageName));
+
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName,
+		                                                                 FPackageName::GetAssetPackageExtension());
+		if (!UPackage::SavePackage(Package, RuntimeData, RF_Public | RF_Standalone, *Filename, GError, nullptr, false,
+		                           true, SAVE_NoError))
+		{
+			UE_LOG(LogCustomSocket, Error, TEXT("Failed to save the runtime data of %s to %s."),
+			       *SeatMap->GetPathName(), *Filename);
+			return nullptr;
+		}
+	}
+
+	UE_LOG(LogCustomSocket, Display,
+	       TEXT("Seat map %s: %lld bytes with %d seat objects -> %s: %lld bytes, %d meshes with %d seats%s."),
+	       *SeatMapPackageName, GetPackageFileSize(SeatMapPackageName), CountSeatObjects(SeatMap), *PackageName,
+	       GetPackageFileSize(PackageName), RuntimeData->GetView().GetMeshes().Num(),
+	       RuntimeData->GetView().GetSeats().Num(),
+	       NumDroppedMeshes > 0 ? *FString::Printf(TEXT(", %d missing meshes dropped"), NumDroppedMeshes) : TEXT(""));
+
+	return RuntimeData;
+}
+
+void FSeatMapCooker::ModifyCook(TArray<FName>& PackagesToCook, TArray<FName>& PackagesToNeverCook)
+{
+	PreviousModifyCook.ExecuteIfBound(PackagesToCook, PackagesToNeverCook);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> SeatMapAssets;
+	AssetRegistry.GetAssetsByClass(USeatMap::StaticClass()->GetFName(), SeatMapAssets);
+
+	// Errors fail the cook, a build without the seats of a seat map would only fail later at runtime.
+	for (const FAssetData& SeatMapAsset : SeatMapAssets)
+	{
+		USeatMap* SeatMap = Cast<USeatMap>(SeatMapAsset.GetAsset());
+		if (!SeatMap)
+		{
+			UE_LOG(LogCustomSocket, Error, TEXT("Failed to load seat map %s."), *SeatMapAsset.ObjectPath.ToString());
+			continue;
+		}
+
+		const USeatMapRuntimeData* RuntimeData = CookSeatMap(SeatMap);
+		if (!RuntimeData)
+			continue;
+
+		PackagesToCook.AddUnique(RuntimeData->GetOutermost()->GetFName());
+		PackagesToNeverCook.AddUnique(SeatMapAsset.PackageName);
+
+		// Seat maps are editor data, game content has to load the runtime data instead.
+		TArray<FName> Referencers;
+		const UE::AssetRegistry::FDependencyQuery CookedReferences(
+			UE::AssetRegistry::EDependencyQuery::Hard | UE::AssetRegistry::EDependencyQuery::Game);
+		AssetRegistry.GetReferencers(SeatMapAsset.PackageName, Referencers,
+		                             UE::AssetRegistry::EDependencyCategory::Package, CookedReferences);
+		for (const FName Referencer : Referencers)
+		{
+			UE_LOG(LogCustomSocket, Error, TEXT("%s references seat map %s, which is not cooked. Reference %s instead."),
+			       *Referencer.ToString(), *SeatMapAsset.PackageName.ToString(),
+			       *RuntimeData->GetOutermost()->GetName());
+		}
+	}
+}
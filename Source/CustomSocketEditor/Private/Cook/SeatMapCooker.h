@@ -0,0 +1,41 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameDelegates.h"
+
+class USeatMap;
+class USeatMapRuntimeData;
+
+/**
+ * Flattens seat maps for cooked builds. Before a cook by the book every seat map is turned into a
+ * USeatMapRuntimeData, which is cooked instead of the seat map, its seat objects and editor data.
+ * Runtime data is written to the folder of USeatMapRuntimeData::GetGeneratedFolder, never beside the
+ * seat maps. The folder ignores itself in git and should be kept out of other source control too.
+ * Meshes without seats or that no longer exist are dropped, templates are resolved into the meshes using them.
+ * Seat maps whose runtime data cannot be written, or that cooked packages still reference, fail the cook.
+ */
+class FSeatMapCooker
+{
+public:
+	static FSeatMapCooker& Get();
+
+	/** Hooks into the cook, a delegate the game bound before is still called. */
+	void Register();
+	void Unregister();
+
+	/**
+	 * Brings the runtime data of the seat map up to date, saving it only if it changed.
+	 * Paths and arcs missing from the seat map are baked into a copy, the seat map itself is left as it is.
+	 *
+	 * @return		The runtime data, null if it could not be saved.
+	 */
+	USeatMapRuntimeData* CookSeatMap(USeatMap* SeatMap);
+
+private:
+	void ModifyCook(TArray<FName>& PackagesToCook, TArray<FName>& PackagesToNeverCook);
+
+	FModifyCookDelegate PreviousModifyCook;
+	bool bRegistered = false;
+};
@@ -6,7 +6,10 @@
 #include "AssetTypeAction_SeatMap.h"
 #include "CustomSocketEditorStyle.h"
 #include "CustomSocketEditorCommands.h"
+#include "CustomSocketStats.h"
+#include "Cook/SeatMapCooker.h"
 #include "LevelEditor.h"
+#include "MessageLogModule.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Layout/SBox.h"
 #include "ToolMenus.h"
@@ -17,6 +20,29 @@ static const FName CustomSocketEditorTabName("CustomSocketEditorTabTitle");
 
 EAssetTypeCategories::Type FCustomSocketEditorModule::BYCAssetCategoryBit;
 
+DEFINE_STAT(STAT_CustomSocket_ActivePreviewTicks);
+DEFINE_STAT(STAT_CustomSocket_RebuildPreviews);
+DEFINE_STAT(STAT_CustomSocket_BuildSeatPreview);
+DEFINE_STAT(STAT_CustomSocket_RefreshSeatGizmos);
+DEFINE_STAT(STAT_CustomSocket_RefreshSocketList);
+DEFINE_STAT(STAT_CustomSocket_UpdateSocketListStatus);
+DEFINE_STAT(STAT_CustomSocket_FilterSocketList);
+DEFINE_STAT(STAT_CustomSocket_PropertyChanged);
+DEFINE_STAT(STAT_CustomSocket_ExportSeats);
+DEFINE_STAT(STAT_CustomSocket_ImportSeats);
+DEFINE_STAT(STAT_CustomSocket_EditSeats);
+DEFINE_STAT(STAT_CustomSocket_ValidateSeatMap);
+DEFINE_STAT(STAT_CustomSocket_GenerateCandidates);
+DEFINE_STAT(STAT_CustomSocket_NumSeats);
+DEFINE_STAT(STAT_CustomSocket_NumSeatPreviews);
+DEFINE_STAT(STAT_CustomSocket_SeatMemory);
+DEFINE_STAT(STAT_CustomSocket_SeatPreviewMemory);
+DEFINE_STAT(STAT_CustomSocket_ValidationCacheMemory);
+
+DEFINE_LOG_CATEGORY(LogCustomSocket);
+
+static const FName CustomSocketLogName("CustomSocket");
+
 #define LOCTEXT_NAMESPACE "FCustomSocketEditorModule"
 
 void FCustomSocketEditorModule::StartupModule()
@@ -42,6 +68,11 @@ void FCustomSocketEditorModule::StartupModule()
 
 	BYCAssetCategoryBit = AssetTools.RegisterAdvancedAssetCategory(FName(TEXT("BYC")), LOCTEXT("BYCAssetCategory", "BYC"));
 	AssetTools.RegisterAssetTypeActions(MakeShared<FAssetTypeActions_SeatMap>());
+
+	FMessageLogModule& MessageLogModule = FModuleManager::LoadModuleChecked<FMessageLogModule>("MessageLog");
+	MessageLogModule.RegisterLogListing(CustomSocketLogName, LOCTEXT("CustomSocketLog", "Custom Socket"));
+
+	FSeatMapCooker::Get().Register();
 }
 
 void FCustomSocketEditorModule::ShutdownModule()
@@ -58,6 +89,14 @@ void FCustomSocketEditorModule::ShutdownModule()
 	FCustomSocketEditorCommands::Unregister();
 
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(CustomSocketEditorTabName);
+
+	FSeatMapCooker::Get().Unregister();
+
+	if (FModuleManager::Get().IsModuleLoaded("MessageLog"))
+	{
+		FMessageLogModule& MessageLogModule = FModuleManager::GetModuleChecked<FMessageLogModule>("MessageLog");
+		MessageLogModule.UnregisterLogListing(CustomSocketLogName);
+	}
 }
 
 void FCustomSocketEditorModule::SpawnCustomSocketEditor()
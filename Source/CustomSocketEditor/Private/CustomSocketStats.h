@@ -0,0 +1,43 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("CustomSocket"), STATGROUP_CustomSocket, STATCAT_Advanced);
+
+/** Number of posture pose leaders that ticked this frame, zero while the seat editor is idle. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Preview Ticks"), STAT_CustomSocket_ActivePreviewTicks, STATGROUP_CustomSocket, );
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rebuild Seat Previews"), STAT_CustomSocket_RebuildPreviews, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Seat Preview"), STAT_CustomSocket_BuildSeatPreview, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh Seat Gizmos"), STAT_CustomSocket_RefreshSeatGizmos, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh Socket List"), STAT_CustomSocket_RefreshSocketList, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Socket List Status"), STAT_CustomSocket_UpdateSocketListStatus, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Filter Socket List"), STAT_CustomSocket_FilterSocketList, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Seat Property Changed"), STAT_CustomSocket_PropertyChanged, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Export Seats"), STAT_CustomSocket_ExportSeats, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Import Seats"), STAT_CustomSocket_ImportSeats, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Edit Seats"), STAT_CustomSocket_EditSeats, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Seat Map"), STAT_CustomSocket_ValidateSeatMap, STATGROUP_CustomSocket, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Seat Candidates"), STAT_CustomSocket_GenerateCandidates, STATGROUP_CustomSocket, );
+
+/** Seats and previews alive right now, these persist across frames unlike the tick counter above. */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Seats"), STAT_CustomSocket_NumSeats, STATGROUP_CustomSocket, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Seat Previews"), STAT_CustomSocket_NumSeatPreviews, STATGROUP_CustomSocket, );
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Seat Memory"), STAT_CustomSocket_SeatMemory, STATGROUP_CustomSocket, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Seat Preview Memory"), STAT_CustomSocket_SeatPreviewMemory, STATGROUP_CustomSocket, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Validation Cache Memory"), STAT_CustomSocket_ValidationCacheMemory, STATGROUP_CustomSocket, );
+
+/**
+ * Times the scope for stat CustomSocket. Cycle stats already show up as CPU events in Unreal Insights,
+ * builds without stats still get a named trace scope.
+ */
+#if STATS
+#define SEAT_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define SEAT_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
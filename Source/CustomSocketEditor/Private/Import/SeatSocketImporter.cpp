@@ -0,0 +1,213 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatSocketImporter.h"
+
+#include "CustomSocketEditor.h"
+#include "CustomSocketStats.h"
+#include "ScopedTransaction.h"
+#include "SeatSettings.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "SeatSocketImporter"
+
+namespace SeatSocketImporter
+{
+	/** Meshes loaded at once, bounds the memory an import holds on to. */
+	const int32 BatchSize = 32;
+}
+
+FSeatSocketImporter::~FSeatSocketImporter()
+{
+	if (BatchHandle.IsValid())
+	{
+		BatchHandle->CancelHandle();
+	}
+
+	if (Notification.IsValid())
+	{
+		Notification->SetCompletionState(SNotificationItem::CS_Fail);
+		Notification->ExpireAndFadeout();
+	}
+}
+
+TSharedRef<FSeatSocketImporter> FSeatSocketImporter::Import(USeatMap* InSeatMap,
+                                                            const TArray<FSoftObjectPath>& InStaticMeshes,
+                                                            const FOnImportFinished& InOnFinished)
+{
+	TSharedRef<FSeatSocketImporter> Importer = MakeShared<FSeatSocketImporter>();
+	Importer->SeatMap = InSeatMap;
+	Importer->StaticMeshes = InStaticMeshes;
+	Importer->OnFinished = InOnFinished;
+
+	FNotificationInfo Info(FText::Format(LOCTEXT("Importing", "Importing seats from {0} meshes"),
+	                                     FText::AsNumber(InStaticMeshes.Num())));
+	Info.bFireAndForget = false;
+	Importer->Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (Importer->Notification.IsValid())
+	{
+		Importer->Notification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	Importer->LoadNextBatch();
+	return Importer;
+}
+
+bool FSeatSocketImporter::ParseSocketName(FName SocketName, ESeatType& OutSeatType, EPosture& OutPosture)
+{
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+	const FString Name = SocketName.ToString();
+
+	if (Settings->SeatSocketPrefix.IsEmpty() || !Name.StartsWith(Settings->SeatSocketPrefix))
+		return false;
+
+	OutSeatType = !Settings->FireableSocketToken.IsEmpty() && Name.Contains(Settings->FireableSocketToken)
+		              ? ESeatType::Fireable
+		              : ESeatType::Normal;
+
+	OutPosture = EPosture::StandUp;
+	for (const TPair<EPosture, FString>& PostureToken : Settings->PostureSocketTokens)
+	{
+		if (!PostureToken.Value.IsEmpty() && Name.Contains(PostureToken.Value))
+		{
+			OutPosture = PostureToken.Key;
+			break;
+		}
+	}
+
+	return true;
+}
+
+void FSeatSocketImporter::LoadNextBatch()
+{
+	if (!SeatMap.IsValid())
+	{
+		BatchHandle.Reset();
+		return;
+	}
+
+	if (NextStaticMesh >= StaticMeshes.Num())
+	{
+		Finish();
+		return;
+	}
+
+	const int32 BatchEnd = FMath::Min(NextStaticMesh + SeatSocketImporter::BatchSize, StaticMeshes.Num());
+	TArray<FSoftObjectPath> Batch(StaticMeshes.GetData() + NextStaticMesh, BatchEnd - NextStaticMesh);
+	NextStaticMesh = BatchEnd;
+
+	if (Notification.IsValid())
+	{
+		Notification->SetText(FText::Format(LOCTEXT("ImportProgress", "Importing seats ({0} of {1} meshes)"),
+		                                    FText::AsNumber(NextStaticMesh), FText::AsNumber(StaticMeshes.Num())));
+	}
+
+	// Meshes that are already loaded complete the handle right away, the delegate still fires next tick.
+	BatchHandle = StreamableManager.RequestAsyncLoad(
+		Batch, FStreamableDelegate::CreateSP(this, &FSeatSocketImporter::OnBatchLoaded));
+	if (!BatchHandle.IsValid())
+	{
+		LoadNextBatch();
+	}
+}
+
+void FSeatSocketImporter::OnBatchLoaded()
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_ImportSeats);
+
+	TArray<UObject*> LoadedAssets;
+	BatchHandle->GetLoadedAssets(LoadedAssets);
+
+	for (UObject* LoadedAsset : LoadedAssets)
+	{
+		const UStaticMesh* StaticMesh = Cast<UStaticMesh>(LoadedAsset);
+		if (!StaticMesh)
+			continue;
+
+		TArray<FImportedSeat> Seats;
+		for (const UStaticMeshSocket* Socket : StaticMesh->Sockets)
+		{
+			FImportedSeat Seat;
+			if (!Socket || !ParseSocketName(Socket->SocketName, Seat.SeatType, Seat.Posture))
+				continue;
+
+			Seat.Name = Socket->SocketName;
+			Seat.Location = Socket->RelativeLocation;
+			Seat.Rotation = Socket->RelativeRotation;
+			Seats.Add(Seat);
+		}
+
+		if (Seats.Num() > 0)
+		{
+			ImportedSeats.Emplace(FSoftObjectPath(StaticMesh), MoveTemp(Seats));
+		}
+	}
+
+	// Releasing the batch lets the garbage collector drop meshes nothing else uses.
+	BatchHandle->ReleaseHandle();
+	LoadNextBatch();
+}
+
+void FSeatSocketImporter::Finish()
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_ImportSeats);
+
+	BatchHandle.Reset();
+
+	int32 NumImportedSeats = 0;
+	if (USeatMap* PinnedSeatMap = SeatMap.Get())
+	{
+		const FScopedTransaction Transaction(LOCTEXT("ImportSeats", "Import Seats"));
+		PinnedSeatMap->PreEditChange(NULL);
+
+		for (const TPair<FSoftObjectPath, TArray<FImportedSeat>>& MeshSeats : ImportedSeats)
+		{
+			FSeats& Seats = PinnedSeatMap->GetSeats(TSoftObjectPtr<UStaticMesh>(MeshSeats.Key));
+			for (const FImportedSeat& ImportedSeat : MeshSeats.Value)
+			{
+				// Importing again only adds sockets that are new since the last import.
+				const bool bExists = Seats.Seats.ContainsByPredicate([&ImportedSeat](const USeatSocket* Seat)
+				{
+					return Seat && Seat->Name == ImportedSeat.Name;
+				});
+				if (bExists)
+					continue;
+
+				USeatSocket* Seat = NewObject<USeatSocket>(PinnedSeatMap, NAME_None, RF_Transactional);
+				Seat->Name = ImportedSeat.Name;
+				Seat->RelativeLocation = ImportedSeat.Location;
+				Seat->RelativeRotation = ImportedSeat.Rotation;
+				Seat->SeatType = ImportedSeat.SeatType;
+				Seat->Posture = ImportedSeat.Posture;
+				Seats.Seats.Add(Seat);
+				++NumImportedSeats;
+			}
+		}
+
+		PinnedSeatMap->PostEditChange();
+		if (NumImportedSeats > 0)
+		{
+			PinnedSeatMap->MarkPackageDirty();
+		}
+	}
+
+	UE_LOG(LogCustomSocket, Display, TEXT("Imported %d seats from %d of %d meshes."), NumImportedSeats,
+	       ImportedSeats.Num(), StaticMeshes.Num());
+
+	if (Notification.IsValid())
+	{
+		Notification->SetText(FText::Format(LOCTEXT("ImportFinished", "Imported {0} seats from {1} meshes"),
+		                                    FText::AsNumber(NumImportedSeats), FText::AsNumber(ImportedSeats.Num())));
+		Notification->SetCompletionState(SNotificationItem::CS_Success);
+		Notification->ExpireAndFadeout();
+		Notification.Reset();
+	}
+
+	ImportedSeats.Empty();
+	OnFinished.ExecuteIfBound(NumImportedSeats);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,61 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "SeatSocket/SeatSocket.h"
+
+class SNotificationItem;
+
+/**
+ * Converts static mesh sockets that follow the naming convention of USeatSettings into seats of a seat map.
+ * Meshes are loaded asynchronously in batches, so hundreds of them import without stalling the editor
+ * or keeping every mesh in memory. The seats are added in one transaction once all meshes were read.
+ */
+class FSeatSocketImporter : public TSharedFromThis<FSeatSocketImporter>
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnImportFinished, int32 /* NumImportedSeats */);
+
+	~FSeatSocketImporter();
+
+	/** Starts importing, the import stops when the returned importer is released. */
+	static TSharedRef<FSeatSocketImporter> Import(USeatMap* InSeatMap, const TArray<FSoftObjectPath>& InStaticMeshes,
+	                                              const FOnImportFinished& InOnFinished = FOnImportFinished());
+
+	/**
+	 * Maps a socket name to seat settings.
+	 *
+	 * @return		FALSE if the name does not start with the seat socket prefix.
+	 */
+	static bool ParseSocketName(FName SocketName, ESeatType& OutSeatType, EPosture& OutPosture);
+
+	bool IsRunning() const { return BatchHandle.IsValid(); }
+
+private:
+	struct FImportedSeat
+	{
+		FName Name;
+		FVector Location;
+		FRotator Rotation;
+		ESeatType SeatType;
+		EPosture Posture;
+	};
+
+	void LoadNextBatch();
+	void OnBatchLoaded();
+	void Finish();
+
+	TWeakObjectPtr<USeatMap> SeatMap;
+	TArray<FSoftObjectPath> StaticMeshes;
+	int32 NextStaticMesh = 0;
+
+	/** Seats read so far, per mesh in import order. */
+	TArray<TPair<FSoftObjectPath, TArray<FImportedSeat>>> ImportedSeats;
+
+	FOnImportFinished OnFinished;
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> BatchHandle;
+	TSharedPtr<SNotificationItem> Notification;
+};
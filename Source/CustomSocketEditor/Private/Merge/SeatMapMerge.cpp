@@ -0,0 +1,383 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMapMerge.h"
+
+#define LOCTEXT_NAMESPACE "SeatMapMerge"
+
+namespace SeatMapMerge
+{
+	/** Key of the next seat named SeatName in an entry, seats are keyed in their order. */
+	template <typename ValueType>
+	FSeatMapSeatKey MakeSeatKey(FName SeatName, const TMap<FSeatMapSeatKey, ValueType>& Seats)
+	{
+		FSeatMapSeatKey Key{SeatName, 0};
+		while (Seats.Contains(Key))
+		{
+			++Key.Occurrence;
+		}
+		return Key;
+	}
+
+	FSeatMapSeat CaptureSeat(const USeatSocket* Seat)
+	{
+		FSeatMapSeat MapSeat;
+		MapSeat.Name = Seat->Name;
+		MapSeat.RelativeLocation = Seat->RelativeLocation;
+		MapSeat.RelativeRotation = Seat->RelativeRotation;
+		MapSeat.SeatType = Seat->SeatType;
+		MapSeat.Posture = Seat->Posture;
+		MapSeat.YawScope = Seat->YawScope;
+		MapSeat.PitchScope = Seat->PitchScope;
+		return MapSeat;
+	}
+
+	FSeatMapEntry CaptureEntry(const FSeats& Seats)
+	{
+		FSeatMapEntry Entry;
+		Entry.TemplateUse.Template = Seats.Template;
+		Entry.TemplateUse.Transform = Seats.TemplateTransform;
+		Entry.Seats.Reserve(Seats.Seats.Num());
+
+		for (const USeatSocket* Seat : Seats.Seats)
+		{
+			if (Seat)
+			{
+				Entry.Seats.Add(MakeSeatKey(Seat->Name, Entry.Seats), CaptureSeat(Seat));
+			}
+		}
+
+		return Entry;
+	}
+
+	void SetSeatFields(USeatSocket* Seat, const FSeatMapSeat& MapSeat)
+	{
+		Seat->Name = MapSeat.Name;
+		Seat->RelativeLocation = MapSeat.RelativeLocation;
+		Seat->RelativeRotation = MapSeat.RelativeRotation;
+		Seat->SeatType = MapSeat.SeatType;
+		Seat->Posture = MapSeat.Posture;
+		Seat->YawScope = MapSeat.YawScope;
+		Seat->PitchScope = MapSeat.PitchScope;
+	}
+
+	/** How many meshes and templates list each seat object, identical seat sets share their objects. */
+	TMap<const USeatSocket*, int32> CountSeatUses(const USeatMap* SeatMap)
+	{
+		TMap<const USeatSocket*, int32> SeatUses;
+		for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+		{
+			for (const USeatSocket* Seat : Pair.Value.Seats)
+			{
+				++SeatUses.FindOrAdd(Seat);
+			}
+		}
+		for (const TPair<FName, FSeats>& Pair : SeatMap->Templates)
+		{
+			for (const USeatSocket* Seat : Pair.Value.Seats)
+			{
+				++SeatUses.FindOrAdd(Seat);
+			}
+		}
+		return SeatUses;
+	}
+
+	/** Brings the seats to the entry, only added and changed seats are touched. */
+	void ApplyEntry(const FSeatMapEntry& Entry, USeatMap* SeatMap, const TMap<const USeatSocket*, int32>& SeatUses,
+	                FSeats& InOutSeats)
+	{
+		InOutSeats.Template = Entry.TemplateUse.Template;
+		InOutSeats.TemplateTransform = Entry.TemplateUse.Transform;
+
+		// Keyed as the snapshot keys them, so duplicate names find their own object.
+		TMap<FSeatMapSeatKey, USeatSocket*> CurrentSeats;
+		for (USeatSocket* Seat : InOutSeats.Seats)
+		{
+			if (Seat)
+			{
+				CurrentSeats.Add(MakeSeatKey(Seat->Name, CurrentSeats), Seat);
+			}
+		}
+
+		TArray<USeatSocket*> Seats;
+		Seats.Reserve(Entry.Seats.Num());
+		for (const TPair<FSeatMapSeatKey, FSeatMapSeat>& Pair : Entry.Seats)
+		{
+			USeatSocket* Seat = CurrentSeats.FindRef(Pair.Key);
+			if (!Seat)
+			{
+				Seat = NewObject<USeatSocket>(SeatMap, NAME_None, RF_Transactional);
+				SetSeatFields(Seat, Pair.Value);
+			}
+			else if (CaptureSeat(Seat) != Pair.Value)
+			{
+				// Other meshes sharing the seat keep it as it is, this one gets a changed copy.
+				if (SeatUses.FindRef(Seat) > 1)
+				{
+					Seat = DuplicateObject(Seat, SeatMap);
+				}
+				else
+				{
+					Seat->Modify();
+				}
+				SetSeatFields(Seat, Pair.Value);
+			}
+			Seats.Add(Seat);
+		}
+
+		if (Seats != InOutSeats.Seats)
+		{
+			InOutSeats.Seats = MoveTemp(Seats);
+		}
+	}
+
+	FString GetOwner(const FSoftObjectPath& MeshPath) { return MeshPath.ToString(); }
+	FString GetOwner(FName TemplateName) { return TemplateName.ToString(); }
+
+	/** Keys of all maps, in the order of the first map that has them. */
+	template <typename KeyType, typename ValueType>
+	TArray<KeyType> GetKeys(std::initializer_list<const TMap<KeyType, ValueType>*> Maps)
+	{
+		TSet<KeyType> Keys;
+		for (const TMap<KeyType, ValueType>* Map : Maps)
+		{
+			for (const TPair<KeyType, ValueType>& Pair : *Map)
+			{
+				Keys.Add(Pair.Key);
+			}
+		}
+		return Keys.Array();
+	}
+
+	template <typename ValueType>
+	bool IsSame(const ValueType* A, const ValueType* B)
+	{
+		return A == B || (A && B && *A == *B);
+	}
+
+	/** Null where the value does not exist on that side. */
+	template <typename ValueType>
+	const ValueType* MergeValue(const ValueType* Base, const ValueType* Local, const ValueType* Remote, bool& bOutConflict)
+	{
+		bOutConflict = false;
+		if (IsSame(Local, Base))
+			return Remote;
+
+		if (IsSame(Remote, Base) || IsSame(Local, Remote))
+			return Local;
+
+		bOutConflict = true;
+		return Local;
+	}
+
+	ESeatMapChange GetChange(const void* Old, const void* New)
+	{
+		return !Old ? ESeatMapChange::Added : !New ? ESeatMapChange::Removed : ESeatMapChange::Modified;
+	}
+
+	template <typename KeyType>
+	void DiffEntries(const TMap<KeyType, FSeatMapEntry>& Old, const TMap<KeyType, FSeatMapEntry>& New, bool bTemplates,
+	                 TArray<FSeatMapDifference>& OutDifferences)
+	{
+		for (const KeyType& Key : GetKeys<KeyType, FSeatMapEntry>({&New, &Old}))
+		{
+			const FSeatMapEntry* OldEntry = Old.Find(Key);
+			const FSeatMapEntry* NewEntry = New.Find(Key);
+			const FSeatMapTemplateUse* OldUse = OldEntry ? &OldEntry->TemplateUse : nullptr;
+			const FSeatMapTemplateUse* NewUse = NewEntry ? &NewEntry->TemplateUse : nullptr;
+			const FString Owner = GetOwner(Key);
+
+			if (!IsSame(OldUse, NewUse))
+			{
+				OutDifferences.Add({Owner, bTemplates, NAME_None, GetChange(OldUse, NewUse)});
+			}
+
+			static const TMap<FSeatMapSeatKey, FSeatMapSeat> NoSeats;
+			const TMap<FSeatMapSeatKey, FSeatMapSeat>& OldSeats = OldEntry ? OldEntry->Seats : NoSeats;
+			const TMap<FSeatMapSeatKey, FSeatMapSeat>& NewSeats = NewEntry ? NewEntry->Seats : NoSeats;
+			for (const FSeatMapSeatKey& SeatKey : GetKeys<FSeatMapSeatKey, FSeatMapSeat>({&NewSeats, &OldSeats}))
+			{
+				const FSeatMapSeat* OldSeat = OldSeats.Find(SeatKey);
+				const FSeatMapSeat* NewSeat = NewSeats.Find(SeatKey);
+				if (!IsSame(OldSeat, NewSeat))
+				{
+					OutDifferences.Add({Owner, bTemplates, SeatKey.Name, GetChange(OldSeat, NewSeat)});
+				}
+			}
+		}
+	}
+
+	template <typename KeyType>
+	void MergeEntries(const TMap<KeyType, FSeatMapEntry>& Base, const TMap<KeyType, FSeatMapEntry>& Local,
+	                  const TMap<KeyType, FSeatMapEntry>& Remote, bool bTemplates, TMap<KeyType, FSeatMapEntry>& OutMerged,
+	                  TArray<FSeatMapDifference>& OutConflicts)
+	{
+		static const TMap<FSeatMapSeatKey, FSeatMapSeat> NoSeats;
+
+		for (const KeyType& Key : GetKeys<KeyType, FSeatMapEntry>({&Local, &Remote, &Base}))
+		{
+			const FSeatMapEntry* BaseEntry = Base.Find(Key);
+			const FSeatMapEntry* LocalEntry = Local.Find(Key);
+			const FSeatMapEntry* RemoteEntry = Remote.Find(Key);
+			const FString Owner = GetOwner(Key);
+
+			// The entry itself merges like a value, it exists where its template use does.
+			bool bConflict;
+			const FSeatMapTemplateUse* LocalUse = LocalEntry ? &LocalEntry->TemplateUse : nullptr;
+			const FSeatMapTemplateUse* RemoteUse = RemoteEntry ? &RemoteEntry->TemplateUse : nullptr;
+			const FSeatMapTemplateUse* MergedUse = MergeValue(BaseEntry ? &BaseEntry->TemplateUse : nullptr, LocalUse,
+			                                                  RemoteUse, bConflict);
+			if (bConflict)
+			{
+				OutConflicts.Add({Owner, bTemplates, NAME_None, GetChange(BaseEntry, LocalUse)});
+			}
+
+			const TMap<FSeatMapSeatKey, FSeatMapSeat>& BaseSeats = BaseEntry ? BaseEntry->Seats : NoSeats;
+			const TMap<FSeatMapSeatKey, FSeatMapSeat>& LocalSeats = LocalEntry ? LocalEntry->Seats : NoSeats;
+			const TMap<FSeatMapSeatKey, FSeatMapSeat>& RemoteSeats = RemoteEntry ? RemoteEntry->Seats : NoSeats;
+
+			FSeatMapEntry MergedEntry;
+			for (const FSeatMapSeatKey& SeatKey :
+			     GetKeys<FSeatMapSeatKey, FSeatMapSeat>({&LocalSeats, &RemoteSeats, &BaseSeats}))
+			{
+				const FSeatMapSeat* BaseSeat = BaseSeats.Find(SeatKey);
+				const FSeatMapSeat* LocalSeat = LocalSeats.Find(SeatKey);
+				const FSeatMapSeat* MergedSeat = MergeValue(BaseSeat, LocalSeat, RemoteSeats.Find(SeatKey), bConflict);
+				if (bConflict)
+				{
+					OutConflicts.Add({Owner, bTemplates, SeatKey.Name, GetChange(BaseSeat, LocalSeat)});
+				}
+				if (MergedSeat)
+				{
+					MergedEntry.Seats.Add(SeatKey, *MergedSeat);
+				}
+			}
+
+			// Seats kept or added on one side keep the entry of a mesh the other side removed.
+			if (MergedUse || MergedEntry.Seats.Num() > 0)
+			{
+				const FSeatMapTemplateUse* KeptUse = MergedUse ? MergedUse : LocalUse ? LocalUse : RemoteUse;
+				MergedEntry.TemplateUse = KeptUse ? *KeptUse : FSeatMapTemplateUse();
+				OutMerged.Add(Key, MoveTemp(MergedEntry));
+			}
+		}
+	}
+}
+
+bool FSeatMapSeat::operator==(const FSeatMapSeat& Other) const
+{
+	return Name == Other.Name &&
+		RelativeLocation == Other.RelativeLocation &&
+		RelativeRotation == Other.RelativeRotation &&
+		SeatType == Other.SeatType &&
+		Posture == Other.Posture &&
+		YawScope == Other.YawScope &&
+		PitchScope == Other.PitchScope;
+}
+
+FSeatMapSnapshot FSeatMapSnapshot::Capture(const USeatMap* SeatMap)
+{
+	FSeatMapSnapshot Snapshot;
+	if (!SeatMap)
+		return Snapshot;
+
+	Snapshot.Meshes.Reserve(SeatMap->SeatMap.Num());
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+	{
+		Snapshot.Meshes.Add(Pair.Key.ToSoftObjectPath(), SeatMapMerge::CaptureEntry(Pair.Value));
+	}
+	for (const TPair<FName, FSeats>& Pair : SeatMap->Templates)
+	{
+		Snapshot.Templates.Add(Pair.Key, SeatMapMerge::CaptureEntry(Pair.Value));
+	}
+
+	return Snapshot;
+}
+
+void FSeatMapSnapshot::ApplyTo(USeatMap* SeatMap) const
+{
+	using namespace SeatMapMerge;
+
+	const TMap<const USeatSocket*, int32> SeatUses = CountSeatUses(SeatMap);
+
+	for (auto It = SeatMap->SeatMap.CreateIterator(); It; ++It)
+	{
+		if (!Meshes.Contains(It.Key().ToSoftObjectPath()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = SeatMap->Templates.CreateIterator(); It; ++It)
+	{
+		if (!Templates.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const TPair<FSoftObjectPath, FSeatMapEntry>& Pair : Meshes)
+	{
+		FSeats& Seats = SeatMap->SeatMap.FindOrAdd(TSoftObjectPtr<UStaticMesh>(Pair.Key));
+		ApplyEntry(Pair.Value, SeatMap, SeatUses, Seats);
+	}
+	for (const TPair<FName, FSeatMapEntry>& Pair : Templates)
+	{
+		FSeats& Seats = SeatMap->Templates.FindOrAdd(Pair.Key);
+		ApplyEntry(Pair.Value, SeatMap, SeatUses, Seats);
+	}
+}
+
+FText FSeatMapDifference::ToText() const
+{
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("Owner"), FText::FromString(Owner));
+	Args.Add(TEXT("Seat"), FText::FromName(SeatName));
+
+	const bool bSeat = !SeatName.IsNone();
+	switch (Change)
+	{
+	case ESeatMapChange::Added:
+		return FText::Format(bSeat
+			                     ? (bTemplate
+				                        ? LOCTEXT("TemplateSeatAdded", "Template {Owner}: seat '{Seat}' added")
+				                        : LOCTEXT("SeatAdded", "{Owner}: seat '{Seat}' added"))
+			                     : (bTemplate
+				                        ? LOCTEXT("TemplateAdded", "Template {Owner} added")
+				                        : LOCTEXT("MeshAdded", "{Owner} added")), Args);
+	case ESeatMapChange::Removed:
+		return FText::Format(bSeat
+			                     ? (bTemplate
+				                        ? LOCTEXT("TemplateSeatRemoved", "Template {Owner}: seat '{Seat}' removed")
+				                        : LOCTEXT("SeatRemoved", "{Owner}: seat '{Seat}' removed"))
+			                     : (bTemplate
+				                        ? LOCTEXT("TemplateRemoved", "Template {Owner} removed")
+				                        : LOCTEXT("MeshRemoved", "{Owner} removed")), Args);
+	default:
+		return FText::Format(bSeat
+			                     ? (bTemplate
+				                        ? LOCTEXT("TemplateSeatModified", "Template {Owner}: seat '{Seat}' changed")
+				                        : LOCTEXT("SeatModified", "{Owner}: seat '{Seat}' changed"))
+			                     : LOCTEXT("TemplateUseModified", "{Owner}: template changed"), Args);
+	}
+}
+
+void SeatMapMerge::Diff(const FSeatMapSnapshot& Old, const FSeatMapSnapshot& New,
+                        TArray<FSeatMapDifference>& OutDifferences)
+{
+	OutDifferences.Reset();
+	DiffEntries(Old.Templates, New.Templates, true, OutDifferences);
+	DiffEntries(Old.Meshes, New.Meshes, false, OutDifferences);
+}
+
+FSeatMapSnapshot SeatMapMerge::Merge(const FSeatMapSnapshot& Base, const FSeatMapSnapshot& Local,
+                                     const FSeatMapSnapshot& Remote, TArray<FSeatMapDifference>& OutConflicts)
+{
+	OutConflicts.Reset();
+
+	FSeatMapSnapshot Merged;
+	MergeEntries(Base.Templates, Local.Templates, Remote.Templates, true, Merged.Templates, OutConflicts);
+	MergeEntries(Base.Meshes, Local.Meshes, Remote.Meshes, false, Merged.Meshes, OutConflicts);
+	return Merged;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,109 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SeatSocket/SeatSocket.h"
+
+/** Fields of a seat the diff compares, the seat without its object. */
+struct FSeatMapSeat
+{
+	FName Name;
+	FVector RelativeLocation = FVector::ZeroVector;
+	FRotator RelativeRotation = FRotator::ZeroRotator;
+	ESeatType SeatType = ESeatType::Normal;
+	EPosture Posture = EPosture::StandUp;
+	float YawScope = 0.f;
+	float PitchScope = 0.f;
+
+	bool operator==(const FSeatMapSeat& Other) const;
+	bool operator!=(const FSeatMapSeat& Other) const { return !(*this == Other); }
+};
+
+/** Template a mesh uses and where it places it. */
+struct FSeatMapTemplateUse
+{
+	FName Template;
+	FTransform Transform = FTransform::Identity;
+
+	bool operator==(const FSeatMapTemplateUse& Other) const
+	{
+		return Template == Other.Template && Transform.Equals(Other.Transform, 0.f);
+	}
+};
+
+/** A seat's name and how many seats of the same mesh or template have that name before it. */
+struct FSeatMapSeatKey
+{
+	FName Name;
+	int32 Occurrence = 0;
+
+	bool operator==(const FSeatMapSeatKey& Other) const { return Name == Other.Name && Occurrence == Other.Occurrence; }
+
+	friend uint32 GetTypeHash(const FSeatMapSeatKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Name), GetTypeHash(Key.Occurrence));
+	}
+};
+
+/** Seats of a mesh or template by name. */
+struct FSeatMapEntry
+{
+	FSeatMapTemplateUse TemplateUse;
+	TMap<FSeatMapSeatKey, FSeatMapSeat> Seats;
+};
+
+/**
+ * Seat data of a seat map detached from its objects, so versions of the asset can be compared and merged
+ * per mesh and seat name. Seats sharing a name are told apart by their order, so no seat is lost.
+ */
+struct FSeatMapSnapshot
+{
+	TMap<FSoftObjectPath, FSeatMapEntry> Meshes;
+	TMap<FName, FSeatMapEntry> Templates;
+
+	static FSeatMapSnapshot Capture(const USeatMap* SeatMap);
+
+	/**
+	 * Changes the seats and templates of the seat map to these. Seats that did not change keep their objects,
+	 * so open editors keep their selection and undo records only the changes. Transactions are up to the caller.
+	 */
+	void ApplyTo(USeatMap* SeatMap) const;
+};
+
+enum class ESeatMapChange : uint8
+{
+	Added,
+	Removed,
+	Modified
+};
+
+/** A mesh, template or seat that differs between two versions. */
+struct FSeatMapDifference
+{
+	/** Mesh path, or the template name for template seats. */
+	FString Owner;
+	bool bTemplate = false;
+
+	/** None where the mesh or template itself was added or removed, or a mesh changed its template. */
+	FName SeatName;
+
+	ESeatMapChange Change = ESeatMapChange::Modified;
+
+	FText ToText() const;
+};
+
+namespace SeatMapMerge
+{
+	/** Differences from Old to New. */
+	void Diff(const FSeatMapSnapshot& Old, const FSeatMapSnapshot& New, TArray<FSeatMapDifference>& OutDifferences);
+
+	/**
+	 * Three way merge per mesh, template and seat name. A change made on one side only is taken, the same change
+	 * on both sides is taken once. Different changes of the same seat or template use conflict and keep Local.
+	 *
+	 * @param OutConflicts		Where both sides changed the same thing differently, Change tells what Local did.
+	 */
+	FSeatMapSnapshot Merge(const FSeatMapSnapshot& Base, const FSeatMapSnapshot& Local, const FSeatMapSnapshot& Remote,
+	                       TArray<FSeatMapDifference>& OutConflicts);
+}
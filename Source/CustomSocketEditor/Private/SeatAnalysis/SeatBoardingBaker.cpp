@@ -0,0 +1,281 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatBoardingBaker.h"
+
+#include "SeatDerivedData.h"
+#include "SeatMeshCollision.h"
+#include "SeatSettings.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "SeatSocket/SeatSocket.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SeatBoardingBaker
+{
+	/** Bump whenever the path search changes so baked paths are recomputed. */
+	const int32 Version = 4;
+
+	const TCHAR* const DerivedDataTag = TEXT("BOARD");
+
+	/** Room between the mesh and the anchors, and above the mesh for paths over it. */
+	const float Margin = 50.f;
+
+	struct FMeshJob
+	{
+		TSoftObjectPtr<UStaticMesh> StaticMesh;
+		FString BakeKey;
+		FSeatMeshCollision Collision;
+		FBox Bounds;
+		TArray<FName> SeatNames;
+		TArray<FVector> SeatLocations;
+		TArray<FSeatBoardingPath> Paths;
+	};
+
+	void SerializePaths(FArchive& Ar, TArray<FSeatBoardingPath>& Paths)
+	{
+		int32 NumPaths = Paths.Num();
+		Ar << NumPaths;
+		if (Ar.IsLoading())
+		{
+			// Every path takes more than a byte, a larger count means the data is corrupt.
+			if (NumPaths < 0 || NumPaths > Ar.TotalSize())
+			{
+				Ar.SetError();
+				return;
+			}
+			Paths.SetNum(NumPaths);
+		}
+
+		for (FSeatBoardingPath& Path : Paths)
+		{
+			Ar << Path.SeatName << Path.EntryPath << Path.ExitPath;
+		}
+	}
+
+	float GetPathLength(const TArray<FVector>& Path)
+	{
+		float Length = 0.f;
+		for (int32 PointIndex = 1; PointIndex < Path.Num(); ++PointIndex)
+		{
+			Length += FVector::Dist(Path[PointIndex - 1], Path[PointIndex]);
+		}
+		return Length;
+	}
+
+	/**
+	 * Shortest clear way in from each side of the mesh: straight to the seat, up beside the mesh and across,
+	 * or over the top. Anchors are on the ground beside the bounds, level with the seat along that side.
+	 */
+	void BakeSeat(const FMeshJob& Job, const FVector& SeatLocation, float Radius, float Clearance,
+	              float SegmentHeight, FSeatBoardingPath& OutPath)
+	{
+		const FBox& Bounds = Job.Bounds;
+		const FVector Target = SeatLocation + FVector(0.f, 0.f, Clearance);
+
+		// A hull around the seat is a cabin modelled from the outside, its doors are not in the collision.
+		const FVector Center = Target + FVector(0.f, 0.f, SegmentHeight * 0.5f);
+		const TBitArray<> CabinHulls = Job.Collision.FindEnclosingHulls(Center);
+		const float Offset = Radius + Margin;
+		const float GroundZ = Bounds.Min.Z + Clearance;
+		const float TopZ = Bounds.Max.Z + Clearance + Margin;
+		const float LateralX = FMath::Clamp(SeatLocation.X, Bounds.Min.X, Bounds.Max.X);
+		const float LateralY = FMath::Clamp(SeatLocation.Y, Bounds.Min.Y, Bounds.Max.Y);
+
+		const FVector Anchors[] = {
+			FVector(Bounds.Max.X + Offset, LateralY, GroundZ),
+			FVector(Bounds.Min.X - Offset, LateralY, GroundZ),
+			FVector(LateralX, Bounds.Max.Y + Offset, GroundZ),
+			FVector(LateralX, Bounds.Min.Y - Offset, GroundZ)
+		};
+
+		TArray<FVector> BestPaths[UE_ARRAY_COUNT(Anchors)];
+		float BestLengths[UE_ARRAY_COUNT(Anchors)];
+		for (int32 Side = 0; Side < UE_ARRAY_COUNT(Anchors); ++Side)
+		{
+			const FVector& Anchor = Anchors[Side];
+			const TArray<FVector> Candidates[] = {
+				{Anchor, Target},
+				{Anchor, FVector(Anchor.X, Anchor.Y, Target.Z), Target},
+				{Anchor, FVector(Anchor.X, Anchor.Y, TopZ), FVector(Target.X, Target.Y, TopZ), Target}
+			};
+
+			BestLengths[Side] = MAX_flt;
+			for (const TArray<FVector>& Candidate : Candidates)
+			{
+				const float Length = GetPathLength(Candidate);
+				if (Length < BestLengths[Side] &&
+					FSeatBoardingBaker::IsPathClear(Job.Collision, Candidate, Radius, SegmentHeight, &CabinHulls))
+				{
+					BestPaths[Side] = Candidate;
+					BestLengths[Side] = Length;
+				}
+			}
+		}
+
+		int32 EntrySide = INDEX_NONE;
+		int32 ExitSide = INDEX_NONE;
+		for (int32 Side = 0; Side < UE_ARRAY_COUNT(Anchors); ++Side)
+		{
+			if (BestPaths[Side].Num() == 0)
+				continue;
+
+			if (EntrySide == INDEX_NONE || BestLengths[Side] < BestLengths[EntrySide])
+			{
+				ExitSide = EntrySide;
+				EntrySide = Side;
+			}
+			else if (ExitSide == INDEX_NONE || BestLengths[Side] < BestLengths[ExitSide])
+			{
+				ExitSide = Side;
+			}
+		}
+
+		if (EntrySide == INDEX_NONE)
+			return;
+
+		// Leaving on another side keeps the way clear for the next occupant, one way only means back out.
+		OutPath.EntryPath = BestPaths[EntrySide];
+		OutPath.ExitPath = BestPaths[ExitSide != INDEX_NONE ? ExitSide : EntrySide];
+		Algo::Reverse(OutPath.ExitPath);
+	}
+}
+
+FSeatBoardingBaker& FSeatBoardingBaker::Get()
+{
+	static FSeatBoardingBaker Baker;
+	return Baker;
+}
+
+bool FSeatBoardingBaker::IsPathClear(const FSeatMeshCollision& Collision, const TArray<FVector>& Path, float Radius,
+                                     float SegmentHeight, const TBitArray<>* IgnoredHulls)
+{
+	for (int32 PointIndex = 1; PointIndex < Path.Num(); ++PointIndex)
+	{
+		if (Collision.SweepUprightCapsule(Path[PointIndex - 1], Path[PointIndex], Radius, SegmentHeight, IgnoredHulls))
+			return false;
+	}
+	return true;
+}
+
+FSeatBoardingBakeStats FSeatBoardingBaker::BakeSeatMap(USeatMap* SeatMap)
+{
+	using namespace SeatBoardingBaker;
+
+	check(IsInGameThread());
+
+	FSeatBoardingBakeStats Stats;
+	if (!SeatMap)
+		return Stats;
+
+	// Occupants walk in standing, the capsule is the one validation uses for standing seats. Paths run through
+	// the center of its bottom sphere, the whole capsule up to head height has to stay clear.
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+	const FSeatPostureShape& Shape = Settings->GetPostureShape(EPosture::StandUp);
+	const float Radius = FMath::Max(Shape.Radius - Settings->ValidationSkin, 1.f);
+	const float Clearance = Radius + Settings->ValidationSkin;
+	const float SegmentHeight = FMath::Max(2.f * (Shape.HalfHeight - Clearance), 0.f);
+
+	for (auto It = SeatMap->Boarding.CreateIterator(); It; ++It)
+	{
+		if (!SeatMap->SeatMap.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// Collision and seats are gathered on the game thread, the path searches of all seats run in parallel.
+	TIndirectArray<FMeshJob> Jobs;
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+	{
+		UStaticMesh* StaticMesh = Pair.Key.LoadSynchronous();
+		if (!StaticMesh)
+			continue;
+
+		const FString BakeKey = FString::Printf(TEXT("%d_%s_%016llx_%.2f%s"), Version,
+		                                        *FSeatMeshCollision::MakeGeometryKey(StaticMesh),
+		                                        SeatMap->ComputeSeatsHash(Pair.Key), Settings->ValidationSkin,
+		                                        *Settings->GetPostureShapesKey());
+
+		const FSeatMeshBoarding* Existing = SeatMap->Boarding.Find(Pair.Key);
+		if (Existing && Existing->BakeKey == BakeKey)
+			continue;
+
+		TArray<uint8> DerivedData;
+		if (SeatDerivedData::Get(DerivedDataTag, BakeKey, DerivedData))
+		{
+			FSeatMeshBoarding MeshBoarding;
+			MeshBoarding.BakeKey = BakeKey;
+
+			FMemoryReader Reader(DerivedData);
+			SerializePaths(Reader, MeshBoarding.Paths);
+			if (!Reader.IsError())
+			{
+				SeatMap->Boarding.Add(Pair.Key, MoveTemp(MeshBoarding));
+				++Stats.NumMeshesFromCache;
+				continue;
+			}
+		}
+
+		FMeshJob* Job = new FMeshJob();
+		Job->StaticMesh = Pair.Key;
+		Job->BakeKey = BakeKey;
+		Job->Collision.Build(StaticMesh);
+		Job->Bounds = StaticMesh->GetBoundingBox();
+
+		TArray<FSeatInstance> Seats;
+		SeatMap->GatherSeats(Pair.Key, Seats);
+		for (const FSeatInstance& Instance : Seats)
+		{
+			Job->SeatNames.Add(Instance.Seat->Name);
+			Job->SeatLocations.Add(Instance.Transform.GetLocation());
+		}
+		Job->Paths.SetNum(Seats.Num());
+
+		Jobs.Add(Job);
+	}
+
+	TArray<TPair<int32, int32>> Tasks;
+	for (int32 JobIndex = 0; JobIndex < Jobs.Num(); ++JobIndex)
+	{
+		for (int32 SeatIndex = 0; SeatIndex < Jobs[JobIndex].Paths.Num(); ++SeatIndex)
+		{
+			Tasks.Emplace(JobIndex, SeatIndex);
+		}
+	}
+
+	ParallelFor(Tasks.Num(), [&](int32 TaskIndex)
+	{
+		FMeshJob& Job = Jobs[Tasks[TaskIndex].Key];
+		const int32 SeatIndex = Tasks[TaskIndex].Value;
+
+		FSeatBoardingPath& Path = Job.Paths[SeatIndex];
+		Path.SeatName = Job.SeatNames[SeatIndex];
+		BakeSeat(Job, Job.SeatLocations[SeatIndex], Radius, Clearance, SegmentHeight, Path);
+	});
+
+	for (FMeshJob& Job : Jobs)
+	{
+		TArray<uint8> DerivedData;
+		FMemoryWriter Writer(DerivedData);
+		SerializePaths(Writer, Job.Paths);
+		SeatDerivedData::Put(DerivedDataTag, Job.BakeKey, DerivedData);
+
+		FSeatMeshBoarding& MeshBoarding = SeatMap->Boarding.FindOrAdd(Job.StaticMesh);
+		MeshBoarding.BakeKey = Job.BakeKey;
+		MeshBoarding.Paths = MoveTemp(Job.Paths);
+		++Stats.NumMeshesBaked;
+	}
+
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeatMeshBoarding>& Pair : SeatMap->Boarding)
+	{
+		for (const FSeatBoardingPath& Path : Pair.Value.Paths)
+		{
+			Stats.NumUnreachableSeats += Path.EntryPath.Num() == 0 ? 1 : 0;
+		}
+	}
+
+	return Stats;
+}
@@ -0,0 +1,45 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSeatMeshCollision;
+class USeatMap;
+
+/** Outcome of FSeatBoardingBaker::BakeSeatMap. */
+struct FSeatBoardingBakeStats
+{
+	/** Meshes whose paths were computed, and those whose paths came from the derived data cache. */
+	int32 NumMeshesBaked = 0;
+	int32 NumMeshesFromCache = 0;
+
+	/** Seats of the seat map without a way in. */
+	int32 NumUnreachableSeats = 0;
+};
+
+/**
+ * Bakes entry and exit paths for seats, so boarding at runtime is a lookup plus the vehicle transform.
+ * Every seat gets an anchor on the ground beside the mesh bounds and a few waypoints that keep a standing
+ * occupant clear of the mesh collision. Seats of all meshes are baked in parallel, paths are cached
+ * per mesh geometry and seat data in the derived data cache.
+ */
+class FSeatBoardingBaker
+{
+public:
+	static FSeatBoardingBaker& Get();
+
+	/**
+	 * Brings USeatMap::Boarding up to date, meshes whose geometry, seats and settings are unchanged are skipped.
+	 * Transactions and dirtying the package are up to the caller.
+	 */
+	FSeatBoardingBakeStats BakeSeatMap(USeatMap* SeatMap);
+
+	/**
+	 * Whether a standing occupant can walk the path without touching the collision.
+	 * Path points are the centers of the capsule's bottom sphere, SegmentHeight the length of its inner segment.
+	 * IgnoredHulls are left out, such as the cabin around the seat the path leads to.
+	 */
+	static bool IsPathClear(const FSeatMeshCollision& Collision, const TArray<FVector>& Path, float Radius,
+	                        float SegmentHeight, const TBitArray<>* IgnoredHulls = nullptr);
+};
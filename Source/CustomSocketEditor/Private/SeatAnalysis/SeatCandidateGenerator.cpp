@@ -0,0 +1,301 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatCandidateGenerator.h"
+
+#include "CustomSocketStats.h"
+#include "SeatDerivedData.h"
+#include "SeatMeshCollision.h"
+#include "SeatSettings.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SeatCandidateGenerator
+{
+	/** Bump whenever the generation changes so cached candidates are recomputed. */
+	const int32 Version = 1;
+
+	/** Surfaces closer than this in height fall into the same cell. */
+	const float CellHeight = 10.f;
+
+	const int32 TrianglesPerTask = 4096;
+
+	const TCHAR* const DerivedDataTag = TEXT("CAND");
+
+	void SerializeCandidates(FArchive& Ar, TArray<FSeatCandidate>& Candidates)
+	{
+		int32 NumCandidates = Candidates.Num();
+		Ar << NumCandidates;
+		if (Ar.IsLoading())
+		{
+			if (NumCandidates < 0 || NumCandidates > Ar.TotalSize())
+			{
+				Ar.SetError();
+				return;
+			}
+			Candidates.SetNum(NumCandidates);
+		}
+
+		for (FSeatCandidate& Candidate : Candidates)
+		{
+			Ar << Candidate.Transform << Candidate.Posture << Candidate.SupportArea;
+		}
+	}
+
+	/** Upward facing surface area that falls into one grid cell. */
+	struct FSurfaceCell
+	{
+		float Area = 0.f;
+		FVector WeightedPosition = FVector::ZeroVector;
+
+		void Add(const FVector& Position, float InArea)
+		{
+			Area += InArea;
+			WeightedPosition += Position * InArea;
+		}
+
+		void Merge(const FSurfaceCell& Other)
+		{
+			Area += Other.Area;
+			WeightedPosition += Other.WeightedPosition;
+		}
+	};
+
+	using FSurfaceGrid = TMap<FIntVector, FSurfaceCell>;
+
+	FIntVector GetCell(const FVector& Position, float CellSize)
+	{
+		return FIntVector(FMath::FloorToInt(Position.X / CellSize),
+		                  FMath::FloorToInt(Position.Y / CellSize),
+		                  FMath::FloorToInt(Position.Z / CellHeight));
+	}
+
+	/** Whether any surface supports the position, allowing one cell of height difference. */
+	bool HasSurface(const FSurfaceGrid& Grid, const FVector& Position, float CellSize)
+	{
+		const FIntVector Cell = GetCell(Position, CellSize);
+		return Grid.Contains(Cell) || Grid.Contains(Cell + FIntVector(0, 0, 1)) || Grid.Contains(Cell - FIntVector(0, 0, 1));
+	}
+
+	/** Splits the triangle into sub triangles smaller than half a cell and adds each one's area at its centroid. */
+	void AddTriangle(FSurfaceGrid& Grid, const FVector& A, const FVector& B, const FVector& C, float Area, float CellSize)
+	{
+		const float LongestEdge = FMath::Sqrt(FMath::Max3(FVector::DistSquared(A, B), FVector::DistSquared(B, C),
+		                                                  FVector::DistSquared(C, A)));
+		const int32 Steps = FMath::Clamp(FMath::CeilToInt(LongestEdge * 2.f / CellSize), 1, 256);
+		const float SampleArea = Area / (Steps * Steps);
+		const FVector StepU = (B - A) / Steps;
+		const FVector StepV = (C - A) / Steps;
+
+		for (int32 U = 0; U < Steps; ++U)
+		{
+			for (int32 V = 0; U + V < Steps; ++V)
+			{
+				const FVector Upright = A + StepU * (U + 1.f / 3.f) + StepV * (V + 1.f / 3.f);
+				Grid.FindOrAdd(GetCell(Upright, CellSize)).Add(Upright, SampleArea);
+
+				if (U + V + 1 < Steps)
+				{
+					const FVector Flipped = A + StepU * (U + 2.f / 3.f) + StepV * (V + 2.f / 3.f);
+					Grid.FindOrAdd(GetCell(Flipped, CellSize)).Add(Flipped, SampleArea);
+				}
+			}
+		}
+	}
+}
+
+FSeatCandidateGenerator& FSeatCandidateGenerator::Get()
+{
+	static FSeatCandidateGenerator Generator;
+	return Generator;
+}
+
+void FSeatCandidateGenerator::Generate(const UStaticMesh* StaticMesh, TArray<FSeatCandidate>& OutCandidates)
+{
+	using namespace SeatCandidateGenerator;
+
+	check(IsInGameThread());
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_GenerateCandidates);
+
+	OutCandidates.Reset();
+	if (!StaticMesh)
+		return;
+
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+	const FSoftObjectPath MeshPath(StaticMesh);
+	const FString CacheKey = FString::Printf(TEXT("%d_%s_%.2f_%.2f%s"), Version,
+	                                         *FSeatMeshCollision::MakeGeometryKey(StaticMesh),
+	                                         Settings->CandidateMaxSlope, Settings->ValidationSkin,
+	                                         *Settings->GetPostureShapesKey());
+	{
+		FScopeLock Lock(&CacheLock);
+		const FCachedCandidates* Cached = Cache.Find(MeshPath);
+		if (Cached && Cached->CacheKey == CacheKey)
+		{
+			OutCandidates = Cached->Candidates;
+			return;
+		}
+	}
+
+	TArray<uint8> DerivedData;
+	if (SeatDerivedData::Get(DerivedDataTag, CacheKey, DerivedData))
+	{
+		FMemoryReader Reader(DerivedData);
+		SerializeCandidates(Reader, OutCandidates);
+		if (!Reader.IsError())
+		{
+			FScopeLock Lock(&CacheLock);
+			FCachedCandidates& Cached = Cache.FindOrAdd(MeshPath);
+			Cached.CacheKey = CacheKey;
+			Cached.Candidates = OutCandidates;
+			return;
+		}
+		OutCandidates.Reset();
+	}
+
+	FSeatMeshCollision Geometry;
+	Geometry.BuildFromRenderData(StaticMesh);
+	const TArray<FVector>& Vertices = Geometry.GetVertices();
+	const TArray<int32>& Indices = Geometry.GetIndices();
+
+	// Cells are as wide as the slimmest occupant, a covered cell is enough footing for one.
+	TArray<TPair<EPosture, FSeatPostureShape>> Postures;
+	float CellSize = MAX_flt;
+	const UEnum* PostureEnum = StaticEnum<EPosture>();
+	for (int32 EnumIndex = 0; EnumIndex < PostureEnum->NumEnums() - 1; ++EnumIndex)
+	{
+		const EPosture Posture = static_cast<EPosture>(PostureEnum->GetValueByIndex(EnumIndex));
+		const FSeatPostureShape& Shape = Settings->GetPostureShape(Posture);
+		Postures.Emplace(Posture, Shape);
+		CellSize = FMath::Min(CellSize, Shape.Radius);
+	}
+	CellSize = FMath::Max(CellSize, 5.f);
+
+	const float MinNormalZ = FMath::Cos(FMath::DegreesToRadians(Settings->CandidateMaxSlope));
+	const int32 NumTriangles = Indices.Num() / 3;
+	const int32 NumTasks = FMath::DivideAndRoundUp(NumTriangles, TrianglesPerTask);
+
+	// Every task rasterizes its triangles into a grid of its own, the grids are merged afterwards.
+	TArray<FSurfaceGrid> TaskGrids;
+	TaskGrids.SetNum(NumTasks);
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
+	{
+		FSurfaceGrid& Grid = TaskGrids[TaskIndex];
+		const int32 LastTriangle = FMath::Min((TaskIndex + 1) * TrianglesPerTask, NumTriangles);
+		for (int32 Triangle = TaskIndex * TrianglesPerTask; Triangle < LastTriangle; ++Triangle)
+		{
+			const FVector& A = Vertices[Indices[Triangle * 3]];
+			const FVector& B = Vertices[Indices[Triangle * 3 + 1]];
+			const FVector& C = Vertices[Indices[Triangle * 3 + 2]];
+
+			const FVector Normal = (C - A) ^ (B - A);
+			const float DoubleArea = Normal.Size();
+			if (DoubleArea <= KINDA_SMALL_NUMBER || Normal.Z < MinNormalZ * DoubleArea)
+				continue;
+
+			AddTriangle(Grid, A, B, C, DoubleArea * 0.5f, CellSize);
+		}
+	});
+
+	FSurfaceGrid Surface;
+	for (const FSurfaceGrid& Grid : TaskGrids)
+	{
+		for (const TPair<FIntVector, FSurfaceCell>& Cell : Grid)
+		{
+			Surface.FindOrAdd(Cell.Key).Merge(Cell.Value);
+		}
+	}
+	TaskGrids.Empty();
+
+	// Only cells that are mostly covered can carry a seat.
+	TArray<const FSurfaceCell*> SupportCells;
+	for (const TPair<FIntVector, FSurfaceCell>& Cell : Surface)
+	{
+		if (Cell.Value.Area >= CellSize * CellSize * 0.5f)
+		{
+			SupportCells.Add(&Cell.Value);
+		}
+	}
+
+	// The capsule is lifted and shrunk by the skin so the supporting surface itself does not count as a hit.
+	const float Skin = Settings->ValidationSkin;
+	TArray<TOptional<FSeatCandidate>> CellCandidates;
+	CellCandidates.SetNum(SupportCells.Num());
+	ParallelFor(SupportCells.Num(), [&](int32 CellIndex)
+	{
+		const FSurfaceCell& Cell = *SupportCells[CellIndex];
+		const FVector Location = Cell.WeightedPosition / Cell.Area;
+		const FTransform SeatTransform(Location + FVector(0.f, 0.f, Skin));
+
+		for (const TPair<EPosture, FSeatPostureShape>& Posture : Postures)
+		{
+			FVector Start;
+			FVector End;
+			Posture.Value.GetCapsuleSegment(SeatTransform, Start, End);
+
+			// Lying occupants need footing along their whole length.
+			if (!HasSurface(Surface, FVector(Start.X, Start.Y, Location.Z), CellSize) ||
+				!HasSurface(Surface, FVector(End.X, End.Y, Location.Z), CellSize))
+				continue;
+
+			FVector Contact;
+			if (Geometry.OverlapCapsule(Start, End, FMath::Max(Posture.Value.Radius - Skin, 1.f), Contact))
+				continue;
+
+			FSeatCandidate Candidate;
+			Candidate.Transform = FTransform(Location);
+			Candidate.Posture = Posture.Key;
+			Candidate.SupportArea = Cell.Area;
+			CellCandidates[CellIndex] = Candidate;
+			break;
+		}
+	});
+
+	TArray<FSeatCandidate> Candidates;
+	for (const TOptional<FSeatCandidate>& Candidate : CellCandidates)
+	{
+		if (Candidate.IsSet())
+		{
+			Candidates.Add(Candidate.GetValue());
+		}
+	}
+	Candidates.Sort([](const FSeatCandidate& A, const FSeatCandidate& B)
+	{
+		return A.SupportArea > B.SupportArea;
+	});
+
+	// Neighbouring cells propose overlapping seats, keep the best supported one of each overlap.
+	for (const FSeatCandidate& Candidate : Candidates)
+	{
+		const float Radius = Settings->GetPostureShape(Candidate.Posture).Radius;
+		const bool bOverlapsAccepted = OutCandidates.ContainsByPredicate([&](const FSeatCandidate& Accepted)
+		{
+			const float MinDistance = Radius + Settings->GetPostureShape(Accepted.Posture).Radius;
+			return FVector::DistSquared(Accepted.Transform.GetLocation(), Candidate.Transform.GetLocation()) <
+				FMath::Square(MinDistance);
+		});
+
+		if (!bOverlapsAccepted)
+		{
+			OutCandidates.Add(Candidate);
+		}
+	}
+
+	DerivedData.Reset();
+	FMemoryWriter Writer(DerivedData);
+	SerializeCandidates(Writer, OutCandidates);
+	SeatDerivedData::Put(DerivedDataTag, CacheKey, DerivedData);
+
+	FScopeLock Lock(&CacheLock);
+	FCachedCandidates& Cached = Cache.FindOrAdd(MeshPath);
+	Cached.CacheKey = CacheKey;
+	Cached.Candidates = OutCandidates;
+}
+
+void FSeatCandidateGenerator::ClearCache()
+{
+	FScopeLock Lock(&CacheLock);
+	Cache.Empty();
+}
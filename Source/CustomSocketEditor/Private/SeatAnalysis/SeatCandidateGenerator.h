@@ -0,0 +1,49 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SeatSocket/SeatSocket.h"
+
+class UStaticMesh;
+
+/** A proposed seat in mesh space. */
+struct FSeatCandidate
+{
+	FTransform Transform;
+	EPosture Posture = EPosture::StandUp;
+
+	/** Upward facing surface area under the seat. */
+	float SupportArea = 0.f;
+};
+
+/**
+ * Proposes seats on flat, upward facing surfaces of a mesh that leave room for a posture's occupant capsule.
+ * Triangles are processed in parallel, results are cached per mesh geometry and posture settings.
+ */
+class FSeatCandidateGenerator
+{
+public:
+	static FSeatCandidateGenerator& Get();
+
+	/**
+	 * Analyzes the render triangles of the mesh's collision LOD.
+	 * At most one candidate is proposed per spot, using the first posture in EPosture order that fits.
+	 *
+	 * @param OutCandidates		Candidates sorted by support area, largest first.
+	 */
+	void Generate(const UStaticMesh* StaticMesh, TArray<FSeatCandidate>& OutCandidates);
+
+	/** Forgets all cached candidates. */
+	void ClearCache();
+
+private:
+	struct FCachedCandidates
+	{
+		FString CacheKey;
+		TArray<FSeatCandidate> Candidates;
+	};
+
+	FCriticalSection CacheLock;
+	TMap<FSoftObjectPath, FCachedCandidates> Cache;
+};
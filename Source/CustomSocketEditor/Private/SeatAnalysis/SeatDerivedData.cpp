@@ -0,0 +1,27 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatDerivedData.h"
+
+#include "DerivedDataCacheInterface.h"
+
+namespace SeatDerivedData
+{
+	/** Bump to drop every cached result, analyses bump their own version for their own results. */
+	const TCHAR* const Version = TEXT("1");
+
+	FString MakeKey(const TCHAR* Analysis, const FString& CacheKey)
+	{
+		return FDerivedDataCacheInterface::BuildCacheKey(*FString::Printf(TEXT("SEAT%s"), Analysis), Version, *CacheKey);
+	}
+
+	bool Get(const TCHAR* Analysis, const FString& CacheKey, TArray<uint8>& OutData)
+	{
+		return GetDerivedDataCacheRef().GetSynchronous(*MakeKey(Analysis, CacheKey), OutData, CacheKey);
+	}
+
+	void Put(const TCHAR* Analysis, const FString& CacheKey, TArrayView<const uint8> Data)
+	{
+		GetDerivedDataCacheRef().Put(*MakeKey(Analysis, CacheKey), Data, CacheKey);
+	}
+}
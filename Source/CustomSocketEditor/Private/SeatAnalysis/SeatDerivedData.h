@@ -0,0 +1,24 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Per mesh seat analysis results in the derived data cache. Results outlive the editor session,
+ * commandlets reuse what the editor computed and a shared DDC hands them to the whole team.
+ * Keys name the analysis and must identify the mesh geometry, seat data, settings and algorithm version used.
+ */
+namespace SeatDerivedData
+{
+	/**
+	 * Fetches a result stored by Put.
+	 *
+	 * @param Analysis		Short tag of the analysis, part of the DDC key.
+	 * @param CacheKey		Everything the result was computed from.
+	 * @return				FALSE if no cache has the result.
+	 */
+	bool Get(const TCHAR* Analysis, const FString& CacheKey, TArray<uint8>& OutData);
+
+	void Put(const TCHAR* Analysis, const FString& CacheKey, TArrayView<const uint8> Data);
+}
@@ -0,0 +1,228 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatFireArcBaker.h"
+
+#include "SeatBlob.h"
+#include "SeatDerivedData.h"
+#include "SeatMeshCollision.h"
+#include "SeatSettings.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "SeatSocket/SeatSocket.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SeatFireArcBaker
+{
+	/** Bump whenever the tracing changes so baked arcs are recomputed. */
+	const int32 Version = 2;
+
+	const TCHAR* const DerivedDataTag = TEXT("FIRE");
+
+	/** Rays per cell along each axis, a cell is only clear if all of its rays are. */
+	const int32 RaysPerCellAxis = 2;
+
+	struct FSeatJob
+	{
+		FName SeatName;
+		FTransform Transform;
+		float YawScope;
+		float PitchScope;
+	};
+
+	struct FMeshJob
+	{
+		TSoftObjectPtr<UStaticMesh> StaticMesh;
+		FString BakeKey;
+		FSeatMeshCollision Collision;
+
+		/** Long enough for any ray to leave the mesh bounds. */
+		float RayLength;
+
+		TArray<FSeatJob> Seats;
+		TArray<FSeatFireArc> Arcs;
+	};
+
+	void SerializeArcs(FArchive& Ar, TArray<FSeatFireArc>& Arcs)
+	{
+		int32 NumArcs = Arcs.Num();
+		Ar << NumArcs;
+		if (Ar.IsLoading())
+		{
+			// Every arc takes more than a byte, a larger count means the data is corrupt.
+			if (NumArcs < 0 || NumArcs > Ar.TotalSize())
+			{
+				Ar.SetError();
+				return;
+			}
+			Arcs.SetNum(NumArcs);
+		}
+
+		for (FSeatFireArc& Arc : Arcs)
+		{
+			Ar << Arc.SeatName << Arc.Origin << Arc.VisibleCells;
+		}
+	}
+
+	void BakeSeat(const FMeshJob& Job, const FSeatJob& Seat, FSeatFireArc& OutArc)
+	{
+		using namespace SeatBlob;
+
+		OutArc.SeatName = Seat.SeatName;
+		OutArc.VisibleCells.SetNumZeroed(FireArcWords);
+
+		// A hull around the seat is a cabin modelled from the outside, its windows are not in the collision.
+		const TBitArray<> CabinHulls = Job.Collision.FindEnclosingHulls(OutArc.Origin);
+
+		for (int32 YawCell = 0; YawCell < FireArcYawCells; ++YawCell)
+		{
+			for (int32 PitchCell = 0; PitchCell < FireArcPitchCells; ++PitchCell)
+			{
+				bool bVisible = true;
+				for (int32 Ray = 0; bVisible && Ray < RaysPerCellAxis * RaysPerCellAxis; ++Ray)
+				{
+					const float YawSample = YawCell + (Ray % RaysPerCellAxis + 0.5f) / RaysPerCellAxis;
+					const float PitchSample = PitchCell + (Ray / RaysPerCellAxis + 0.5f) / RaysPerCellAxis;
+					const FVector Direction = Seat.Transform.TransformVectorNoScale(
+						GetFireArcDirection(Seat.YawScope, Seat.PitchScope, YawSample, PitchSample));
+					bVisible = !Job.Collision.LineTrace(OutArc.Origin, OutArc.Origin + Direction * Job.RayLength,
+					                                    &CabinHulls);
+				}
+
+				if (bVisible)
+				{
+					const int32 Cell = YawCell * FireArcPitchCells + PitchCell;
+					OutArc.VisibleCells[Cell >> 5] |= 1u << (Cell & 31);
+				}
+			}
+		}
+	}
+}
+
+FSeatFireArcBaker& FSeatFireArcBaker::Get()
+{
+	static FSeatFireArcBaker Baker;
+	return Baker;
+}
+
+FSeatFireArcBakeStats FSeatFireArcBaker::BakeSeatMap(USeatMap* SeatMap)
+{
+	using namespace SeatFireArcBaker;
+
+	check(IsInGameThread());
+
+	FSeatFireArcBakeStats Stats;
+	if (!SeatMap)
+		return Stats;
+
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+
+	for (auto It = SeatMap->FireArcs.CreateIterator(); It; ++It)
+	{
+		if (!SeatMap->SeatMap.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// Collision and seats are gathered on the game thread, the traces of all seats run in parallel.
+	TIndirectArray<FMeshJob> Jobs;
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+	{
+		UStaticMesh* StaticMesh = Pair.Key.LoadSynchronous();
+		if (!StaticMesh)
+			continue;
+
+		const FString BakeKey = FString::Printf(TEXT("%d_%d_%d_%s_%016llx%s"), Version, SeatBlob::FireArcYawCells,
+		                                        SeatBlob::FireArcPitchCells,
+		                                        *FSeatMeshCollision::MakeGeometryKey(StaticMesh),
+		                                        SeatMap->ComputeSeatsHash(Pair.Key), *Settings->GetPostureShapesKey());
+
+		const FSeatMeshFireArcs* Existing = SeatMap->FireArcs.Find(Pair.Key);
+		if (Existing && Existing->BakeKey == BakeKey)
+			continue;
+
+		TArray<uint8> DerivedData;
+		if (SeatDerivedData::Get(DerivedDataTag, BakeKey, DerivedData))
+		{
+			FSeatMeshFireArcs MeshFireArcs;
+			MeshFireArcs.BakeKey = BakeKey;
+
+			FMemoryReader Reader(DerivedData);
+			SerializeArcs(Reader, MeshFireArcs.Arcs);
+			if (!Reader.IsError())
+			{
+				SeatMap->FireArcs.Add(Pair.Key, MoveTemp(MeshFireArcs));
+				++Stats.NumMeshesFromCache;
+				continue;
+			}
+		}
+
+		FMeshJob* Job = new FMeshJob();
+		Job->StaticMesh = Pair.Key;
+		Job->BakeKey = BakeKey;
+		Job->Collision.Build(StaticMesh);
+		Job->RayLength = StaticMesh->GetBoundingBox().GetSize().Size() + 1.f;
+
+		TArray<FSeatInstance> Seats;
+		SeatMap->GatherSeats(Pair.Key, Seats);
+		for (const FSeatInstance& Instance : Seats)
+		{
+			if (Instance.Seat->SeatType != ESeatType::Fireable)
+				continue;
+
+			FSeatJob& Seat = Job->Seats.AddDefaulted_GetRef();
+			Seat.SeatName = Instance.Seat->Name;
+			Seat.Transform = Instance.Transform;
+			Seat.YawScope = Instance.Seat->YawScope;
+			Seat.PitchScope = Instance.Seat->PitchScope;
+
+			FSeatFireArc& Arc = Job->Arcs.AddDefaulted_GetRef();
+			Arc.Origin = Instance.Transform.TransformPosition(
+				FVector(0.f, 0.f, Settings->GetPostureShape(Instance.Seat->Posture).GetEyeHeight()));
+		}
+
+		Jobs.Add(Job);
+	}
+
+	TArray<TPair<int32, int32>> Tasks;
+	for (int32 JobIndex = 0; JobIndex < Jobs.Num(); ++JobIndex)
+	{
+		for (int32 SeatIndex = 0; SeatIndex < Jobs[JobIndex].Seats.Num(); ++SeatIndex)
+		{
+			Tasks.Emplace(JobIndex, SeatIndex);
+		}
+	}
+
+	ParallelFor(Tasks.Num(), [&](int32 TaskIndex)
+	{
+		FMeshJob& Job = Jobs[Tasks[TaskIndex].Key];
+		const int32 SeatIndex = Tasks[TaskIndex].Value;
+		BakeSeat(Job, Job.Seats[SeatIndex], Job.Arcs[SeatIndex]);
+	});
+
+	for (FMeshJob& Job : Jobs)
+	{
+		TArray<uint8> DerivedData;
+		FMemoryWriter Writer(DerivedData);
+		SerializeArcs(Writer, Job.Arcs);
+		SeatDerivedData::Put(DerivedDataTag, Job.BakeKey, DerivedData);
+
+		FSeatMeshFireArcs& MeshFireArcs = SeatMap->FireArcs.FindOrAdd(Job.StaticMesh);
+		MeshFireArcs.BakeKey = Job.BakeKey;
+		MeshFireArcs.Arcs = MoveTemp(Job.Arcs);
+		++Stats.NumMeshesBaked;
+	}
+
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeatMeshFireArcs>& Pair : SeatMap->FireArcs)
+	{
+		for (const FSeatFireArc& Arc : Pair.Value.Arcs)
+		{
+			const bool bBlocked = !Arc.VisibleCells.ContainsByPredicate([](uint32 Word) { return Word != 0; });
+			Stats.NumBlockedSeats += bBlocked ? 1 : 0;
+		}
+	}
+
+	return Stats;
+}
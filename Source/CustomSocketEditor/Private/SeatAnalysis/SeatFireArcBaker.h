@@ -0,0 +1,36 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USeatMap;
+
+/** Outcome of FSeatFireArcBaker::BakeSeatMap. */
+struct FSeatFireArcBakeStats
+{
+	/** Meshes whose arcs were traced, and those whose arcs came from the derived data cache. */
+	int32 NumMeshesBaked = 0;
+	int32 NumMeshesFromCache = 0;
+
+	/** Fireable seats of the seat map whose mesh blocks every direction of their scopes. */
+	int32 NumBlockedSeats = 0;
+};
+
+/**
+ * Bakes which directions of a fireable seat's yaw and pitch scopes are not blocked by its own mesh,
+ * so the runtime answers "can this seat fire there" with a bit lookup instead of traces.
+ * Rays are traced from the occupant's eyes against the mesh collision, a few per cell of SeatBlob's
+ * firing arc grid. Seats of all meshes are traced in parallel, arcs are cached like boarding paths.
+ */
+class FSeatFireArcBaker
+{
+public:
+	static FSeatFireArcBaker& Get();
+
+	/**
+	 * Brings USeatMap::FireArcs up to date, meshes whose geometry, seats and settings are unchanged are skipped.
+	 * Transactions and dirtying the package are up to the caller.
+	 */
+	FSeatFireArcBakeStats BakeSeatMap(USeatMap* SeatMap);
+};
@@ -0,0 +1,520 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMeshCollision.h"
+
+#include "StaticMeshResources.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+
+namespace SeatMeshCollision
+{
+	/** Nodes with at most this many triangles are not split further. */
+	const int32 MaxLeafTriangles = 8;
+
+	/** Whether the segment passes through the box, the slab test. */
+	bool SegmentIntersectsBox(const FVector& Start, const FVector& Delta, const FBox& Box)
+	{
+		float EntryTime = 0.f;
+		float ExitTime = 1.f;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMath::IsNearlyZero(Delta[Axis]))
+			{
+				if (Start[Axis] < Box.Min[Axis] || Start[Axis] > Box.Max[Axis])
+					return false;
+
+				continue;
+			}
+
+			float AxisEntry = (Box.Min[Axis] - Start[Axis]) / Delta[Axis];
+			float AxisExit = (Box.Max[Axis] - Start[Axis]) / Delta[Axis];
+			if (AxisEntry > AxisExit)
+			{
+				Swap(AxisEntry, AxisExit);
+			}
+
+			EntryTime = FMath::Max(EntryTime, AxisEntry);
+			ExitTime = FMath::Min(ExitTime, AxisExit);
+			if (EntryTime > ExitTime)
+				return false;
+		}
+		return true;
+	}
+
+	/** Distance between a segment and a triangle, OutTrianglePoint is the closest point on the triangle. */
+	float SegmentTriangleDistance(const FVector& Start, const FVector& End, const FVector& A, const FVector& B,
+	                              const FVector& C, FVector& OutTrianglePoint)
+	{
+		FVector Intersection;
+		FVector Normal;
+		if (FMath::SegmentTriangleIntersection(Start, End, A, B, C, Intersection, Normal))
+		{
+			OutTrianglePoint = Intersection;
+			return 0.f;
+		}
+
+		float BestDistance = MAX_flt;
+
+		for (const FVector& Point : {Start, End})
+		{
+			const FVector Closest = FMath::ClosestPointOnTriangleToPoint(Point, A, B, C);
+			const float Distance = FVector::Dist(Point, Closest);
+			if (Distance < BestDistance)
+			{
+				BestDistance = Distance;
+				OutTrianglePoint = Closest;
+			}
+		}
+
+		const FVector Edges[3][2] = {{A, B}, {B, C}, {C, A}};
+		for (const FVector(&Edge)[2] : Edges)
+		{
+			FVector OnSegment;
+			FVector OnEdge;
+			FMath::SegmentDistToSegmentSafe(Start, End, Edge[0], Edge[1], OnSegment, OnEdge);
+			const float Distance = FVector::Dist(OnSegment, OnEdge);
+			if (Distance < BestDistance)
+			{
+				BestDistance = Distance;
+				OutTrianglePoint = OnEdge;
+			}
+		}
+
+		return BestDistance;
+	}
+}
+
+void FSeatMeshCollision::Reset()
+{
+	Vertices.Reset();
+	Indices.Reset();
+	Capsules.Reset();
+	Hulls.Reset();
+	TriangleNodes.Reset();
+	TriangleHulls.Reset();
+}
+
+void FSeatMeshCollision::Build(const UStaticMesh* StaticMesh)
+{
+	Reset();
+
+	if (!StaticMesh)
+		return;
+
+	const UBodySetup* BodySetup = StaticMesh->GetBodySetup();
+
+	const bool bUseComplexAsSimple = BodySetup && BodySetup->CollisionTraceFlag == CTF_UseComplexAsSimple;
+	if (BodySetup && !bUseComplexAsSimple)
+	{
+		const FKAggregateGeom& AggGeom = BodySetup->AggGeom;
+
+		for (const FKBoxElem& Box : AggGeom.BoxElems)
+		{
+			AddBox(Box.GetTransform(), FVector(Box.X, Box.Y, Box.Z) * 0.5f);
+		}
+
+		for (const FKSphereElem& Sphere : AggGeom.SphereElems)
+		{
+			Capsules.Add({Sphere.Center, Sphere.Center, Sphere.Radius});
+		}
+
+		for (const FKSphylElem& Sphyl : AggGeom.SphylElems)
+		{
+			const FVector Axis = Sphyl.Rotation.RotateVector(FVector::UpVector) * Sphyl.Length * 0.5f;
+			Capsules.Add({Sphyl.Center - Axis, Sphyl.Center + Axis, Sphyl.Radius});
+		}
+
+		for (const FKConvexElem& Convex : AggGeom.ConvexElems)
+		{
+			if (Convex.IndexData.Num() == 0)
+			{
+				// Hulls without cooked indices are approximated by their bounds.
+				AddBox(Convex.GetTransform() * FTransform(Convex.ElemBox.GetCenter()), Convex.ElemBox.GetExtent());
+				continue;
+			}
+
+			const int32 BaseIndex = Vertices.Num();
+			const int32 FirstIndex = Indices.Num();
+			const FTransform ConvexTransform = Convex.GetTransform();
+			for (const FVector& Vertex : Convex.VertexData)
+			{
+				Vertices.Add(ConvexTransform.TransformPosition(Vertex));
+			}
+			for (const int32 Index : Convex.IndexData)
+			{
+				Indices.Add(BaseIndex + Index);
+			}
+			AddHull(FirstIndex);
+		}
+	}
+
+	if (!HasCollision())
+	{
+		AddRenderTriangles(StaticMesh);
+	}
+
+	BuildTriangleTree();
+}
+
+void FSeatMeshCollision::BuildFromRenderData(const UStaticMesh* StaticMesh)
+{
+	Reset();
+
+	if (StaticMesh)
+	{
+		AddRenderTriangles(StaticMesh);
+	}
+
+	BuildTriangleTree();
+}
+
+FString FSeatMeshCollision::MakeGeometryKey(const UStaticMesh* StaticMesh)
+{
+	const UBodySetup* BodySetup = StaticMesh->GetBodySetup();
+	const FStaticMeshRenderData* RenderData = StaticMesh->GetRenderData();
+
+	return FString::Printf(TEXT("%s_%s"),
+	                       RenderData ? *RenderData->DerivedDataKey : TEXT("NoRenderData"),
+	                       BodySetup ? *BodySetup->BodySetupGuid.ToString() : TEXT("NoBodySetup"));
+}
+
+void FSeatMeshCollision::AddBox(const FTransform& BoxTransform, const FVector& Extent)
+{
+	static const int32 BoxIndices[] = {
+		0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+		2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3
+	};
+
+	const int32 BaseIndex = Vertices.Num();
+	const int32 FirstIndex = Indices.Num();
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		const FVector Local((Corner & 4) ? Extent.X : -Extent.X,
+		                    (Corner & 2) ? Extent.Y : -Extent.Y,
+		                    (Corner & 1) ? Extent.Z : -Extent.Z);
+		Vertices.Add(BoxTransform.TransformPosition(Local));
+	}
+
+	for (const int32 Index : BoxIndices)
+	{
+		Indices.Add(BaseIndex + Index);
+	}
+
+	AddHull(FirstIndex);
+}
+
+void FSeatMeshCollision::AddHull(int32 FirstIndex)
+{
+	// Fewer faces than a tetrahedron enclose nothing.
+	const int32 NumIndices = Indices.Num() - FirstIndex;
+	if (NumIndices < 12)
+		return;
+
+	FCollisionHull Hull;
+	Hull.Bounds.Init();
+
+	FVector Centroid = FVector::ZeroVector;
+	for (int32 Index = FirstIndex; Index < Indices.Num(); ++Index)
+	{
+		Hull.Bounds += Vertices[Indices[Index]];
+		Centroid += Vertices[Indices[Index]];
+	}
+	Centroid /= NumIndices;
+
+	// Face winding differs between sources, the inside is the side the centroid lies on.
+	for (int32 Index = FirstIndex; Index + 2 < Indices.Num(); Index += 3)
+	{
+		const FVector& A = Vertices[Indices[Index]];
+		const FVector Normal = FVector::CrossProduct(Vertices[Indices[Index + 1]] - A, Vertices[Indices[Index + 2]] - A);
+		if (Normal.IsNearlyZero())
+			continue;
+
+		FPlane Plane(A, Normal.GetSafeNormal());
+		if (Plane.PlaneDot(Centroid) > 0.f)
+		{
+			Plane = Plane.Flip();
+		}
+		Hull.Planes.Add(Plane);
+	}
+
+	const int32 HullIndex = Hulls.Add(MoveTemp(Hull));
+
+	// Triangles added since the last hull belong to none.
+	const int32 FirstTriangle = FirstIndex / 3;
+	for (int32 Triangle = TriangleHulls.Num(); Triangle < Indices.Num() / 3; ++Triangle)
+	{
+		TriangleHulls.Add(Triangle >= FirstTriangle ? HullIndex : INDEX_NONE);
+	}
+}
+
+TBitArray<> FSeatMeshCollision::FindEnclosingHulls(const FVector& Point) const
+{
+	TBitArray<> Enclosing(false, Hulls.Num());
+	for (int32 HullIndex = 0; HullIndex < Hulls.Num(); ++HullIndex)
+	{
+		Enclosing[HullIndex] = Hulls[HullIndex].Contains(Point);
+	}
+	return Enclosing;
+}
+
+bool FSeatMeshCollision::IsInsideHull(const FVector& Point, const TBitArray<>* SkippedHulls) const
+{
+	for (int32 HullIndex = 0; HullIndex < Hulls.Num(); ++HullIndex)
+	{
+		if (!IsHullSkipped(SkippedHulls, HullIndex) && Hulls[HullIndex].Contains(Point))
+			return true;
+	}
+	return false;
+}
+
+void FSeatMeshCollision::BuildTriangleTree()
+{
+	TriangleNodes.Reset();
+
+	TArray<FBuildTriangle> Triangles;
+	Triangles.Reserve(Indices.Num() / 3);
+	for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+	{
+		FBuildTriangle& Triangle = Triangles.AddDefaulted_GetRef();
+		Triangle.Hull = TriangleHulls.IsValidIndex(Index / 3) ? TriangleHulls[Index / 3] : INDEX_NONE;
+		Triangle.Bounds.Init();
+		for (int32 Corner = 0; Corner < 3; ++Corner)
+		{
+			Triangle.Indices[Corner] = Indices[Index + Corner];
+			Triangle.Bounds += Vertices[Indices[Index + Corner]];
+		}
+	}
+
+	if (Triangles.Num() == 0)
+		return;
+
+	// A binary tree with full leaves has fewer than twice as many nodes as leaves.
+	TriangleNodes.Reserve(2 * FMath::DivideAndRoundUp(Triangles.Num(), SeatMeshCollision::MaxLeafTriangles));
+	BuildTriangleNode(Triangles, 0, Triangles.Num());
+
+	// Leaves cover contiguous triangles in the sorted order.
+	Indices.Reset(Triangles.Num() * 3);
+	TriangleHulls.Reset(Triangles.Num());
+	for (const FBuildTriangle& Triangle : Triangles)
+	{
+		Indices.Append(Triangle.Indices, 3);
+		TriangleHulls.Add(Triangle.Hull);
+	}
+}
+
+int32 FSeatMeshCollision::BuildTriangleNode(TArray<FBuildTriangle>& Triangles, int32 FirstTriangle, int32 NumTriangles)
+{
+	const int32 NodeIndex = TriangleNodes.AddUninitialized();
+	FBox Bounds(ForceInit);
+	FBox CenterBounds(ForceInit);
+	for (int32 TriangleIndex = FirstTriangle; TriangleIndex < FirstTriangle + NumTriangles; ++TriangleIndex)
+	{
+		Bounds += Triangles[TriangleIndex].Bounds;
+		CenterBounds += Triangles[TriangleIndex].Bounds.GetCenter();
+	}
+	TriangleNodes[NodeIndex].Bounds = Bounds;
+
+	if (NumTriangles <= SeatMeshCollision::MaxLeafTriangles)
+	{
+		TriangleNodes[NodeIndex].RightChild = INDEX_NONE;
+		TriangleNodes[NodeIndex].FirstTriangle = FirstTriangle;
+		TriangleNodes[NodeIndex].NumTriangles = NumTriangles;
+		return NodeIndex;
+	}
+
+	// Median split along the axis the triangle centers spread most on.
+	const FVector Extent = CenterBounds.GetExtent();
+	const int32 SplitAxis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : Extent.Y >= Extent.Z ? 1 : 2;
+	TArrayView<FBuildTriangle> Range = MakeArrayView(Triangles.GetData() + FirstTriangle, NumTriangles);
+	Range.Sort([SplitAxis](const FBuildTriangle& A, const FBuildTriangle& B)
+	{
+		return A.Bounds.GetCenter()[SplitAxis] < B.Bounds.GetCenter()[SplitAxis];
+	});
+
+	const int32 NumLeft = NumTriangles / 2;
+	BuildTriangleNode(Triangles, FirstTriangle, NumLeft);
+	const int32 RightChild = BuildTriangleNode(Triangles, FirstTriangle + NumLeft, NumTriangles - NumLeft);
+
+	TriangleNodes[NodeIndex].RightChild = RightChild;
+	TriangleNodes[NodeIndex].FirstTriangle = INDEX_NONE;
+	TriangleNodes[NodeIndex].NumTriangles = 0;
+	return NodeIndex;
+}
+
+void FSeatMeshCollision::AddRenderTriangles(const UStaticMesh* StaticMesh)
+{
+	const FStaticMeshRenderData* RenderData = StaticMesh->GetRenderData();
+	if (!RenderData || RenderData->LODResources.Num() == 0)
+		return;
+
+	const int32 LODIndex = FMath::Clamp(StaticMesh->LODForCollision, 0, RenderData->LODResources.Num() - 1);
+	const FStaticMeshLODResources& LOD = RenderData->LODResources[LODIndex];
+
+	const FPositionVertexBuffer& Positions = LOD.VertexBuffers.PositionVertexBuffer;
+	const int32 BaseIndex = Vertices.Num();
+	for (uint32 VertexIndex = 0; VertexIndex < Positions.GetNumVertices(); ++VertexIndex)
+	{
+		Vertices.Add(Positions.VertexPosition(VertexIndex));
+	}
+
+	TArray<uint32> LODIndices;
+	LOD.IndexBuffer.GetCopy(LODIndices);
+	for (const uint32 Index : LODIndices)
+	{
+		Indices.Add(BaseIndex + Index);
+	}
+}
+
+bool FSeatMeshCollision::OverlapCapsule(const FVector& Start, const FVector& End, float Radius, FVector& OutContact,
+                                        const TBitArray<>* ShellHulls) const
+{
+	return TestCapsule(Start, End, Radius, OutContact, ShellHulls, false);
+}
+
+bool FSeatMeshCollision::TestCapsule(const FVector& Start, const FVector& End, float Radius, FVector& OutContact,
+                                     const TBitArray<>* SkippedHulls, bool bSkipHullFaces) const
+{
+	FBox CapsuleBox(ForceInit);
+	CapsuleBox += Start;
+	CapsuleBox += End;
+	CapsuleBox = CapsuleBox.ExpandBy(Radius);
+
+	for (const FCollisionCapsule& Capsule : Capsules)
+	{
+		FVector OnSeat;
+		FVector OnCollision;
+		FMath::SegmentDistToSegmentSafe(Start, End, Capsule.Start, Capsule.End, OnSeat, OnCollision);
+		if (FVector::Dist(OnSeat, OnCollision) < Radius + Capsule.Radius)
+		{
+			OutContact = OnCollision;
+			return true;
+		}
+	}
+
+	// A capsule that crosses no surface is either clear or wholly inside a solid.
+	for (const FVector& Point : {Start, End})
+	{
+		if (IsInsideHull(Point, SkippedHulls))
+		{
+			OutContact = Point;
+			return true;
+		}
+	}
+
+	if (TriangleNodes.Num() == 0)
+		return false;
+
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FTriangleNode& Node = TriangleNodes[NodeIndex];
+		if (!Node.Bounds.Intersect(CapsuleBox))
+			continue;
+
+		if (!Node.IsLeaf())
+		{
+			Stack.Add(Node.RightChild);
+			Stack.Add(NodeIndex + 1);
+			continue;
+		}
+
+		for (int32 Index = Node.FirstTriangle * 3; Index < (Node.FirstTriangle + Node.NumTriangles) * 3; Index += 3)
+		{
+			if (bSkipHullFaces && IsHullSkipped(SkippedHulls, TriangleHulls[Index / 3]))
+				continue;
+
+			const FVector& A = Vertices[Indices[Index]];
+			const FVector& B = Vertices[Indices[Index + 1]];
+			const FVector& C = Vertices[Indices[Index + 2]];
+
+			FBox TriangleBox(ForceInit);
+			TriangleBox += A;
+			TriangleBox += B;
+			TriangleBox += C;
+			if (!TriangleBox.Intersect(CapsuleBox))
+				continue;
+
+			FVector TrianglePoint;
+			if (SeatMeshCollision::SegmentTriangleDistance(Start, End, A, B, C, TrianglePoint) < Radius)
+			{
+				OutContact = TrianglePoint;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool FSeatMeshCollision::SweepUprightCapsule(const FVector& Start, const FVector& End, float Radius,
+                                             float SegmentHeight, const TBitArray<>* IgnoredHulls) const
+{
+	// The swept volume is the rectangle between the bottom and top segments grown by the radius. Its edges are
+	// tested as capsules and its inside by upright capsules no more than a radius apart, anything crossing the
+	// rectangle between two of them is within the radius of one.
+	const FVector Up(0.f, 0.f, SegmentHeight);
+	FVector Contact;
+	if (TestCapsule(Start, End, Radius, Contact, IgnoredHulls, true) ||
+		TestCapsule(Start + Up, End + Up, Radius, Contact, IgnoredHulls, true))
+		return true;
+
+	const int32 NumSteps = FMath::Max(FMath::CeilToInt(FVector::Dist(Start, End) / FMath::Max(Radius, 1.f)), 1);
+	for (int32 Step = 0; Step <= NumSteps; ++Step)
+	{
+		const FVector Point = FMath::Lerp(Start, End, static_cast<float>(Step) / NumSteps);
+		if (TestCapsule(Point, Point + Up, Radius, Contact, IgnoredHulls, true))
+			return true;
+	}
+
+	return false;
+}
+
+bool FSeatMeshCollision::LineTrace(const FVector& Start, const FVector& End, const TBitArray<>* IgnoredHulls) const
+{
+	for (const FCollisionCapsule& Capsule : Capsules)
+	{
+		FVector OnLine;
+		FVector OnCollision;
+		FMath::SegmentDistToSegmentSafe(Start, End, Capsule.Start, Capsule.End, OnLine, OnCollision);
+		if (FVector::Dist(OnLine, OnCollision) < Capsule.Radius)
+			return true;
+	}
+
+	if (TriangleNodes.Num() == 0)
+		return false;
+
+	const FVector Delta = End - Start;
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FTriangleNode& Node = TriangleNodes[NodeIndex];
+		if (!SeatMeshCollision::SegmentIntersectsBox(Start, Delta, Node.Bounds))
+			continue;
+
+		if (!Node.IsLeaf())
+		{
+			Stack.Add(Node.RightChild);
+			Stack.Add(NodeIndex + 1);
+			continue;
+		}
+
+		for (int32 Index = Node.FirstTriangle * 3; Index < (Node.FirstTriangle + Node.NumTriangles) * 3; Index += 3)
+		{
+			if (IsHullSkipped(IgnoredHulls, TriangleHulls[Index / 3]))
+				continue;
+
+			FVector HitPoint;
+			FVector HitNormal;
+			if (FMath::SegmentTriangleIntersection(Start, End, Vertices[Indices[Index]], Vertices[Indices[Index + 1]],
+			                                       Vertices[Indices[Index + 2]], HitPoint, HitNormal))
+				return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,136 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStaticMesh;
+
+/**
+ * Snapshot of a static mesh's collision in mesh space.
+ * Built on the game thread, afterwards it is read only and safe to query from worker threads.
+ * Triangles are kept in a bounding volume hierarchy, boxes and convex hulls are solid.
+ * A box or hull around a seat models a cabin from the outside, queries for such a seat pass the hulls
+ * from FindEnclosingHulls so the seat is not taken as buried in collision.
+ */
+class FSeatMeshCollision
+{
+public:
+	/** Gathers simple collision, or the collision triangles when the mesh has none or uses complex as simple. */
+	void Build(const UStaticMesh* StaticMesh);
+
+	/** Gathers the collision LOD's render triangles regardless of the simple collision. */
+	void BuildFromRenderData(const UStaticMesh* StaticMesh);
+
+	bool HasCollision() const { return Indices.Num() > 0 || Capsules.Num() > 0; }
+
+	/** Key that changes whenever the mesh geometry or its collision setup changes. */
+	static FString MakeGeometryKey(const UStaticMesh* StaticMesh);
+
+	/** Boxes and convex hulls the point lies inside of, one bit per hull. */
+	TBitArray<> FindEnclosingHulls(const FVector& Point) const;
+
+	/**
+	 * Tests a capsule given by its inner segment and radius against the collision.
+	 *
+	 * @param OutContact	Point on the collision closest to the capsule axis, set on overlap.
+	 * @param ShellHulls	Hulls that are hollow, only their faces are tested.
+	 * @return				TRUE if the capsule overlaps any collision.
+	 */
+	bool OverlapCapsule(const FVector& Start, const FVector& End, float Radius, FVector& OutContact,
+	                    const TBitArray<>* ShellHulls = nullptr) const;
+
+	/**
+	 * Tests an upright capsule moved from Start to End against the collision.
+	 * Start and End are the centers of its bottom sphere, SegmentHeight the length of its inner segment.
+	 *
+	 * @param IgnoredHulls	Hulls left out entirely, such as the cabin a path leads into.
+	 * @return				TRUE if the capsule overlaps any collision anywhere along the way.
+	 */
+	bool SweepUprightCapsule(const FVector& Start, const FVector& End, float Radius, float SegmentHeight,
+	                         const TBitArray<>* IgnoredHulls = nullptr) const;
+
+	/** TRUE if the segment hits any collision surface other than those of IgnoredHulls. */
+	bool LineTrace(const FVector& Start, const FVector& End, const TBitArray<>* IgnoredHulls = nullptr) const;
+
+	/** Triangle list in mesh space, three indices per triangle. */
+	const TArray<FVector>& GetVertices() const { return Vertices; }
+	const TArray<int32>& GetIndices() const { return Indices; }
+
+private:
+	void Reset();
+	void AddBox(const FTransform& BoxTransform, const FVector& Extent);
+	void AddRenderTriangles(const UStaticMesh* StaticMesh);
+
+	/** Makes the closed triangle shell from FirstIndex to the end of the indices a solid hull. */
+	void AddHull(int32 FirstIndex);
+
+	/** A triangle while the hierarchy is built. */
+	struct FBuildTriangle
+	{
+		int32 Indices[3];
+		int32 Hull;
+		FBox Bounds;
+	};
+
+	/** Builds the hierarchy over all triangles, reordering them. */
+	void BuildTriangleTree();
+	int32 BuildTriangleNode(TArray<FBuildTriangle>& Triangles, int32 FirstTriangle, int32 NumTriangles);
+
+	bool IsInsideHull(const FVector& Point, const TBitArray<>* SkippedHulls) const;
+
+	/** Capsule test where SkippedHulls are hollow, and left out entirely with bSkipHullFaces. */
+	bool TestCapsule(const FVector& Start, const FVector& End, float Radius, FVector& OutContact,
+	                 const TBitArray<>* SkippedHulls, bool bSkipHullFaces) const;
+
+	static bool IsHullSkipped(const TBitArray<>* SkippedHulls, int32 Hull)
+	{
+		return SkippedHulls && Hull != INDEX_NONE && (*SkippedHulls)[Hull];
+	}
+
+	struct FCollisionCapsule
+	{
+		FVector Start;
+		FVector End;
+		float Radius;
+	};
+
+	/** Boxes and convex hulls as the planes of their faces, normals pointing out. */
+	struct FCollisionHull
+	{
+		FBox Bounds;
+		TArray<FPlane> Planes;
+
+		bool Contains(const FVector& Point) const
+		{
+			return Bounds.IsInsideOrOn(Point) && !Planes.ContainsByPredicate([&Point](const FPlane& Plane)
+			{
+				return Plane.PlaneDot(Point) > 0.f;
+			});
+		}
+	};
+
+	struct FTriangleNode
+	{
+		FBox Bounds;
+
+		/** Leaves cover NumTriangles triangles from FirstTriangle, inner nodes are followed by their left child. */
+		int32 RightChild;
+		int32 FirstTriangle;
+		int32 NumTriangles;
+
+		bool IsLeaf() const { return NumTriangles > 0; }
+	};
+
+	TArray<FVector> Vertices;
+	TArray<int32> Indices;
+
+	/** Spheres and sphyls, spheres are capsules with a zero length segment. */
+	TArray<FCollisionCapsule> Capsules;
+
+	TArray<FCollisionHull> Hulls;
+	TArray<FTriangleNode> TriangleNodes;
+
+	/** Hull each triangle is a face of, INDEX_NONE for triangles of no hull. */
+	TArray<int32> TriangleHulls;
+};
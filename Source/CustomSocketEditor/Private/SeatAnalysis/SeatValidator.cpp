@@ -0,0 +1,256 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatValidator.h"
+
+#include "CustomSocketStats.h"
+#include "SeatDerivedData.h"
+#include "SeatMeshCollision.h"
+#include "SeatSettings.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "Logging/MessageLog.h"
+#include "Misc/UObjectToken.h"
+#include "SeatSocket/SeatSocket.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#define LOCTEXT_NAMESPACE "SeatValidator"
+
+namespace SeatValidator
+{
+	/** Bump whenever the validation changes so cached results are recomputed. */
+	const int32 Version = 3;
+
+	struct FSeatCapsule
+	{
+		FName SeatName;
+		int32 SeatIndex;
+		FVector Start;
+		FVector End;
+		float Radius;
+
+		/** Hulls around the seat, the cabin it sits in is only collision where its walls are. */
+		TBitArray<> ShellHulls;
+	};
+
+	struct FMeshJob
+	{
+		FSeatMeshValidationResult Result;
+		FSeatMeshCollision Collision;
+		TArray<FSeatCapsule> Capsules;
+	};
+
+	const TCHAR* const DerivedDataTag = TEXT("VAL");
+
+	/** Derived data holds the result without mesh and key, the lookup already knows both. */
+	void SerializeDerivedResult(FArchive& Ar, FSeatMeshValidationResult& Result)
+	{
+		Ar << Result.bHasCollision;
+
+		int32 NumIssues = Result.Issues.Num();
+		Ar << NumIssues;
+		if (Ar.IsLoading())
+		{
+			// Every issue takes more than a byte, a larger count means the data is corrupt.
+			if (NumIssues < 0 || NumIssues > Ar.TotalSize())
+			{
+				Ar.SetError();
+				return;
+			}
+			Result.Issues.SetNum(NumIssues);
+		}
+
+		for (FSeatValidationIssue& Issue : Result.Issues)
+		{
+			Ar << Issue.SeatName << Issue.SeatIndex << Issue.Contact;
+		}
+	}
+}
+
+FSeatValidator& FSeatValidator::Get()
+{
+	static FSeatValidator Validator;
+	return Validator;
+}
+
+void FSeatValidator::ValidateSeatMap(USeatMap* SeatMap, TArray<FSeatMeshValidationResult>& OutResults)
+{
+	check(IsInGameThread());
+
+	OutResults.Reset();
+	if (!SeatMap)
+		return;
+
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_ValidateSeatMap);
+
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+	const FString SettingsKey = FString::Printf(TEXT("%.2f%s"), Settings->ValidationSkin,
+	                                            *Settings->GetPostureShapesKey());
+
+	// Collision and capsules are gathered on the game thread, the overlap tests run in parallel.
+	TIndirectArray<SeatValidator::FMeshJob> Jobs;
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+	{
+		UStaticMesh* StaticMesh = Pair.Key.LoadSynchronous();
+		if (!StaticMesh)
+		{
+			FSeatMeshValidationResult& Result = OutResults.AddDefaulted_GetRef();
+			Result.StaticMesh = Pair.Key;
+			Result.bMeshLoaded = false;
+			continue;
+		}
+
+		const FString CacheKey = FString::Printf(TEXT("%d_%s_%016llx_%s"), SeatValidator::Version,
+		                                         *FSeatMeshCollision::MakeGeometryKey(StaticMesh),
+		                                         SeatMap->ComputeSeatsHash(Pair.Key), *SettingsKey);
+		{
+			FScopeLock Lock(&CacheLock);
+			const FSeatMeshValidationResult* Cached = Cache.Find(Pair.Key.ToSoftObjectPath());
+			if (Cached && Cached->CacheKey == CacheKey)
+			{
+				OutResults.Add(*Cached);
+				continue;
+			}
+		}
+
+		TArray<uint8> DerivedData;
+		if (SeatDerivedData::Get(SeatValidator::DerivedDataTag, CacheKey, DerivedData))
+		{
+			FSeatMeshValidationResult Result;
+			Result.StaticMesh = Pair.Key;
+			Result.CacheKey = CacheKey;
+
+			FMemoryReader Reader(DerivedData);
+			SeatValidator::SerializeDerivedResult(Reader, Result);
+			if (!Reader.IsError())
+			{
+				FScopeLock Lock(&CacheLock);
+				Cache.Add(Pair.Key.ToSoftObjectPath(), Result);
+				OutResults.Add(MoveTemp(Result));
+				continue;
+			}
+		}
+
+		SeatValidator::FMeshJob* Job = new SeatValidator::FMeshJob();
+		Job->Result.StaticMesh = Pair.Key;
+		Job->Result.CacheKey = CacheKey;
+		Job->Collision.Build(StaticMesh);
+		Job->Result.bHasCollision = Job->Collision.HasCollision();
+
+		TArray<FSeatInstance> Seats;
+		SeatMap->GatherSeats(Pair.Key, Seats);
+		for (int32 SeatIndex = 0; SeatIndex < Seats.Num(); ++SeatIndex)
+		{
+			const USeatSocket* Seat = Seats[SeatIndex].Seat;
+			const FSeatPostureShape& Shape = Settings->GetPostureShape(Seat->Posture);
+
+			SeatValidator::FSeatCapsule& Capsule = Job->Capsules.AddDefaulted_GetRef();
+			Capsule.SeatName = Seat->Name;
+			Capsule.SeatIndex = SeatIndex;
+			Capsule.Radius = FMath::Max(Shape.Radius - Settings->ValidationSkin, 1.f);
+			Shape.GetCapsuleSegment(Seats[SeatIndex].Transform, Capsule.Start, Capsule.End);
+			Capsule.ShellHulls = Job->Collision.FindEnclosingHulls((Capsule.Start + Capsule.End) * 0.5f);
+		}
+
+		Jobs.Add(Job);
+	}
+
+	ParallelFor(Jobs.Num(), [&Jobs](int32 JobIndex)
+	{
+		SeatValidator::FMeshJob& Job = Jobs[JobIndex];
+		for (const SeatValidator::FSeatCapsule& Capsule : Job.Capsules)
+		{
+			FVector Contact;
+			if (Job.Collision.OverlapCapsule(Capsule.Start, Capsule.End, Capsule.Radius, Contact, &Capsule.ShellHulls))
+			{
+				FSeatValidationIssue& Issue = Job.Result.Issues.AddDefaulted_GetRef();
+				Issue.SeatName = Capsule.SeatName;
+				Issue.SeatIndex = Capsule.SeatIndex;
+				Issue.Contact = Contact;
+			}
+		}
+	});
+
+	for (SeatValidator::FMeshJob& Job : Jobs)
+	{
+		TArray<uint8> DerivedData;
+		FMemoryWriter Writer(DerivedData);
+		SeatValidator::SerializeDerivedResult(Writer, Job.Result);
+		SeatDerivedData::Put(SeatValidator::DerivedDataTag, Job.Result.CacheKey, DerivedData);
+	}
+
+	FScopeLock Lock(&CacheLock);
+	for (const SeatValidator::FMeshJob& Job : Jobs)
+	{
+		Cache.Add(Job.Result.StaticMesh.ToSoftObjectPath(), Job.Result);
+		OutResults.Add(Job.Result);
+	}
+	UpdateCacheMemoryStat();
+}
+
+void FSeatValidator::ClearCache()
+{
+	FScopeLock Lock(&CacheLock);
+	Cache.Empty();
+	UpdateCacheMemoryStat();
+}
+
+void FSeatValidator::UpdateCacheMemoryStat() const
+{
+	SIZE_T Memory = Cache.GetAllocatedSize();
+	for (const TPair<FSoftObjectPath, FSeatMeshValidationResult>& Pair : Cache)
+	{
+		Memory += Pair.Key.GetAssetPathString().GetAllocatedSize() + Pair.Key.GetSubPathString().GetAllocatedSize();
+		Memory += Pair.Value.CacheKey.GetAllocatedSize() + Pair.Value.Issues.GetAllocatedSize();
+	}
+
+	SET_MEMORY_STAT(STAT_CustomSocket_ValidationCacheMemory, Memory);
+}
+
+int32 FSeatValidator::ReportResults(const USeatMap* SeatMap, const TArray<FSeatMeshValidationResult>& Results)
+{
+	FMessageLog SeatLog("CustomSocket");
+	SeatLog.NewPage(FText::Format(LOCTEXT("ValidationPage", "Seat validation of {0}"),
+	                              FText::FromString(GetNameSafe(SeatMap))));
+
+	int32 IssueCount = 0;
+	for (const FSeatMeshValidationResult& Result : Results)
+	{
+		const FText MeshName = FText::FromString(Result.StaticMesh.GetAssetName());
+
+		if (!Result.bMeshLoaded)
+		{
+			SeatLog.Error(FText::Format(LOCTEXT("MeshNotLoaded", "{0} failed to load, its seats were not checked."),
+			                            FText::FromString(Result.StaticMesh.ToString())));
+			++IssueCount;
+			continue;
+		}
+
+		if (!Result.bHasCollision)
+		{
+			SeatLog.Info(FText::Format(LOCTEXT("NoCollision", "{0} has no collision, its seats were not checked."),
+			                           MeshName));
+			continue;
+		}
+
+		for (const FSeatValidationIssue& Issue : Result.Issues)
+		{
+			SeatLog.Warning()
+			       ->AddToken(FUObjectToken::Create(Result.StaticMesh.Get()))
+			       ->AddToken(FTextToken::Create(FText::Format(
+				       LOCTEXT("SeatClips", "Seat '{0}' clips into collision at {1}."),
+				       FText::FromName(Issue.SeatName), FText::FromString(Issue.Contact.ToCompactString()))));
+			++IssueCount;
+		}
+	}
+
+	if (IssueCount == 0)
+	{
+		SeatLog.Info(LOCTEXT("AllSeatsClear", "No seat clips into collision."));
+	}
+
+	return IssueCount;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,59 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStaticMesh;
+class USeatMap;
+
+/** A seat whose occupant capsule clips into the mesh collision. */
+struct FSeatValidationIssue
+{
+	FName SeatName;
+	/** Index into the seats gathered by USeatMap::GatherSeats. */
+	int32 SeatIndex = INDEX_NONE;
+
+	/** Point on the collision the occupant touches, in mesh space. */
+	FVector Contact = FVector::ZeroVector;
+};
+
+struct FSeatMeshValidationResult
+{
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
+
+	/** Identifies the mesh geometry, seat data and settings the result was computed from. */
+	FString CacheKey;
+
+	/** FALSE if the mesh failed to load, its seats were not checked. Such results are not cached. */
+	bool bMeshLoaded = true;
+
+	bool bHasCollision = false;
+	TArray<FSeatValidationIssue> Issues;
+};
+
+/**
+ * Checks seat placement by testing posture sized capsules at every seat against the mesh collision.
+ * Meshes are validated in parallel, results are cached per mesh and seat data hash.
+ */
+class FSeatValidator
+{
+public:
+	static FSeatValidator& Get();
+
+	/** Validates every mesh of the seat map, only meshes whose geometry or seats changed are recomputed. */
+	void ValidateSeatMap(USeatMap* SeatMap, TArray<FSeatMeshValidationResult>& OutResults);
+
+	/** Forgets all cached results. */
+	void ClearCache();
+
+	/** Reports the results to the CustomSocket message log, returns the number of issues including unloaded meshes. */
+	static int32 ReportResults(const USeatMap* SeatMap, const TArray<FSeatMeshValidationResult>& Results);
+
+private:
+	/** Publishes the size of the cache to stat CustomSocket, called with the cache locked. */
+	void UpdateCacheMemoryStat() const;
+
+	FCriticalSection CacheLock;
+	TMap<FSoftObjectPath, FSeatMeshValidationResult> Cache;
+};
@@ -0,0 +1,182 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatGizmoComponent.h"
+
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "SeatSettings.h"
+
+namespace SeatGizmo
+{
+	const FLinearColor NormalColor(0.1f, 0.8f, 0.2f);
+	const FLinearColor FireableColor(1.f, 0.4f, 0.1f);
+	const FLinearColor SelectedColor(1.f, 0.9f, 0.1f);
+	const FLinearColor ScopeColor(0.2f, 0.6f, 1.f);
+
+	const float ArrowLength = 60.f;
+	const float ScopeRadius = 80.f;
+	const int32 CapsuleSides = 12;
+	const int32 ArcSections = 16;
+}
+
+class FSeatGizmoSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	explicit FSeatGizmoSceneProxy(const USeatGizmoComponent* InComponent)
+		: FPrimitiveSceneProxy(InComponent),
+		  Gizmos(InComponent->GetGizmos())
+	{
+		bWillEverBeLit = false;
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily,
+	                                    uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		const FMatrix& LocalToWorld = GetLocalToWorld();
+
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		{
+			if (!(VisibilityMap & (1 << ViewIndex)))
+				continue;
+
+			FPrimitiveDrawInterface* PDI = Collector.GetPDI(ViewIndex);
+			for (const FSeatGizmo& Gizmo : Gizmos)
+			{
+				DrawGizmo(PDI, Gizmo.Transform.ToMatrixNoScale() * LocalToWorld, Gizmo);
+			}
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bDynamicRelevance = true;
+		Result.bShadowRelevance = false;
+		Result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
+		return Result;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize();
+	}
+
+	uint32 GetAllocatedSize() const
+	{
+		return FPrimitiveSceneProxy::GetAllocatedSize() + Gizmos.GetAllocatedSize();
+	}
+
+private:
+	static void DrawGizmo(FPrimitiveDrawInterface* PDI, const FMatrix& SeatToWorld, const FSeatGizmo& Gizmo)
+	{
+		const FVector Origin = SeatToWorld.GetOrigin();
+		const FVector Forward = SeatToWorld.GetUnitAxis(EAxis::X);
+		const FVector Right = SeatToWorld.GetUnitAxis(EAxis::Y);
+		const FVector Up = SeatToWorld.GetUnitAxis(EAxis::Z);
+
+		const FLinearColor Color = Gizmo.bSelected
+			                           ? SeatGizmo::SelectedColor
+			                           : Gizmo.SeatType == ESeatType::Fireable
+			                           ? SeatGizmo::FireableColor
+			                           : SeatGizmo::NormalColor;
+
+		// Posture marker, lying postures extend along the seat forward axis.
+		if (Gizmo.bLying)
+		{
+			DrawWireCapsule(PDI, Origin + Up * Gizmo.CapsuleRadius, Up, -Right, Forward, Color,
+			                Gizmo.CapsuleRadius, Gizmo.CapsuleHalfHeight, SeatGizmo::CapsuleSides, SDPG_World);
+		}
+		else
+		{
+			DrawWireCapsule(PDI, Origin + Up * Gizmo.CapsuleHalfHeight, Forward, Right, Up, Color,
+			                Gizmo.CapsuleRadius, Gizmo.CapsuleHalfHeight, SeatGizmo::CapsuleSides, SDPG_World);
+		}
+
+		// Facing arrow at eye height.
+		const FVector Eye = Origin + Up * Gizmo.EyeHeight;
+		const FMatrix ArrowMatrix(Forward, Right, Up, Eye);
+		DrawDirectionalArrow(PDI, ArrowMatrix, Color, SeatGizmo::ArrowLength, 8.f, SDPG_World);
+
+		// Yaw arc in the seat plane and pitch arc in the facing plane.
+		if (Gizmo.YawScope > 0.f)
+		{
+			const float HalfYaw = Gizmo.YawScope * 0.5f;
+			DrawArc(PDI, Eye, Forward, Right, -HalfYaw, HalfYaw, SeatGizmo::ScopeRadius, SeatGizmo::ArcSections,
+			        SeatGizmo::ScopeColor, SDPG_World);
+			PDI->DrawLine(Eye, Eye + Forward.RotateAngleAxis(-HalfYaw, Up) * SeatGizmo::ScopeRadius,
+			              SeatGizmo::ScopeColor, SDPG_World);
+			PDI->DrawLine(Eye, Eye + Forward.RotateAngleAxis(HalfYaw, Up) * SeatGizmo::ScopeRadius,
+			              SeatGizmo::ScopeColor, SDPG_World);
+		}
+
+		if (Gizmo.PitchScope > 0.f)
+		{
+			const float HalfPitch = Gizmo.PitchScope * 0.5f;
+			DrawArc(PDI, Eye, Forward, Up, -HalfPitch, HalfPitch, SeatGizmo::ScopeRadius, SeatGizmo::ArcSections,
+			        SeatGizmo::ScopeColor, SDPG_World);
+		}
+	}
+
+	TArray<FSeatGizmo> Gizmos;
+};
+
+USeatGizmoComponent::USeatGizmoComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CastShadow = false;
+	bUseEditorCompositing = true;
+}
+
+void USeatGizmoComponent::SetSeats(const TArray<FSeatInstance>& InSeats, const USeatSocket* InSelectedSeat)
+{
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+
+	Gizmos.Reset(InSeats.Num());
+	for (const FSeatInstance& Instance : InSeats)
+	{
+		const USeatSocket* Seat = Instance.Seat;
+
+		const FSeatPostureShape& Shape = Settings->GetPostureShape(Seat->Posture);
+
+		FSeatGizmo& Gizmo = Gizmos.AddDefaulted_GetRef();
+		Gizmo.Transform = Instance.Transform;
+		Gizmo.SeatType = Seat->SeatType;
+		Gizmo.CapsuleRadius = Shape.Radius;
+		Gizmo.CapsuleHalfHeight = Shape.HalfHeight;
+		Gizmo.EyeHeight = Shape.GetEyeHeight();
+		Gizmo.bLying = Shape.bLying;
+		Gizmo.YawScope = Seat->YawScope;
+		Gizmo.PitchScope = Seat->PitchScope;
+		Gizmo.bSelected = Seat == InSelectedSeat;
+	}
+
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+FPrimitiveSceneProxy* USeatGizmoComponent::CreateSceneProxy()
+{
+	return Gizmos.Num() ? new FSeatGizmoSceneProxy(this) : nullptr;
+}
+
+FBoxSphereBounds USeatGizmoComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	FBox Box(ForceInit);
+	for (const FSeatGizmo& Gizmo : Gizmos)
+	{
+		const float Extent = FMath::Max3(Gizmo.CapsuleHalfHeight * 2.f, SeatGizmo::ScopeRadius, SeatGizmo::ArrowLength)
+			+ Gizmo.CapsuleRadius;
+		Box += FBox::BuildAABB(Gizmo.Transform.GetLocation(), FVector(Extent));
+	}
+
+	return Box.IsValid ? FBoxSphereBounds(Box.TransformBy(LocalToWorld)) : FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+}
@@ -0,0 +1,48 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "SeatSocket/SeatSocket.h"
+#include "SeatGizmoComponent.generated.h"
+
+/** Everything the gizmo proxy needs to draw one seat, resolved on the game thread. */
+struct FSeatGizmo
+{
+	FTransform Transform;
+	ESeatType SeatType = ESeatType::Normal;
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+	float EyeHeight = 0.f;
+	bool bLying = false;
+	float YawScope = 0.f;
+	float PitchScope = 0.f;
+	bool bSelected = false;
+};
+
+/**
+ * Draws every seat of a mesh as a posture capsule, a facing arrow and its yaw and pitch arcs
+ * through a single primitive, so an overview of many seats costs one draw pass.
+ */
+UCLASS(Transient)
+class USeatGizmoComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	USeatGizmoComponent();
+
+	/** Rebuilds the gizmos from the seats, highlighting the selected one. */
+	void SetSeats(const TArray<FSeatInstance>& InSeats, const USeatSocket* InSelectedSeat);
+
+	const TArray<FSeatGizmo>& GetGizmos() const { return Gizmos; }
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//~ End UPrimitiveComponent Interface
+
+private:
+	TArray<FSeatGizmo> Gizmos;
+};
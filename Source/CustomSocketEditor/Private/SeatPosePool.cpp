@@ -0,0 +1,131 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatPosePool.h"
+
+#include "CustomSocketStats.h"
+#include "PreviewScene.h"
+#include "SeatSettings.h"
+#include "Animation/AnimInstance.h"
+
+USeatPoseLeaderComponent::USeatPoseLeaderComponent()
+{
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void USeatPoseLeaderComponent::AddFollower()
+{
+	++FollowerCount;
+	UpdateTickState();
+}
+
+void USeatPoseLeaderComponent::RemoveFollower()
+{
+	FollowerCount = FMath::Max(FollowerCount - 1, 0);
+	UpdateTickState();
+}
+
+void USeatPoseLeaderComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+                                             FActorComponentTickFunction* ThisTickFunction)
+{
+	INC_DWORD_STAT(STAT_CustomSocket_ActivePreviewTicks);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+void USeatPoseLeaderComponent::UpdateTickState()
+{
+	const bool bAnimate = FollowerCount > 0 && GetDefault<USeatSettings>()->bAnimatePreviews;
+	SetComponentTickEnabled(bAnimate);
+
+	if (!bAnimate && FollowerCount > 0 && IsRegistered())
+	{
+		// Evaluate the pose once so still previews show the posture without ticking.
+		TickAnimation(0.f, false);
+		RefreshBoneTransforms();
+	}
+}
+
+FSeatPosePool::FSeatPosePool(FPreviewScene* InPreviewScene)
+	: PreviewScene(InPreviewScene)
+{
+	GetMutableDefault<USeatSettings>()->OnSettingChanged().AddRaw(this, &FSeatPosePool::OnSettingChanged);
+}
+
+FSeatPosePool::~FSeatPosePool()
+{
+	if (UObjectInitialized())
+	{
+		GetMutableDefault<USeatSettings>()->OnSettingChanged().RemoveAll(this);
+	}
+
+	for (const TPair<EPosture, USeatPoseLeaderComponent*>& Leader : Leaders)
+	{
+		if (Leader.Value)
+			PreviewScene->RemoveComponent(Leader.Value);
+	}
+}
+
+USeatPoseLeaderComponent* FSeatPosePool::GetLeader(EPosture Posture)
+{
+	if (USeatPoseLeaderComponent** Found = Leaders.Find(Posture))
+		return *Found;
+
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+
+	USeatPoseLeaderComponent* Leader = NewObject<USeatPoseLeaderComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+	Leader->SetSkeletalMesh(Settings->PreviewSkeletalMesh.LoadSynchronous());
+	Leader->SetAnimationMode(EAnimationMode::AnimationBlueprint);
+	Leader->SetAnimInstanceClass(Settings->GetPreviewAnimBlueprint(Posture));
+
+	// The leader is never drawn, it only evaluates the pose its followers copy.
+	Leader->SetVisibility(false);
+	Leader->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	PreviewScene->AddComponent(Leader, FTransform::Identity);
+	Leaders.Add(Posture, Leader);
+
+	return Leader;
+}
+
+void FSeatPosePool::Follow(USkeletalMeshComponent* Follower, EPosture Posture)
+{
+	USeatPoseLeaderComponent* Leader = GetLeader(Posture);
+	if (Follower->MasterPoseComponent.Get() == Leader)
+		return;
+
+	Unfollow(Follower);
+	Follower->SetMasterPoseComponent(Leader);
+	Leader->AddFollower();
+}
+
+void FSeatPosePool::Unfollow(USkeletalMeshComponent* Follower)
+{
+	if (USeatPoseLeaderComponent* Leader = Cast<USeatPoseLeaderComponent>(Follower->MasterPoseComponent.Get()))
+	{
+		Follower->SetMasterPoseComponent(nullptr);
+		Leader->RemoveFollower();
+	}
+}
+
+void FSeatPosePool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(Leaders);
+}
+
+FString FSeatPosePool::GetReferencerName() const
+{
+	return TEXT("FSeatPosePool");
+}
+
+void FSeatPosePool::OnSettingChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (PropertyChangedEvent.GetPropertyName() != GET_MEMBER_NAME_CHECKED(USeatSettings, bAnimatePreviews))
+		return;
+
+	for (const TPair<EPosture, USeatPoseLeaderComponent*>& Leader : Leaders)
+	{
+		if (Leader.Value)
+			Leader.Value->UpdateTickState();
+	}
+}
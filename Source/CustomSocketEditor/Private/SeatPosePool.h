@@ -0,0 +1,68 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "SeatSocket/SeatSocket.h"
+#include "SeatPosePool.generated.h"
+
+class FPreviewScene;
+
+/**
+ * Hidden skeletal mesh evaluating the pose of one posture.
+ * It only ticks while previews follow it and preview animation is enabled.
+ */
+UCLASS(Transient)
+class USeatPoseLeaderComponent : public USkeletalMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	USeatPoseLeaderComponent();
+
+	void AddFollower();
+	void RemoveFollower();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
+	                           FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Enables ticking only while the pose actually needs to advance. */
+	void UpdateTickState();
+
+private:
+	int32 FollowerCount = 0;
+};
+
+/**
+ * Evaluates one animated pose per posture and lets every seat preview copy it,
+ * so the animation cost of a preview scene does not grow with the seat count.
+ */
+class FSeatPosePool : public FGCObject
+{
+public:
+	explicit FSeatPosePool(FPreviewScene* InPreviewScene);
+	virtual ~FSeatPosePool() override;
+
+	/** Returns the pose leader for the posture, creating it on first use. */
+	USeatPoseLeaderComponent* GetLeader(EPosture Posture);
+
+	/** Makes the follower copy the pose evaluated for the posture. */
+	void Follow(USkeletalMeshComponent* Follower, EPosture Posture);
+
+	/** Detaches the follower from its posture leader. */
+	void Unfollow(USkeletalMeshComponent* Follower);
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+
+private:
+	/** Starts or stops the leaders when preview animation is switched in the settings. */
+	void OnSettingChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent);
+
+	FPreviewScene* PreviewScene;
+
+	/** One hidden, animated skeletal mesh per posture. */
+	TMap<EPosture, USeatPoseLeaderComponent*> Leaders;
+};
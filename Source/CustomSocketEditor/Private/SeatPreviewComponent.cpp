@@ -3,27 +3,25 @@
 
 #include "SeatPreviewComponent.h"
 
+#include "CustomSocketStats.h"
+#include "SeatPosePool.h"
 #include "SeatSettings.h"
-#include "Animation/AnimInstance.h"
 
 
 // Sets default values for this component's properties
 USeatPreviewComponent::USeatPreviewComponent()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// The pose is copied from a posture leader of the FSeatPosePool, so neither this component
+	// nor the preview mesh has anything to do per frame.
+	PrimaryComponentTick.bCanEverTick = false;
 
 	SkeletalMeshComponent = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("PreviewSkeletalMesh"), true);
-	SkeletalMeshComponent->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
+	SkeletalMeshComponent->SetupAttachment(this);
 	SkeletalMeshComponent->SetRelativeTransform(FTransform::Identity);
 	SkeletalMeshComponent->SetSkeletalMesh(GetDefault<USeatSettings>()->PreviewSkeletalMesh.LoadSynchronous());
+	SkeletalMeshComponent->PrimaryComponentTick.bCanEverTick = false;
 
 	FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &USeatPreviewComponent::OnObjectPropertyChanged);
-
-	UClass* PreviewAnimBlueprintClass = GetDefault<USeatSettings>()->PreviewAnimBlueprint.LoadSynchronous();
-	SkeletalMeshComponent->SetAnimationMode(EAnimationMode::AnimationBlueprint);
-	SkeletalMeshComponent->SetAnimInstanceClass(PreviewAnimBlueprintClass);
 }
 
 
@@ -37,13 +35,28 @@ void USeatPreviewComponent::BeginPlay()
 
 void USeatPreviewComponent::Update()
 {
-	SetRelativeLocation(SeatSocket->RelativeLocation);
-	SetRelativeRotation(SeatSocket->RelativeRotation);
+	// The preview mesh is the component registered with the preview scene, this component stays at identity.
+	SkeletalMeshComponent->SetRelativeTransform(SeatSocket->GetRelativeTransform() * LayoutTransform);
+
+	if (const TSharedPtr<FSeatPosePool> PinnedPosePool = PosePool.Pin())
+	{
+		PinnedPosePool->Follow(SkeletalMeshComponent, SeatSocket->Posture);
+	}
+
+	UpdateTrackedMemory();
 }
 
-void USeatPreviewComponent::SetSeatSocket(USeatSocket* InSeatSocket)
+void USeatPreviewComponent::SetSeatSocket(USeatSocket* InSeatSocket, const FTransform& InLayoutTransform)
 {
 	SeatSocket = InSeatSocket;
+	LayoutTransform = InLayoutTransform;
+	if (SeatSocket)
+		Update();
+}
+
+void USeatPreviewComponent::SetPosePool(const TSharedPtr<FSeatPosePool>& InPosePool)
+{
+	PosePool = InPosePool;
 	if (SeatSocket)
 		Update();
 }
@@ -56,13 +69,57 @@ void USeatPreviewComponent::OnObjectPropertyChanged(UObject* Object, FPropertyCh
 	Update();
 }
 
-// Called every frame
-void USeatPreviewComponent::TickComponent(float DeltaTime, ELevelTick TickType,
-                                          FActorComponentTickFunction* ThisTickFunction)
+void USeatPreviewComponent::DestroyComponent(bool bPromoteChildren)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
 
-	// ...
+	if (const TSharedPtr<FSeatPosePool> PinnedPosePool = PosePool.Pin())
+	{
+		PinnedPosePool->Unfollow(SkeletalMeshComponent);
+	}
+	PosePool.Reset();
+
+	SkeletalMeshComponent->DestroyComponent();
+
+	Super::DestroyComponent(bPromoteChildren);
+}
+
+void USeatPreviewComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		INC_DWORD_STAT(STAT_CustomSocket_NumSeatPreviews);
+		UpdateTrackedMemory();
+	}
+}
+
+void USeatPreviewComponent::BeginDestroy()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		DEC_DWORD_STAT(STAT_CustomSocket_NumSeatPreviews);
+		DEC_MEMORY_STAT_BY(STAT_CustomSocket_SeatPreviewMemory, TrackedMemory);
+		TrackedMemory = 0;
+	}
+
+	Super::BeginDestroy();
+}
+
+void USeatPreviewComponent::UpdateTrackedMemory()
+{
+	// The component pair plus the pose buffers, which grow once the preview mesh follows a posture.
+	SIZE_T Memory = sizeof(USeatPreviewComponent) + sizeof(USkeletalMeshComponent);
+	if (SkeletalMeshComponent)
+	{
+		Memory += SkeletalMeshComponent->GetComponentSpaceTransforms().GetAllocatedSize();
+		Memory += SkeletalMeshComponent->GetBoneSpaceTransforms().GetAllocatedSize();
+	}
+
+	INC_MEMORY_STAT_BY(STAT_CustomSocket_SeatPreviewMemory, Memory);
+	DEC_MEMORY_STAT_BY(STAT_CustomSocket_SeatPreviewMemory, TrackedMemory);
+	TrackedMemory = Memory;
 }
 
 USceneComponent* USeatPreviewComponent::GetPreviewComponent() const
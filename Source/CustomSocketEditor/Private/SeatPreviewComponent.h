@@ -7,6 +7,7 @@
 #include "SeatSocket/SeatSocket.h"
 #include "SeatPreviewComponent.generated.h"
 
+class FSeatPosePool;
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class CUSTOMSOCKETEDITOR_API USeatPreviewComponent : public USceneComponent
@@ -23,12 +24,18 @@ protected:
 	
 	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
 public:
+	/** Previews never tick, they only change through Update() and property change callbacks. */
 	virtual void Update();
-	virtual void SetSeatSocket(USeatSocket* InSeatSocket);
+	virtual void SetSeatSocket(USeatSocket* InSeatSocket, const FTransform& InLayoutTransform = FTransform::Identity);
 
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
-	                           FActorComponentTickFunction* ThisTickFunction) override;
+	/** Sets the pool the preview mesh copies its posture pose from. */
+	void SetPosePool(const TSharedPtr<FSeatPosePool>& InPosePool);
+
+	/** Stops following the posture pose and listening for seat changes. */
+	virtual void DestroyComponent(bool bPromoteChildren = false) override;
+
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
 
 	UPROPERTY()
 	USkeletalMeshComponent* SkeletalMeshComponent;
@@ -37,4 +44,14 @@ public:
 	
 	UPROPERTY()
 	USeatSocket* SeatSocket;
+
+private:
+	TWeakPtr<FSeatPosePool> PosePool;
+
+	/** Places the seat on the mesh, the template transform for template seats. */
+	FTransform LayoutTransform;
+
+	/** Bytes this preview adds to the seat preview memory stat. */
+	void UpdateTrackedMemory();
+	SIZE_T TrackedMemory = 0;
 };
@@ -0,0 +1,48 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatPreviewRebuildScheduler.h"
+
+#include "CustomSocketStats.h"
+#include "SeatSettings.h"
+
+FSeatPreviewRebuildScheduler::FSeatPreviewRebuildScheduler(const FBuildSeatPreview& InBuildSeatPreview)
+	: BuildSeatPreview(InBuildSeatPreview)
+{
+}
+
+void FSeatPreviewRebuildScheduler::Schedule(const TArray<USeatSocket*>& InSeats)
+{
+	PendingSeats.Reset(InSeats.Num());
+	for (int32 Index = InSeats.Num() - 1; Index >= 0; --Index)
+	{
+		PendingSeats.Add(InSeats[Index]);
+	}
+}
+
+void FSeatPreviewRebuildScheduler::Cancel()
+{
+	PendingSeats.Reset();
+}
+
+void FSeatPreviewRebuildScheduler::Tick(float DeltaTime)
+{
+	const double BudgetSeconds = GetDefault<USeatSettings>()->PreviewRebuildBudgetMs / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Always build at least one preview per frame so a tiny budget still makes progress.
+	do
+	{
+		USeatSocket* Seat = PendingSeats.Pop(false).Get();
+		if (Seat)
+		{
+			BuildSeatPreview.ExecuteIfBound(Seat);
+		}
+	}
+	while (PendingSeats.Num() > 0 && FPlatformTime::Seconds() - StartTime < BudgetSeconds);
+}
+
+TStatId FSeatPreviewRebuildScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSeatPreviewRebuildScheduler, STATGROUP_CustomSocket);
+}
@@ -0,0 +1,41 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TickableEditorObject.h"
+
+class USeatSocket;
+
+DECLARE_DELEGATE_OneParam(FBuildSeatPreview, USeatSocket*);
+
+/**
+ * Spreads the creation of seat previews across frames under the millisecond budget of USeatSettings.
+ * Scheduling a new set of seats discards whatever was still pending from the previous one.
+ */
+class FSeatPreviewRebuildScheduler : public FTickableEditorObject
+{
+public:
+	explicit FSeatPreviewRebuildScheduler(const FBuildSeatPreview& InBuildSeatPreview);
+
+	/** Replaces the pending work, seats are built in the given order. */
+	void Schedule(const TArray<USeatSocket*>& InSeats);
+
+	/** Drops all pending work. */
+	void Cancel();
+
+	bool IsRunning() const { return PendingSeats.Num() > 0; }
+
+	//~ Begin FTickableEditorObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsRunning(); }
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableEditorObject Interface
+
+private:
+	FBuildSeatPreview BuildSeatPreview;
+
+	/** Seats still to build, in reverse order so the next one is popped from the end. */
+	TArray<TWeakObjectPtr<USeatSocket>> PendingSeats;
+};
@@ -0,0 +1,78 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatPreviewWorld.h"
+
+#include "SeatPosePool.h"
+#include "Components/PrimitiveComponent.h"
+
+TSharedRef<FSeatPreviewWorld> FSeatPreviewWorld::Get()
+{
+	static TWeakPtr<FSeatPreviewWorld> SharedWorld;
+
+	TSharedPtr<FSeatPreviewWorld> World = SharedWorld.Pin();
+	if (!World.IsValid())
+	{
+		World = MakeShareable(new FSeatPreviewWorld());
+		SharedWorld = World;
+	}
+
+	return World.ToSharedRef();
+}
+
+FSeatPreviewWorld::FSeatPreviewWorld()
+{
+	PreviewScene = MakeUnique<FAdvancedPreviewScene>(FPreviewScene::ConstructionValues());
+	PosePool = MakeShared<FSeatPosePool>(PreviewScene.Get());
+}
+
+FSeatPreviewWorld::~FSeatPreviewWorld()
+{
+	PosePool.Reset();
+	PreviewScene.Reset();
+}
+
+void FSeatPreviewWorld::AddComponent(const void* Owner, UActorComponent* Component, const FTransform& LocalToWorld)
+{
+	PreviewScene->AddComponent(Component, LocalToWorld);
+	ComponentOwners.Add(Component, Owner);
+}
+
+void FSeatPreviewWorld::RemoveComponent(UActorComponent* Component)
+{
+	PreviewScene->RemoveComponent(Component);
+	ComponentOwners.Remove(Component);
+}
+
+void FSeatPreviewWorld::RemoveComponents(const void* Owner)
+{
+	for (auto It = ComponentOwners.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == Owner)
+		{
+			PreviewScene->RemoveComponent(const_cast<UActorComponent*>(It.Key()));
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FSeatPreviewWorld::GetHiddenPrimitives(const void* Owner, TSet<FPrimitiveComponentId>& OutHiddenPrimitives) const
+{
+	for (const TPair<const UActorComponent*, const void*>& ComponentOwner : ComponentOwners)
+	{
+		const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(ComponentOwner.Key);
+		if (Primitive && ComponentOwner.Value != Owner)
+		{
+			OutHiddenPrimitives.Add(Primitive->ComponentId);
+		}
+	}
+}
+
+void FSeatPreviewWorld::Tick(ELevelTick TickType, float DeltaSeconds)
+{
+	if (LastTickFrame == GFrameCounter)
+		return;
+
+	LastTickFrame = GFrameCounter;
+	PreviewScene->GetWorld()->Tick(TickType, DeltaSeconds);
+}
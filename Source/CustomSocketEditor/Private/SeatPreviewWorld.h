@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedPreviewScene.h"
+
+class FSeatPosePool;
+class UActorComponent;
+
+/**
+ * Preview scene and posture poses shared by every open seat map editor.
+ * The first editor creates it and the last one to close releases it, so further editors open without
+ * building another world, sky, floor and lighting. Components are added on behalf of an editor,
+ * the views of the other editors do not draw them.
+ */
+class FSeatPreviewWorld
+{
+public:
+	/** Returns the shared world, creating it if no editor holds it. */
+	static TSharedRef<FSeatPreviewWorld> Get();
+
+	~FSeatPreviewWorld();
+
+	FAdvancedPreviewScene* GetScene() const { return PreviewScene.Get(); }
+	const TSharedPtr<FSeatPosePool>& GetPosePool() const { return PosePool; }
+
+	/** Adds the component to the scene, owned by and visible to the given editor only. */
+	void AddComponent(const void* Owner, UActorComponent* Component, const FTransform& LocalToWorld);
+	void RemoveComponent(UActorComponent* Component);
+
+	/** Removes every component the editor added. */
+	void RemoveComponents(const void* Owner);
+
+	/** Adds the primitives of all other editors, which views of the owner hide. */
+	void GetHiddenPrimitives(const void* Owner, TSet<FPrimitiveComponentId>& OutHiddenPrimitives) const;
+
+	/** Ticks the world, every viewport showing it calls this and only the first call of a frame ticks. */
+	void Tick(ELevelTick TickType, float DeltaSeconds);
+
+private:
+	FSeatPreviewWorld();
+
+	TUniquePtr<FAdvancedPreviewScene> PreviewScene;
+
+	/** Released before the scene, it removes its pose leaders from it. */
+	TSharedPtr<FSeatPosePool> PosePool;
+
+	TMap<const UActorComponent*, const void*> ComponentOwners;
+
+	/** GFrameCounter of the last tick. */
+	uint64 LastTickFrame = MAX_uint64;
+};
@@ -2,3 +2,60 @@
 
 
 #include "SeatSettings.h"
+
+#include "Animation/AnimInstance.h"
+
+void FSeatPostureShape::GetCapsuleSegment(const FTransform& SeatTransform, FVector& OutStart, FVector& OutEnd) const
+{
+	const float SegmentHalfLength = FMath::Max(HalfHeight - Radius, 0.f);
+	const FVector Center = bLying ? FVector(0.f, 0.f, Radius) : FVector(0.f, 0.f, HalfHeight);
+	const FVector Axis = bLying ? FVector::ForwardVector : FVector::UpVector;
+
+	OutStart = SeatTransform.TransformPosition(Center - Axis * SegmentHalfLength);
+	OutEnd = SeatTransform.TransformPosition(Center + Axis * SegmentHalfLength);
+}
+
+USeatSettings::USeatSettings()
+{
+	FSeatPostureShape SquatDown;
+	SquatDown.HalfHeight = 60.f;
+
+	FSeatPostureShape GetDown;
+	GetDown.bLying = true;
+
+	PostureShapes.Add(EPosture::StandUp, FSeatPostureShape());
+	PostureShapes.Add(EPosture::SquatDown, SquatDown);
+	PostureShapes.Add(EPosture::GetDown, GetDown);
+
+	PostureSocketTokens.Add(EPosture::StandUp, TEXT("Stand"));
+	PostureSocketTokens.Add(EPosture::SquatDown, TEXT("Squat"));
+	PostureSocketTokens.Add(EPosture::GetDown, TEXT("Prone"));
+}
+
+TSubclassOf<UAnimInstance> USeatSettings::GetPreviewAnimBlueprint(EPosture Posture) const
+{
+	const TSoftClassPtr<UAnimInstance>* PostureAnimBlueprint = PostureAnimBlueprints.Find(Posture);
+	if (PostureAnimBlueprint && !PostureAnimBlueprint->IsNull())
+		return PostureAnimBlueprint->LoadSynchronous();
+
+	return PreviewAnimBlueprint.LoadSynchronous();
+}
+
+const FSeatPostureShape& USeatSettings::GetPostureShape(EPosture Posture) const
+{
+	static const FSeatPostureShape DefaultShape;
+
+	const FSeatPostureShape* Shape = PostureShapes.Find(Posture);
+	return Shape ? *Shape : DefaultShape;
+}
+
+FString USeatSettings::GetPostureShapesKey() const
+{
+	FString Key;
+	for (const TPair<EPosture, FSeatPostureShape>& Shape : PostureShapes)
+	{
+		Key += FString::Printf(TEXT("_%d:%.2f:%.2f:%d"), static_cast<int32>(Shape.Key), Shape.Value.Radius,
+		                       Shape.Value.HalfHeight, Shape.Value.bLying ? 1 : 0);
+	}
+	return Key;
+}
@@ -4,8 +4,32 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "SeatSocket/SeatSocket.h"
 #include "SeatSettings.generated.h"
 
+/** Size of the capsule an occupant of a posture takes up, relative to the seat transform. */
+USTRUCT()
+struct FSeatPostureShape
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "SeatPosture")
+	float Radius = 34.f;
+
+	UPROPERTY(EditAnywhere, Category = "SeatPosture")
+	float HalfHeight = 88.f;
+
+	/** Lying postures extend the capsule along the seat forward axis instead of up. */
+	UPROPERTY(EditAnywhere, Category = "SeatPosture")
+	bool bLying = false;
+
+	/** End points of the capsule's inner segment for a seat placed at SeatTransform. */
+	void GetCapsuleSegment(const FTransform& SeatTransform, FVector& OutStart, FVector& OutEnd) const;
+
+	/** Height of the occupant's eyes above the seat, where it looks and fires from. */
+	float GetEyeHeight() const { return bLying ? Radius : HalfHeight * 1.6f; }
+};
+
 /**
  * 
  */
@@ -15,9 +39,57 @@ class CUSTOMSOCKETEDITOR_API USeatSettings : public UDeveloperSettings
 	GENERATED_BODY()
 
 public:
+	USeatSettings();
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
 	TSoftObjectPtr<USkeletalMesh> PreviewSkeletalMesh;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
 	TSoftClassPtr<UAnimInstance> PreviewAnimBlueprint;
+
+	/** Optional animation blueprint per posture, postures without an entry use PreviewAnimBlueprint. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
+	TMap<EPosture, TSoftClassPtr<UAnimInstance>> PostureAnimBlueprints;
+
+	/**
+	 * Plays the posture animations on seat previews, one pose leader per posture then ticks every frame.
+	 * Off by default, previews hold their posture pose and the seat editor does no per frame animation work.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
+	bool bAnimatePreviews = false;
+
+	/** Time per frame the seat editor may spend creating seat previews after a rebuild, in milliseconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config, meta = (ClampMin = "0.1", Units = "ms"))
+	float PreviewRebuildBudgetMs = 4.f;
+
+	/** Distance an occupant capsule may touch collision by before a seat is reported as clipping. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config, meta = (ClampMin = "0", Units = "cm"))
+	float ValidationSkin = 2.f;
+
+	/** Steepest surface, in degrees from horizontal, that seat candidates are proposed on. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config, meta = (ClampMin = "0", ClampMax = "60", Units = "deg"))
+	float CandidateMaxSlope = 10.f;
+
+	/** Static mesh sockets whose name starts with this are imported as seats. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
+	FString SeatSocketPrefix = TEXT("Seat");
+
+	/** Imported sockets whose name contains this become fireable seats. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
+	FString FireableSocketToken = TEXT("Fire");
+
+	/** Name part that gives an imported socket its posture, sockets without one become standing seats. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Config)
+	TMap<EPosture, FString> PostureSocketTokens;
+
+	/** Occupant capsule per posture, used by seat gizmos, seat validation and seat candidates. */
+	UPROPERTY(EditAnywhere, Config)
+	TMap<EPosture, FSeatPostureShape> PostureShapes;
+
+	TSubclassOf<UAnimInstance> GetPreviewAnimBlueprint(EPosture Posture) const;
+
+	const FSeatPostureShape& GetPostureShape(EPosture Posture) const;
+
+	/** Key that changes whenever a posture shape changes, for caching results that depend on them. */
+	FString GetPostureShapesKey() const;
 };
@@ -3,9 +3,355 @@
 
 #include "SeatSocket.h"
 
+#include "CustomSocketEditor.h"
+#include "CustomSocketStats.h"
+#include "SeatBlob.h"
+#include "SeatSettings.h"
+#include "ScopedTransaction.h"
+#include "Hash/CityHash.h"
+#include "Math/MirrorMatrix.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/MemoryWriter.h"
+
+const FGuid FSeatMapCustomVersion::GUID(0x6A3C51E2, 0x4F0B47D8, 0x9C2E8B17, 0xD5A04F63);
+
+static FCustomVersionRegistration GRegisterSeatMapCustomVersion(FSeatMapCustomVersion::GUID,
+                                                                FSeatMapCustomVersion::LatestVersion,
+                                                                TEXT("SeatMapVer"));
+
+void USeatSocket::SerializeSeatData(FArchive& Ar)
+{
+	Ar << Name;
+	Ar << RelativeLocation;
+	Ar << RelativeRotation;
+	Ar << SeatType;
+	Ar << Posture;
+	Ar << YawScope;
+	Ar << PitchScope;
+}
+
+void USeatSocket::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		INC_DWORD_STAT(STAT_CustomSocket_NumSeats);
+		INC_MEMORY_STAT_BY(STAT_CustomSocket_SeatMemory, sizeof(USeatSocket));
+	}
+}
+
+void USeatSocket::BeginDestroy()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		DEC_DWORD_STAT(STAT_CustomSocket_NumSeats);
+		DEC_MEMORY_STAT_BY(STAT_CustomSocket_SeatMemory, sizeof(USeatSocket));
+	}
+
+	Super::BeginDestroy();
+}
+
+namespace SeatMap
+{
+	void SerializeSeats(const TArray<USeatSocket*>& Seats, FArchive& Ar)
+	{
+		for (USeatSocket* Seat : Seats)
+		{
+			if (Seat)
+				Seat->SerializeSeatData(Ar);
+		}
+	}
+
+	/** Template seats the filter selects through the selected meshes, seats a mesh overrides are not seen by it. */
+	TSet<USeatSocket*> FilterTemplateSeats(const USeatMap* SeatMap, const FSeatFilter& Filter,
+	                                       const TSet<TSoftObjectPtr<UStaticMesh>>& FilterMeshes)
+	{
+		TSet<USeatSocket*> SelectedSeats;
+		for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+		{
+			const FName Template = Pair.Value.Template;
+			const FSeats* TemplateSeats = Template.IsNone() ? nullptr : SeatMap->Templates.Find(Template);
+			if (!TemplateSeats || (FilterMeshes.Num() > 0 && !FilterMeshes.Contains(Pair.Key)))
+				continue;
+
+			for (USeatSocket* Seat : TemplateSeats->Seats)
+			{
+				const bool bOverridden = Seat && Pair.Value.Seats.ContainsByPredicate([Seat](const USeatSocket* MeshSeat)
+				{
+					return MeshSeat && MeshSeat->Name == Seat->Name;
+				});
+				if (!bOverridden && Filter.Matches(Seat))
+				{
+					SelectedSeats.Add(Seat);
+				}
+			}
+		}
+		return SelectedSeats;
+	}
+}
+
+uint64 FSeats::ComputeHash() const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	SeatMap::SerializeSeats(Seats, Writer);
+
+	if (!Template.IsNone())
+	{
+		FName TemplateName = Template;
+		FTransform Transform = TemplateTransform;
+		Writer << TemplateName;
+		Writer << Transform;
+	}
+
+	return CityHash64(reinterpret_cast<const char*>(Bytes.GetData()), Bytes.Num());
+}
+
+void USeatMap::GatherSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, TArray<FSeatInstance>& OutSeats) const
+{
+	OutSeats.Reset();
+
+	const FSeats* Seats = FindSeats(InStaticMesh);
+	if (!Seats)
+		return;
+
+	const FSeats* TemplateSeats = Seats->Template.IsNone() ? nullptr : Templates.Find(Seats->Template);
+	if (TemplateSeats)
+	{
+		for (USeatSocket* Seat : TemplateSeats->Seats)
+		{
+			const bool bOverridden = Seat && Seats->Seats.ContainsByPredicate([Seat](const USeatSocket* MeshSeat)
+			{
+				return MeshSeat && MeshSeat->Name == Seat->Name;
+			});
+			if (!Seat || bOverridden)
+				continue;
+
+			FSeatInstance& Instance = OutSeats.AddDefaulted_GetRef();
+			Instance.Seat = Seat;
+			Instance.Transform = Seat->GetRelativeTransform() * Seats->TemplateTransform;
+			Instance.bFromTemplate = true;
+		}
+	}
+
+	for (USeatSocket* Seat : Seats->Seats)
+	{
+		if (!Seat)
+			continue;
+
+		FSeatInstance& Instance = OutSeats.AddDefaulted_GetRef();
+		Instance.Seat = Seat;
+		Instance.Transform = Seat->GetRelativeTransform();
+	}
+}
+
+uint64 USeatMap::ComputeSeatsHash(const TSoftObjectPtr<UStaticMesh>& InStaticMesh) const
+{
+	const FSeats* Seats = FindSeats(InStaticMesh);
+	if (!Seats)
+		return 0;
+
+	const FSeats* TemplateSeats = Seats->Template.IsNone() ? nullptr : Templates.Find(Seats->Template);
+	const uint64 Hash = Seats->ComputeHash();
+	return TemplateSeats ? CityHash128to64(Uint128_64(Hash, TemplateSeats->ComputeHash())) : Hash;
+}
+
+void USeatMap::BuildSeatBlob(TArray<uint8>& OutBlob) const
+{
+	BuildSeatBlob(OutBlob, [](const TSoftObjectPtr<UStaticMesh>&) { return true; });
+}
+
+void USeatMap::BuildSeatBlob(TArray<uint8>& OutBlob,
+                             TFunctionRef<bool(const TSoftObjectPtr<UStaticMesh>&)> IncludeMesh) const
+{
+	FSeatBlobWriter Writer;
+
+	// Occupant capsules the runtime places at the seats as collision proxies.
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+	for (int32 Posture = 0; Posture < StaticEnum<EPosture>()->NumEnums() - 1; ++Posture)
+	{
+		const FSeatPostureShape& Shape = Settings->GetPostureShape(static_cast<EPosture>(Posture));
+		Writer.SetPostureShape(Posture, Shape.Radius, Shape.HalfHeight, Shape.bLying);
+	}
+
+	TArray<FSeatInstance> Seats;
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap)
+	{
+		if (!IncludeMesh(Pair.Key))
+			continue;
+
+		GatherSeats(Pair.Key, Seats);
+		const FSeatMeshBoarding* MeshBoarding = Boarding.Find(Pair.Key);
+		const FSeatMeshFireArcs* MeshFireArcs = FireArcs.Find(Pair.Key);
+
+		TArray<FSeatBlobSeatDesc> BlobSeats;
+		BlobSeats.Reserve(Seats.Num());
+		for (int32 SeatIndex = 0; SeatIndex < Seats.Num(); ++SeatIndex)
+		{
+			const FSeatInstance& Instance = Seats[SeatIndex];
+			FSeatBlobSeatDesc& BlobSeat = BlobSeats.AddDefaulted_GetRef();
+			BlobSeat.Name = Instance.Seat->Name;
+			BlobSeat.Location = Instance.Transform.GetLocation();
+			BlobSeat.Rotation = Instance.Transform.Rotator();
+			BlobSeat.SeatType = static_cast<uint8>(Instance.Seat->SeatType);
+			BlobSeat.Posture = static_cast<uint8>(Instance.Seat->Posture);
+			BlobSeat.YawScope = Instance.Seat->YawScope;
+			BlobSeat.PitchScope = Instance.Seat->PitchScope;
+
+			const FSeatBoardingPath* Path = MeshBoarding ? MeshBoarding->FindPath(Instance.Seat->Name, SeatIndex) : nullptr;
+			if (Path)
+			{
+				BlobSeat.EntryPath = Path->EntryPath;
+				BlobSeat.ExitPath = Path->ExitPath;
+			}
+
+			const FSeatFireArc* FireArc = MeshFireArcs && Instance.Seat->SeatType == ESeatType::Fireable
+				                              ? MeshFireArcs->FindArc(Instance.Seat->Name)
+				                              : nullptr;
+			if (FireArc)
+			{
+				BlobSeat.FireArcOrigin = FireArc->Origin;
+				BlobSeat.FireArc = FireArc->VisibleCells;
+			}
+		}
+		Writer.AddMesh(Pair.Key.ToSoftObjectPath(), MoveTemp(BlobSeats));
+	}
+
+	Writer.Write(OutBlob);
+}
+
+bool FSeatFilter::Matches(const USeatSocket* Seat) const
+{
+	return Seat &&
+		(!bFilterSeatType || Seat->SeatType == SeatType) &&
+		(!bFilterPosture || Seat->Posture == Posture) &&
+		(NamePattern.IsEmpty() || Seat->Name.ToString().MatchesWildcard(NamePattern));
+}
+
+void FSeatEdit::Apply(USeatSocket* Seat) const
+{
+	Seat->RelativeLocation += LocationOffset;
+	if (!RotationOffset.IsZero())
+	{
+		Seat->RelativeRotation = (FQuat(RotationOffset) * FQuat(Seat->RelativeRotation)).Rotator();
+	}
+
+	if (bSetSeatType)
+		Seat->SeatType = SeatType;
+
+	if (bSetPosture)
+		Seat->Posture = Posture;
+
+	if (bSetYawScope)
+		Seat->YawScope = YawScope;
+
+	if (bSetPitchScope)
+		Seat->PitchScope = PitchScope;
+}
+
+TArray<USeatSocket*> USeatMap::FilterSeats(const FSeatFilter& Filter) const
+{
+	const TSet<TSoftObjectPtr<UStaticMesh>> FilterMeshes(Filter.Meshes);
+
+	TSet<USeatSocket*> SelectedSeats;
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap)
+	{
+		if (FilterMeshes.Num() > 0 && !FilterMeshes.Contains(Pair.Key))
+			continue;
+
+		for (USeatSocket* Seat : Pair.Value.Seats)
+		{
+			if (Filter.Matches(Seat))
+			{
+				SelectedSeats.Add(Seat);
+			}
+		}
+	}
+	SelectedSeats.Append(SeatMap::FilterTemplateSeats(this, Filter, FilterMeshes));
+
+	return SelectedSeats.Array();
+}
+
+int32 USeatMap::EditSeats(const FSeatFilter& Filter, const FSeatEdit& Edit)
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_EditSeats);
+
+	const TSet<TSoftObjectPtr<UStaticMesh>> FilterMeshes(Filter.Meshes);
+
+	// Selected seat slots, and every seat object the edit must not reach through an unselected mesh or template.
+	TArray<USeatSocket**> SelectedSlots;
+	TSet<const USeatSocket*> KeptSeats;
+	for (TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap)
+	{
+		const bool bMeshSelected = FilterMeshes.Num() == 0 || FilterMeshes.Contains(Pair.Key);
+		for (USeatSocket*& Seat : Pair.Value.Seats)
+		{
+			if (bMeshSelected && Filter.Matches(Seat))
+			{
+				SelectedSlots.Add(&Seat);
+			}
+			else
+			{
+				KeptSeats.Add(Seat);
+			}
+		}
+	}
+	const TSet<USeatSocket*> SelectedTemplateSeats = SeatMap::FilterTemplateSeats(this, Filter, FilterMeshes);
+	for (TPair<FName, FSeats>& Pair : Templates)
+	{
+		for (USeatSocket*& Seat : Pair.Value.Seats)
+		{
+			if (SelectedTemplateSeats.Contains(Seat))
+			{
+				SelectedSlots.Add(&Seat);
+			}
+			else
+			{
+				KeptSeats.Add(Seat);
+			}
+		}
+	}
+
+	if (SelectedSlots.Num() == 0)
+		return 0;
+
+	const FScopedTransaction Transaction(NSLOCTEXT("SeatMap", "EditSeats", "Edit Seats"));
+	Modify();
+	PreEditChange(NULL);
+
+	// Seats shared between selected meshes stay shared, those also kept elsewhere are split off once.
+	TMap<USeatSocket*, USeatSocket*> EditedSeats;
+	for (USeatSocket** Slot : SelectedSlots)
+	{
+		USeatSocket*& EditedSeat = EditedSeats.FindOrAdd(*Slot);
+		if (!EditedSeat)
+		{
+			if (KeptSeats.Contains(*Slot))
+			{
+				EditedSeat = DuplicateObject(*Slot, this);
+			}
+			else
+			{
+				EditedSeat = *Slot;
+				EditedSeat->Modify();
+			}
+			Edit.Apply(EditedSeat);
+		}
+		*Slot = EditedSeat;
+	}
+
+	PostEditChange();
+	MarkPackageDirty();
+
+	return EditedSeats.Num();
+}
+
 #if WITH_EDITOR
 void USeatSocket::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_PropertyChanged);
+
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 
 	if (PropertyChangedEvent.Property)
@@ -14,23 +360,283 @@ void USeatSocket::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedE
 	}
 }
 
-void USeatMap::AddSeat(UStaticMesh* InStaticMesh, USeatSocket* InSeatSocket)
+void USeatMap::AddSeat(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeatSocket)
 {
 	GetSeats(InStaticMesh).Seats.Add(InSeatSocket);
 }
 
-void USeatMap::RemoveSeat(UStaticMesh* InStaticMesh, USeatSocket* InSeatSocket)
+void USeatMap::RemoveSeat(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeatSocket)
 {
-	GetSeats(InStaticMesh).Seats.Remove(InSeatSocket);
+	FSeats& Seats = GetSeats(InStaticMesh);
+	if (Seats.Seats.Remove(InSeatSocket) > 0 || Seats.Template.IsNone())
+		return;
+
+	// A seat the mesh does not own comes from its template, every mesh using the template loses it.
+	if (FSeats* TemplateSeats = Templates.Find(Seats.Template))
+	{
+		TemplateSeats->Seats.Remove(InSeatSocket);
+	}
 }
 
 FSeats& USeatMap::GetSeats(UStaticMesh* InStaticMesh)
 {
-	FSeats* Seats = SeatMap.Find(InStaticMesh);
-	if (!Seats)
-		SeatMap.Add(InStaticMesh, FSeats());
+	return GetSeats(TSoftObjectPtr<UStaticMesh>(InStaticMesh));
+}
+
+FSeats& USeatMap::GetSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh)
+{
+	return SeatMap.FindOrAdd(InStaticMesh);
+}
+
+const FSeats* USeatMap::FindSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh) const
+{
+	return SeatMap.Find(InStaticMesh);
+}
+
+TSoftObjectPtr<UStaticMesh> USeatMap::GetInitialMesh() const
+{
+	if (!LastEditedMesh.IsNull())
+		return LastEditedMesh;
+
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap)
+	{
+		if (!Pair.Key.IsNull())
+			return Pair.Key;
+	}
+
+	return TSoftObjectPtr<UStaticMesh>();
+}
+
+FName USeatMap::MakeTemplate(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, FName InTemplateName)
+{
+	FSeats& Seats = GetSeats(InStaticMesh);
+	ensure(Seats.Template.IsNone());
+
+	FName TemplateName = InTemplateName;
+	for (int32 Index = 1; Templates.Contains(TemplateName); ++Index)
+	{
+		TemplateName = FName(InTemplateName, Index);
+	}
+
+	// The template keeps the mesh's current layout, so the mesh looks the same with an identity transform.
+	FSeats& TemplateSeats = Templates.Add(TemplateName);
+	TemplateSeats.Seats = MoveTemp(Seats.Seats);
+	Seats.Seats.Reset();
+	Seats.Template = TemplateName;
+	Seats.TemplateTransform = FTransform::Identity;
+
+	return TemplateName;
+}
+
+void USeatMap::SetTemplate(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, FName InTemplateName,
+                           const FTransform& InTemplateTransform)
+{
+	FSeats& Seats = GetSeats(InStaticMesh);
+	Seats.Template = InTemplateName;
+	Seats.TemplateTransform = InTemplateTransform;
+}
+
+namespace SeatMap
+{
+	FName GetMirroredName(FName Name)
+	{
+		static const TCHAR* Sides[2] = {TEXT("Left"), TEXT("Right")};
+		static const TCHAR* SideSuffixes[2] = {TEXT("_L"), TEXT("_R")};
+
+		// The name's number stays, the sides are only looked for in the plain name.
+		const FString NameString = Name.GetPlainNameString();
+		for (int32 Side = 0; Side < 2; ++Side)
+		{
+			const int32 Found = NameString.Find(Sides[Side], ESearchCase::CaseSensitive);
+			if (Found != INDEX_NONE)
+			{
+				const FString MirroredName = NameString.Left(Found) + Sides[1 - Side] +
+					NameString.Mid(Found + FCString::Strlen(Sides[Side]));
+				return FName(*MirroredName, Name.GetNumber());
+			}
+		}
+
+		// Only a trailing token is a side, so names like Seat_Lower are left alone.
+		for (int32 Side = 0; Side < 2; ++Side)
+		{
+			if (NameString.EndsWith(SideSuffixes[Side], ESearchCase::CaseSensitive))
+			{
+				const FString MirroredName = NameString.LeftChop(FCString::Strlen(SideSuffixes[Side])) +
+					SideSuffixes[1 - Side];
+				return FName(*MirroredName, Name.GetNumber());
+			}
+		}
 
-	return SeatMap[InStaticMesh];
+		return FName(*(NameString + TEXT("_Mirrored")), Name.GetNumber());
+	}
+
+	/** Numbers the name until no seat in UsedNames has it. */
+	FName MakeUniqueSeatName(FName Name, const TSet<FName>& UsedNames)
+	{
+		FName UniqueName = Name;
+		for (int32 Number = FMath::Max(Name.GetNumber(), 1) + 1; UsedNames.Contains(UniqueName); ++Number)
+		{
+			UniqueName = FName(Name, Number);
+		}
+		return UniqueName;
+	}
+}
+
+TArray<USeatSocket*> USeatMap::MirrorSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, const FPlane& InMirrorPlane)
+{
+	TArray<USeatSocket*> MirroredSeats;
+
+	const FVector Normal = FVector(InMirrorPlane).GetSafeNormal();
+	if (Normal.IsZero())
+		return MirroredSeats;
+
+	const FPlane MirrorPlane(Normal, InMirrorPlane.W / FVector(InMirrorPlane).Size());
+	const FMatrix Mirror = FMirrorMatrix(MirrorPlane);
+
+	// Template seats count too, a mesh seat of the same name would override them.
+	TArray<FSeatInstance> ExistingSeats;
+	GatherSeats(InStaticMesh, ExistingSeats);
+	TSet<FName> UsedNames;
+	for (const FSeatInstance& Instance : ExistingSeats)
+	{
+		UsedNames.Add(Instance.Seat->Name);
+	}
+
+	FSeats& Seats = GetSeats(InStaticMesh);
+	const TArray<USeatSocket*> SourceSeats = Seats.Seats;
+	for (const USeatSocket* Seat : SourceSeats)
+	{
+		if (!Seat || FMath::Abs(MirrorPlane.PlaneDot(Seat->RelativeLocation)) < 1.f)
+			continue;
+
+		// Mirroring the forward and up axes keeps a right handed seat frame, the seat's sides swap instead.
+		const FMatrix SeatMatrix = FRotationMatrix(Seat->RelativeRotation);
+		const FVector Forward = Mirror.TransformVector(SeatMatrix.GetUnitAxis(EAxis::X));
+		const FVector Up = Mirror.TransformVector(SeatMatrix.GetUnitAxis(EAxis::Z));
+
+		USeatSocket* MirroredSeat = DuplicateObject(Seat, this);
+		MirroredSeat->Name = SeatMap::MakeUniqueSeatName(SeatMap::GetMirroredName(Seat->Name), UsedNames);
+		UsedNames.Add(MirroredSeat->Name);
+		MirroredSeat->RelativeLocation = Mirror.TransformPosition(Seat->RelativeLocation);
+		MirroredSeat->RelativeRotation = FRotationMatrix::MakeFromXZ(Forward, Up).Rotator();
+
+		Seats.Seats.Add(MirroredSeat);
+		MirroredSeats.Add(MirroredSeat);
+	}
+
+	return MirroredSeats;
+}
+
+FSeatDeduplicationStats USeatMap::DeduplicateSeats()
+{
+	struct FSeatSet
+	{
+		TArray<uint8> Data;
+		const TArray<USeatSocket*>* Seats;
+	};
+
+	FSeatDeduplicationStats Stats;
+	TMap<USeatSocket*, USeatSocket*> Replacements;
+	TSet<USeatSocket*> SeatObjectsBefore;
+	TSet<USeatSocket*> SeatObjectsAfter;
+	TMap<uint64, TArray<FSeatSet>> SeatSets;
+
+	for (TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap)
+	{
+		TArray<USeatSocket*>& Seats = Pair.Value.Seats;
+		if (Seats.Num() == 0)
+			continue;
+
+		++Stats.NumMeshes;
+		SeatObjectsBefore.Append(Seats);
+
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+		SeatMap::SerializeSeats(Seats, Writer);
+
+		// Sets with the same hash are told apart by their data, so a collision never merges different seats.
+		TArray<FSeatSet>& Candidates = SeatSets.FindOrAdd(CityHash64(reinterpret_cast<const char*>(Data.GetData()), Data.Num()));
+		const FSeatSet* Canonical = Candidates.FindByPredicate([&Data](const FSeatSet& Candidate)
+		{
+			return Candidate.Data == Data;
+		});
+
+		if (Canonical)
+		{
+			// Equal data means equal seats in the same order, so each seat is replaced by its counterpart.
+			const TArray<USeatSocket*>& CanonicalSeats = *Canonical->Seats;
+			for (int32 SeatIndex = 0; SeatIndex < Seats.Num(); ++SeatIndex)
+			{
+				if (Seats[SeatIndex] != CanonicalSeats[SeatIndex])
+				{
+					Replacements.Add(Seats[SeatIndex], CanonicalSeats[SeatIndex]);
+				}
+			}
+			Seats = CanonicalSeats;
+		}
+		else
+		{
+			Candidates.Add({MoveTemp(Data), &Seats});
+			SeatObjectsAfter.Append(Seats);
+			++Stats.NumUniqueSeatSets;
+		}
+	}
+
+	SeatObjectsBefore.Remove(nullptr);
+	SeatObjectsAfter.Remove(nullptr);
+	Stats.NumSeatObjectsBefore = SeatObjectsBefore.Num();
+	Stats.NumSeatObjectsAfter = SeatObjectsAfter.Num();
+
+	if (Replacements.Num() > 0)
+	{
+		SeatsReplacedEvent.Broadcast(Replacements);
+	}
+	return Stats;
+}
+
+void USeatMap::MakeSeatUnique(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeatSocket)
+{
+	USeatSocket* SeatCopy = nullptr;
+	for (TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap)
+	{
+		if (Pair.Key == InStaticMesh)
+			continue;
+
+		const int32 SeatIndex = Pair.Value.Seats.Find(InSeatSocket);
+		if (SeatIndex == INDEX_NONE)
+			continue;
+
+		// The other meshes still hold identical seats, so they keep sharing one copy.
+		if (!SeatCopy)
+		{
+			Modify();
+			SeatCopy = DuplicateObject(InSeatSocket, this);
+		}
+		Pair.Value.Seats[SeatIndex] = SeatCopy;
+	}
+}
+
+void USeatMap::FixupLegacyMeshKeys()
+{
+	const FSeats* MissingMeshSeats = SeatMap.Find(TSoftObjectPtr<UStaticMesh>());
+	if (!MissingMeshSeats)
+		return;
+
+	UE_LOG(LogCustomSocket, Warning, TEXT("Seat map %s: dropped %d seats of meshes that no longer exist."),
+	       *GetPathName(), MissingMeshSeats->Seats.Num());
+	SeatMap.Remove(TSoftObjectPtr<UStaticMesh>());
+}
+
+void USeatMap::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FSeatMapCustomVersion::GUID);
+
+	Super::Serialize(Ar);
+
+	if (Ar.IsLoading() && Ar.CustomVer(FSeatMapCustomVersion::GUID) < FSeatMapCustomVersion::SoftMeshKeys)
+	{
+		FixupLegacyMeshKeys();
+	}
 }
 
 void USeatMap::AddAssetUserData(UAssetUserData* InUserData)
@@ -11,7 +11,23 @@
  * 
  */
 
-UENUM()
+/** Versions of the seat map's saved data. */
+struct FSeatMapCustomVersion
+{
+	enum Type
+	{
+		BeforeCustomVersionWasAdded = 0,
+		/** SeatMap is keyed by soft mesh references instead of UStaticMesh pointers. */
+		SoftMeshKeys,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID;
+};
+
+UENUM(BlueprintType)
 enum class EPosture : uint8
 {
 	StandUp,
@@ -19,14 +35,14 @@ enum class EPosture : uint8
 	GetDown
 };
 
-UENUM()
+UENUM(BlueprintType)
 enum class ESeatType : uint8
 {
 	Normal,
 	Fireable,
 };
 
-UCLASS()
+UCLASS(BlueprintType)
 class CUSTOMSOCKETEDITOR_API USeatSocket : public UObject
 {
 	GENERATED_BODY()
@@ -53,6 +69,16 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SeatSocket")
 	float PitchScope;
 
+	FTransform GetRelativeTransform() const { return FTransform(RelativeRotation, RelativeLocation); }
+
+	/** Writes the seat fields that define the seat, used for content hashing. */
+	void SerializeSeatData(FArchive& Ar);
+
+	//~ Begin UObject Interface
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+	//~ End UObject Interface
+
 public:
 #if WITH_EDITOR
 	/** Broadcasts a notification whenever the socket property has changed. */
@@ -77,26 +103,311 @@ struct FSeats
 
 	UPROPERTY()
 	TArray<USeatSocket*> Seats;
+
+	/** Layout of USeatMap::Templates the mesh uses, Seats then only hold additions and overrides by name. */
+	UPROPERTY()
+	FName Template;
+
+	/** Places the template's seats on the mesh. */
+	UPROPERTY()
+	FTransform TemplateTransform;
+
+	/** Hash of the seat contents, equal for seat sets that would behave the same. */
+	uint64 ComputeHash() const;
+};
+
+/** Outcome of USeatMap::DeduplicateSeats. */
+struct FSeatDeduplicationStats
+{
+	/** Meshes with seats of their own. */
+	int32 NumMeshes = 0;
+
+	/** Distinct seat sets among those meshes. */
+	int32 NumUniqueSeatSets = 0;
+
+	/** Seat objects the meshes referenced before and after deduplication. */
+	int32 NumSeatObjectsBefore = 0;
+	int32 NumSeatObjectsAfter = 0;
+};
+
+/** A seat of a mesh with its template placement resolved. */
+struct FSeatInstance
+{
+	USeatSocket* Seat = nullptr;
+
+	/** Seat transform relative to the mesh. */
+	FTransform Transform;
+
+	/** Whether the seat belongs to the template the mesh uses rather than to the mesh. */
+	bool bFromTemplate = false;
+};
+
+/** Way from outside the mesh to a seat and back out, in mesh space. Baked by FSeatBoardingBaker. */
+USTRUCT()
+struct FSeatBoardingPath
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName SeatName;
+
+	/** Entry anchor first, the seat last. Empty if no way in was found. */
+	UPROPERTY()
+	TArray<FVector> EntryPath;
+
+	/** The seat first, exit anchor last. */
+	UPROPERTY()
+	TArray<FVector> ExitPath;
+};
+
+USTRUCT()
+struct FSeatMeshBoarding
+{
+	GENERATED_BODY()
+
+	/** Identifies the mesh geometry, seats and settings the paths were baked from. */
+	UPROPERTY()
+	FString BakeKey;
+
+	/** One per gathered seat. */
+	UPROPERTY()
+	TArray<FSeatBoardingPath> Paths;
+
+	/** Paths are baked in gathered order, the seat's index there finds its path without a search. */
+	const FSeatBoardingPath* FindPath(FName SeatName, int32 SeatIndex = INDEX_NONE) const
+	{
+		if (Paths.IsValidIndex(SeatIndex) && Paths[SeatIndex].SeatName == SeatName)
+			return &Paths[SeatIndex];
+
+		return Paths.FindByPredicate([SeatName](const FSeatBoardingPath& Path) { return Path.SeatName == SeatName; });
+	}
+};
+
+/** Directions of a fireable seat's scopes its own mesh does not block. Baked by FSeatFireArcBaker. */
+USTRUCT()
+struct FSeatFireArc
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName SeatName;
+
+	/** Mesh space point the arc was traced from. */
+	UPROPERTY()
+	FVector Origin = FVector::ZeroVector;
+
+	/** SeatBlob::FireArcWords words, one bit per cell of the scopes, set where the way is clear. */
+	UPROPERTY()
+	TArray<uint32> VisibleCells;
+};
+
+USTRUCT()
+struct FSeatMeshFireArcs
+{
+	GENERATED_BODY()
+
+	/** Identifies the mesh geometry, seats and settings the arcs were baked from. */
+	UPROPERTY()
+	FString BakeKey;
+
+	/** One per gathered fireable seat. */
+	UPROPERTY()
+	TArray<FSeatFireArc> Arcs;
+
+	const FSeatFireArc* FindArc(FName SeatName) const
+	{
+		return Arcs.FindByPredicate([SeatName](const FSeatFireArc& Arc) { return Arc.SeatName == SeatName; });
+	}
 };
 
-UCLASS()
+/** Selects seats for USeatMap::EditSeats, a seat has to pass every condition. */
+USTRUCT(BlueprintType)
+struct FSeatFilter
+{
+	GENERATED_BODY()
+
+	/**
+	 * Meshes whose seats are considered, all meshes if empty.
+	 * Template seats are considered through the meshes using the template, unless a mesh overrides them.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatFilter")
+	TArray<TSoftObjectPtr<UStaticMesh>> Meshes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatFilter", meta = (InlineEditConditionToggle))
+	bool bFilterSeatType = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatFilter", meta = (EditCondition = "bFilterSeatType"))
+	ESeatType SeatType = ESeatType::Normal;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatFilter", meta = (InlineEditConditionToggle))
+	bool bFilterPosture = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatFilter", meta = (EditCondition = "bFilterPosture"))
+	EPosture Posture = EPosture::StandUp;
+
+	/** Wildcard the seat name has to match, like Driver* or *_Left, any name if empty. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatFilter")
+	FString NamePattern;
+
+	bool Matches(const USeatSocket* Seat) const;
+};
+
+/** Changes USeatMap::EditSeats applies to every selected seat. */
+USTRUCT(BlueprintType)
+struct FSeatEdit
+{
+	GENERATED_BODY()
+
+	/** Added to the seat's relative location, in mesh space. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit")
+	FVector LocationOffset = FVector::ZeroVector;
+
+	/** Applied on top of the seat's relative rotation. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit")
+	FRotator RotationOffset = FRotator::ZeroRotator;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (InlineEditConditionToggle))
+	bool bSetSeatType = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (EditCondition = "bSetSeatType"))
+	ESeatType SeatType = ESeatType::Normal;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (InlineEditConditionToggle))
+	bool bSetPosture = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (EditCondition = "bSetPosture"))
+	EPosture Posture = EPosture::StandUp;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (InlineEditConditionToggle))
+	bool bSetYawScope = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (EditCondition = "bSetYawScope"))
+	float YawScope = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (InlineEditConditionToggle))
+	bool bSetPitchScope = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SeatEdit", meta = (EditCondition = "bSetPitchScope"))
+	float PitchScope = 0.f;
+
+	void Apply(USeatSocket* Seat) const;
+};
+
+UCLASS(BlueprintType)
 class USeatMap : public UObject, public IInterface_AssetUserData
 {
 	GENERATED_BODY()
 public:
-	void AddSeat(UStaticMesh* InStaticMesh, USeatSocket* InSeatSocket);
-	void RemoveSeat(UStaticMesh* InStaticMesh, USeatSocket* InSeatSocket);
+	void AddSeat(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeatSocket);
+	void RemoveSeat(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeatSocket);
 	FSeats& GetSeats(UStaticMesh* InStaticMesh);
+	FSeats& GetSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh);
+
+	/** Returns the seats of the mesh without adding an entry for it. */
+	const FSeats* FindSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh) const;
+
+	/** Mesh to show when the seat map is opened, the last edited one or else the first mesh with seats. */
+	TSoftObjectPtr<UStaticMesh> GetInitialMesh() const;
+
+	/** Seats of the mesh including those of its template, a mesh seat overrides the template seat of the same name. */
+	void GatherSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, TArray<FSeatInstance>& OutSeats) const;
+
+	/** Hash of everything GatherSeats reads for the mesh. */
+	uint64 ComputeSeatsHash(const TSoftObjectPtr<UStaticMesh>& InStaticMesh) const;
+
+	/** Moves the seats of a mesh without template into a new template the mesh then uses, returns its unique name. */
+	FName MakeTemplate(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, FName InTemplateName);
+
+	/** Makes the mesh use the template, NAME_None detaches it. */
+	void SetTemplate(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, FName InTemplateName,
+	                 const FTransform& InTemplateTransform);
+
+	/**
+	 * Adds a mirrored copy of each of the mesh's own seats, seats on the plane are left alone.
+	 * Left and Right or a trailing _L and _R in seat names are swapped, other names get a _Mirrored suffix.
+	 * Names taken by another seat of the mesh are numbered.
+	 *
+	 * @return		The added seats.
+	 */
+	TArray<USeatSocket*> MirrorSeats(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, const FPlane& InMirrorPlane);
+
+	/**
+	 * Makes meshes whose seats are identical share the same seat objects, so every distinct seat set is saved once.
+	 * Shared seats are copied on write through MakeSeatUnique. Call Modify and PreEditChange first,
+	 * OnSeatsReplaced tells open editors which seat objects were swapped.
+	 */
+	FSeatDeduplicationStats DeduplicateSeats();
+
+	/** Seat objects that left the seat map to an equal seat that replaced them, mapped to their replacement. */
+	DECLARE_EVENT_OneParam(USeatMap, FSeatsReplacedEvent, const TMap<USeatSocket*, USeatSocket*>&);
+	FSeatsReplacedEvent& OnSeatsReplaced() { return SeatsReplacedEvent; }
+
+	/** Call before a seat is edited through the mesh, the other meshes sharing the seat get a copy of their own. */
+	void MakeSeatUnique(const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeatSocket);
+
+	/** Seats the filter selects, each seat object once even if meshes share it. */
+	UFUNCTION(BlueprintCallable, Category = "SeatMap")
+	TArray<USeatSocket*> FilterSeats(const FSeatFilter& Filter) const;
+
+	/**
+	 * Applies the edit to every seat the filter selects in one pass and one transaction, for scripted mass fixes.
+	 * Seats shared with meshes the filter leaves out are copied first, so only the selected meshes change.
+	 * Template seats are edited once in their template, like RemoveSeat every mesh using the template changes.
+	 * Their offsets apply in template space.
+	 *
+	 * @return		Number of edited seat objects.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SeatMap")
+	int32 EditSeats(const FSeatFilter& Filter, const FSeatEdit& Edit);
+
+	/** Writes the gathered seats of every mesh as a seat blob the runtime reads in place, see SeatBlob.h. */
+	void BuildSeatBlob(TArray<uint8>& OutBlob) const;
+
+	/** Writes the seat blob with only the meshes the filter accepts. */
+	void BuildSeatBlob(TArray<uint8>& OutBlob, TFunctionRef<bool(const TSoftObjectPtr<UStaticMesh>&)> IncludeMesh) const;
+
+	/**
+	 * Drops the seats of meshes that no longer exist from a seat map saved before SoftMeshKeys.
+	 * Tagged map serialization converts the old pointer keys to soft references, a mesh that failed to load
+	 * leaves a null key behind.
+	 */
+	void FixupLegacyMeshKeys();
+
+	//~ Begin UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
+	//~ End UObject Interface
 
 	virtual void AddAssetUserData(UAssetUserData* InUserData) override;
 	virtual UAssetUserData* GetAssetUserDataOfClass(TSubclassOf<UAssetUserData> InUserDataClass) override;
 	virtual const TArray<UAssetUserData*>* GetAssetUserDataArray() const override;
 	virtual void RemoveUserDataOfClass(TSubclassOf<UAssetUserData> InUserDataClass) override;
 
+	/** Seats per mesh, keyed softly so opening the seat map does not load every mesh. */
+	UPROPERTY()
+	TMap<TSoftObjectPtr<UStaticMesh>, FSeats> SeatMap;
+
+	/** Seat layouts shared between meshes through FSeats::Template. */
 	UPROPERTY()
-	TMap<UStaticMesh*, FSeats> SeatMap;
+	TMap<FName, FSeats> Templates;
+
+	/** Baked entry and exit paths per mesh, written to the seat blob with the seats. */
+	UPROPERTY()
+	TMap<TSoftObjectPtr<UStaticMesh>, FSeatMeshBoarding> Boarding;
+
+	/** Baked firing arcs per mesh, written to the seat blob with the seats. */
+	UPROPERTY()
+	TMap<TSoftObjectPtr<UStaticMesh>, FSeatMeshFireArcs> FireArcs;
+
+#if WITH_EDITORONLY_DATA
+	/** Mesh that was shown the last time the seat map was edited. */
+	UPROPERTY()
+	TSoftObjectPtr<UStaticMesh> LastEditedMesh;
+#endif
 
 	/** Array of user data stored with the asset */
 	UPROPERTY()
 	TArray<UAssetUserData*> AssetUserData;
+
+private:
+	FSeatsReplacedEvent SeatsReplacedEvent;
 };
@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/AutomationTest.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "SeatAnalysis/SeatBoardingBaker.h"
+#include "SeatAnalysis/SeatMeshCollision.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SeatBoardingTests
+{
+	/** Collision of a mesh whose only collision is a wide, thin slab at the given height. */
+	void BuildSlab(FSeatMeshCollision& OutCollision, float Height)
+	{
+		UStaticMesh* StaticMesh = NewObject<UStaticMesh>(GetTransientPackage());
+		StaticMesh->CreateBodySetup();
+
+		FKBoxElem Slab(400.f, 400.f, 20.f);
+		Slab.Center = FVector(0.f, 0.f, Height);
+		StaticMesh->GetBodySetup()->AggGeom.BoxElems.Add(Slab);
+
+		OutCollision.Build(StaticMesh);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSeatBoardingOverhangTest, "CustomSocket.SeatMap.BoardingOverhang",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSeatBoardingOverhangTest::RunTest(const FString& Parameters)
+{
+	// A standing occupant 176 high, the path runs at the center of its bottom sphere just above the ground.
+	const float Radius = 32.f;
+	const float Clearance = 34.f;
+	const float SegmentHeight = 108.f;
+	const TArray<FVector> Path = {FVector(-300.f, 0.f, Clearance), FVector(300.f, 0.f, Clearance)};
+
+	// At head height the slab is well above the feet, it blocks the way all the same.
+	FSeatMeshCollision Overhang;
+	SeatBoardingTests::BuildSlab(Overhang, 130.f);
+	TestFalse(TEXT("Path under a low overhang is clear"),
+	          FSeatBoardingBaker::IsPathClear(Overhang, Path, Radius, SegmentHeight));
+
+	FSeatMeshCollision Roof;
+	SeatBoardingTests::BuildSlab(Roof, 300.f);
+	TestTrue(TEXT("Path under a high roof is clear"), FSeatBoardingBaker::IsPathClear(Roof, Path, Radius, SegmentHeight));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,56 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/AutomationTest.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "SeatAnalysis/SeatBoardingBaker.h"
+#include "SeatAnalysis/SeatMeshCollision.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSeatCabinHullTest, "CustomSocket.SeatMap.SeatInsideCabinHull",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSeatCabinHullTest::RunTest(const FString& Parameters)
+{
+	// The whole vehicle is one collision box from the ground up to 250.
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(GetTransientPackage());
+	StaticMesh->CreateBodySetup();
+
+	FKBoxElem Cabin(400.f, 300.f, 250.f);
+	Cabin.Center = FVector(0.f, 0.f, 125.f);
+	StaticMesh->GetBodySetup()->AggGeom.BoxElems.Add(Cabin);
+
+	FSeatMeshCollision Collision;
+	Collision.Build(StaticMesh);
+
+	// A standing occupant in the middle of the cabin, 176 high.
+	const float Radius = 32.f;
+	const FVector Start(0.f, 0.f, 34.f);
+	const FVector End(0.f, 0.f, 142.f);
+	const TBitArray<> CabinHulls = Collision.FindEnclosingHulls((Start + End) * 0.5f);
+	TestEqual(TEXT("Hulls around the seat"), CabinHulls.CountSetBits(), 1);
+
+	FVector Contact;
+	TestTrue(TEXT("Seat buried in a solid box"), Collision.OverlapCapsule(Start, End, Radius, Contact));
+	TestFalse(TEXT("Seat inside the cabin clips"), Collision.OverlapCapsule(Start, End, Radius, Contact, &CabinHulls));
+
+	// Only the walls count, a seat against the roof still clips.
+	const FVector Raised(0.f, 0.f, 100.f);
+	TestTrue(TEXT("Seat through the cabin roof clips"),
+	         Collision.OverlapCapsule(Start + Raised, End + Raised, Radius, Contact, &CabinHulls));
+
+	const FVector Eye(0.f, 0.f, 140.f);
+	TestFalse(TEXT("Sight line out of the cabin is blocked"),
+	          Collision.LineTrace(Eye, Eye + FVector(1000.f, 0.f, 0.f), &CabinHulls));
+
+	const TArray<FVector> Path = {FVector(500.f, 0.f, 34.f), Start};
+	TestTrue(TEXT("Way into the cabin is clear"),
+	         FSeatBoardingBaker::IsPathClear(Collision, Path, Radius, End.Z - Start.Z, &CabinHulls));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
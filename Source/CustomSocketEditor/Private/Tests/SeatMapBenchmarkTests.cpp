@@ -0,0 +1,270 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "CustomSocketEditor.h"
+#include "Editor.h"
+#include "ScopedTransaction.h"
+#include "SeatPreviewComponent.h"
+#include "SeatPreviewWorld.h"
+#include "Dom/JsonObject.h"
+#include "Editor/TransBuffer.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SeatSocket/SeatSocket.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Widgets/SCustomSocketManager.h"
+#include "Widgets/SeatListModel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define LOCTEXT_NAMESPACE "SeatMapBenchmarkTests"
+
+/**
+ * Times the seat editing operations on synthetic seat maps, headless runs use
+ * UE4Editor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests CustomSocket.Benchmark; Quit"
+ * Each case writes its timings as JSON to Saved/Automation/CustomSocketBenchmark and logs the same line.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FSeatMapBenchmarkTest, "CustomSocket.Benchmark",
+                                  EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace SeatMapBenchmark
+{
+	/** Seats and meshes of each case, seats are spread evenly over the meshes. */
+	const FIntPoint Cases[] = {{1, 1}, {100, 10}, {1000, 100}, {10000, 1}, {10000, 500}};
+
+	TSoftObjectPtr<UStaticMesh> GetMesh(int32 MeshIndex)
+	{
+		// Seats are keyed softly, the meshes do not have to exist.
+		const FString Path = FString::Printf(TEXT("/Game/SeatBenchmark/Mesh_%d.Mesh_%d"), MeshIndex, MeshIndex);
+		return TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(Path));
+	}
+
+	/** Times the scope into the results under the given name, in milliseconds. */
+	struct FScopedTimer
+	{
+		FScopedTimer(const TSharedRef<FJsonObject>& InTimings, const FString& InName)
+			: Timings(InTimings)
+			, Name(InName)
+			, StartTime(FPlatformTime::Seconds())
+		{
+		}
+
+		~FScopedTimer()
+		{
+			Timings->SetNumberField(Name, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+
+		TSharedRef<FJsonObject> Timings;
+		FString Name;
+		double StartTime;
+	};
+
+	/** Drops the benchmark's transactions from the end of the undo history, the editor's own stay. */
+	void RemoveTransactions(const USeatMap* SeatMap)
+	{
+		UTransBuffer* TransBuffer = GEditor ? Cast<UTransBuffer>(GEditor->Trans) : nullptr;
+		if (!TransBuffer)
+			return;
+
+		int32 NumRemoved = 0;
+		while (TransBuffer->UndoBuffer.Num() > 0)
+		{
+			const UObject* PrimaryObject = TransBuffer->UndoBuffer.Last()->GetContext().PrimaryObject;
+			if (!PrimaryObject || (PrimaryObject != SeatMap && !PrimaryObject->IsIn(SeatMap)))
+				break;
+
+			TransBuffer->UndoBuffer.Pop();
+			++NumRemoved;
+		}
+
+		if (NumRemoved > 0)
+		{
+			TransBuffer->UndoCount = FMath::Max(TransBuffer->UndoCount - NumRemoved, 0);
+			TransBuffer->OnUndoBufferChanged().Broadcast();
+		}
+	}
+}
+
+void FSeatMapBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FIntPoint& Case : SeatMapBenchmark::Cases)
+	{
+		const FString Command = FString::Printf(TEXT("%d %d"), Case.X, Case.Y);
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%d Seats on %d Meshes"), Case.X, Case.Y));
+		OutTestCommands.Add(Command);
+	}
+}
+
+bool FSeatMapBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace SeatMapBenchmark;
+
+	FString NumSeatsString;
+	FString NumMeshesString;
+	if (!Parameters.Split(TEXT(" "), &NumSeatsString, &NumMeshesString))
+	{
+		AddError(FString::Printf(TEXT("Invalid parameters '%s'."), *Parameters));
+		return false;
+	}
+
+	const int32 NumSeats = FCString::Atoi(*NumSeatsString);
+	const int32 NumMeshes = FMath::Max(FCString::Atoi(*NumMeshesString), 1);
+	const TSharedRef<FJsonObject> Timings = MakeShared<FJsonObject>();
+
+	USeatMap* SeatMap;
+	TArray<USeatSocket*> CreatedSeats;
+	{
+		FScopedTimer Timer(Timings, TEXT("Create"));
+
+		SeatMap = NewObject<USeatMap>(GetTransientPackage(), NAME_None, RF_Transactional);
+		for (int32 SeatIndex = 0; SeatIndex < NumSeats; ++SeatIndex)
+		{
+			USeatSocket* Seat = NewObject<USeatSocket>(SeatMap, NAME_None, RF_Transactional);
+			Seat->Name = FName(TEXT("Seat"), SeatIndex + 1);
+			Seat->RelativeLocation = FVector(SeatIndex * 10.f, 0.f, 0.f);
+			Seat->Posture = static_cast<EPosture>(SeatIndex % 3);
+			Seat->SeatType = static_cast<ESeatType>(SeatIndex % 2);
+			SeatMap->GetSeats(GetMesh(SeatIndex % NumMeshes)).Seats.Add(Seat);
+			CreatedSeats.Add(Seat);
+		}
+	}
+
+	{
+		FScopedTimer Timer(Timings, TEXT("Duplicate"));
+
+		const FScopedTransaction Transaction(LOCTEXT("DuplicateSeats", "Duplicate Seats"));
+		SeatMap->PreEditChange(NULL);
+		for (int32 SeatIndex = 0; SeatIndex < CreatedSeats.Num(); ++SeatIndex)
+		{
+			USeatSocket* Copy = DuplicateObject(CreatedSeats[SeatIndex], SeatMap);
+			Copy->Name = FName(TEXT("SeatCopy"), SeatIndex + 1);
+			SeatMap->GetSeats(GetMesh(SeatIndex % NumMeshes)).Seats.Add(Copy);
+		}
+		SeatMap->PostEditChange();
+	}
+
+	if (GEditor && GEditor->Trans)
+	{
+		FScopedTimer Timer(Timings, TEXT("Undo"));
+		GEditor->UndoTransaction(false);
+	}
+
+	int32 NumSeatsAfterUndo = 0;
+	for (const TPair<TSoftObjectPtr<UStaticMesh>, FSeats>& Pair : SeatMap->SeatMap)
+	{
+		NumSeatsAfterUndo += Pair.Value.Seats.Num();
+	}
+	if (GEditor && GEditor->Trans)
+	{
+		TestEqual(TEXT("Seats after undoing the duplication"), NumSeatsAfterUndo, NumSeats);
+	}
+
+	{
+		FScopedTimer Timer(Timings, TEXT("Rename"));
+
+		// One transaction per seat, as committing a name in the seat list does.
+		for (int32 SeatIndex = 0; SeatIndex < CreatedSeats.Num(); ++SeatIndex)
+		{
+			const FScopedTransaction Transaction(LOCTEXT("RenameSeat", "Set Socket Name"));
+			USeatSocket* Seat = CreatedSeats[SeatIndex];
+			SCustomSocketManager::RenameSeat(SeatMap, GetMesh(SeatIndex % NumMeshes), Seat,
+			                                 FName(TEXT("Renamed"), Seat->Name.GetNumber()));
+		}
+	}
+
+	{
+		FScopedTimer Timer(Timings, TEXT("ListRefresh"));
+
+		// Shows every mesh in turn, then filters the last one, as the seat list does when switching meshes.
+		FSeatListModel SeatListModel;
+		TArray<FSeatInstance> Seats;
+		for (int32 MeshIndex = 0; MeshIndex < NumMeshes; ++MeshIndex)
+		{
+			SeatMap->GatherSeats(GetMesh(MeshIndex), Seats);
+			SeatListModel.Update(Seats);
+		}
+		SeatListModel.SetFilterText(TEXT("Renamed_1"));
+		SeatListModel.SetFilterText(FString());
+	}
+
+	{
+		FScopedTimer Timer(Timings, TEXT("Export"));
+
+		TArray<FSeatInstance> Seats;
+		for (int32 MeshIndex = 0; MeshIndex < NumMeshes; ++MeshIndex)
+		{
+			SeatMap->GatherSeats(GetMesh(MeshIndex), Seats);
+			SCustomSocketManager::ExportSeats(Seats);
+		}
+	}
+
+	{
+		FScopedTimer Timer(Timings, TEXT("PreviewRebuild"));
+
+		// Previews of the first mesh, the one the editor opens on.
+		const TSharedRef<FSeatPreviewWorld> PreviewWorld = FSeatPreviewWorld::Get();
+		TArray<FSeatInstance> Seats;
+		SeatMap->GatherSeats(GetMesh(0), Seats);
+
+		TArray<USeatPreviewComponent*> SeatPreviewComponents;
+		for (const FSeatInstance& Instance : Seats)
+		{
+			USeatPreviewComponent* SeatPreviewComponent = NewObject<USeatPreviewComponent>(GetTransientPackage());
+			SeatPreviewComponent->SetPosePool(PreviewWorld->GetPosePool());
+			SeatPreviewComponent->SetSeatSocket(Instance.Seat);
+			PreviewWorld->AddComponent(this, SeatPreviewComponent->GetPreviewComponent(), Instance.Transform);
+			SeatPreviewComponents.Add(SeatPreviewComponent);
+		}
+
+		PreviewWorld->RemoveComponents(this);
+		for (USeatPreviewComponent* SeatPreviewComponent : SeatPreviewComponents)
+		{
+			SeatPreviewComponent->DestroyComponent();
+		}
+	}
+
+	{
+		FScopedTimer Timer(Timings, TEXT("Delete"));
+
+		const FScopedTransaction Transaction(LOCTEXT("DeleteSeats", "Delete Seats"));
+		SeatMap->PreEditChange(NULL);
+		for (int32 SeatIndex = 0; SeatIndex < CreatedSeats.Num(); ++SeatIndex)
+		{
+			SeatMap->GetSeats(GetMesh(SeatIndex % NumMeshes)).Seats.Remove(CreatedSeats[SeatIndex]);
+		}
+		SeatMap->PostEditChange();
+	}
+
+	// The editor's undo history must not point into the benchmark's transient seat map.
+	RemoveTransactions(SeatMap);
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("Test"), TEXT("CustomSocket.Benchmark"));
+	Result->SetNumberField(TEXT("Seats"), NumSeats);
+	Result->SetNumberField(TEXT("Meshes"), NumMeshes);
+	Result->SetObjectField(TEXT("TimingsMs"), Timings);
+
+	FString ResultString;
+	const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ResultString);
+	FJsonSerializer::Serialize(Result, Writer);
+
+	UE_LOG(LogCustomSocket, Display, TEXT("CustomSocketBenchmark %s"), *ResultString);
+
+	const FString ResultPath = FPaths::ProjectSavedDir() / TEXT("Automation/CustomSocketBenchmark") /
+		FString::Printf(TEXT("Seats%d_Meshes%d.json"), NumSeats, NumMeshes);
+	if (!FFileHelper::SaveStringToFile(ResultString, *ResultPath))
+	{
+		AddWarning(FString::Printf(TEXT("Could not write %s."), *ResultPath));
+	}
+
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
+
+#endif // WITH_DEV_AUTOMATION_TESTS
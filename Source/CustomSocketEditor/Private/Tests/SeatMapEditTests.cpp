@@ -0,0 +1,48 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/AutomationTest.h"
+#include "SeatSocket/SeatSocket.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSeatMapEditTemplateSeatsTest, "CustomSocket.SeatMap.EditTemplateSeats",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSeatMapEditTemplateSeatsTest::RunTest(const FString& Parameters)
+{
+	USeatMap* SeatMap = NewObject<USeatMap>(GetTransientPackage(), NAME_None, RF_Transactional);
+	const TSoftObjectPtr<UStaticMesh> StaticMesh(FSoftObjectPath(TEXT("/Game/Tests/SeatEdit.SeatEdit")));
+
+	// The mesh has no seats of its own, all of them come from the template.
+	USeatSocket* TemplateSeat = NewObject<USeatSocket>(SeatMap, NAME_None, RF_Transactional);
+	TemplateSeat->Name = TEXT("Gunner");
+	TemplateSeat->Posture = EPosture::StandUp;
+	SeatMap->Templates.Add(TEXT("Cabin")).Seats.Add(TemplateSeat);
+	SeatMap->GetSeats(StaticMesh).Template = TEXT("Cabin");
+
+	FSeatFilter Filter;
+	Filter.Meshes.Add(StaticMesh);
+	Filter.NamePattern = TEXT("Gun*");
+
+	TestEqual(TEXT("Filtered template seats"), SeatMap->FilterSeats(Filter).Num(), 1);
+
+	FSeatEdit Edit;
+	Edit.bSetPosture = true;
+	Edit.Posture = EPosture::SquatDown;
+	TestEqual(TEXT("Edited seats"), SeatMap->EditSeats(Filter, Edit), 1);
+
+	TArray<FSeatInstance> Seats;
+	SeatMap->GatherSeats(StaticMesh, Seats);
+	if (!TestEqual(TEXT("Seats of the mesh"), Seats.Num(), 1))
+		return false;
+
+	TestTrue(TEXT("The seat still comes from the template"), Seats[0].bFromTemplate);
+	TestTrue(TEXT("The template seat squats"), Seats[0].Seat->Posture == EPosture::SquatDown);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,17 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SeatSocket/SeatSocket.h"
+#include "SeatMapLegacyFormat.generated.h"
+
+/** USeatMap::SeatMap as it was saved before FSeatMapCustomVersion::SoftMeshKeys, tests write old data with it. */
+USTRUCT()
+struct FSeatMapLegacyFormat
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TMap<UStaticMesh*, FSeats> SeatMap;
+};
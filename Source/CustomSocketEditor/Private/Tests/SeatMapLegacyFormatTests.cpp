@@ -0,0 +1,93 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatMapLegacyFormat.h"
+
+#include "CoreMinimal.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/AutomationTest.h"
+#include "SeatSocket/SeatSocket.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSeatMapLegacyMeshKeysTest, "CustomSocket.SeatMap.LegacyMeshKeys",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+namespace SeatMapLegacyFormat
+{
+	/** Stores object references as pointers, the data is read back in the same session. */
+	class FWriter : public FMemoryWriter
+	{
+	public:
+		FWriter(TArray<uint8>& InBytes)
+			: FMemoryWriter(InBytes)
+		{
+		}
+
+		virtual FArchive& operator<<(UObject*& Object) override
+		{
+			UPTRINT Pointer = reinterpret_cast<UPTRINT>(Object);
+			return *this << Pointer;
+		}
+	};
+
+	class FReader : public FMemoryReader
+	{
+	public:
+		FReader(const TArray<uint8>& InBytes)
+			: FMemoryReader(InBytes)
+		{
+		}
+
+		virtual FArchive& operator<<(UObject*& Object) override
+		{
+			UPTRINT Pointer = 0;
+			*this << Pointer;
+			Object = reinterpret_cast<UObject*>(Pointer);
+			return *this;
+		}
+	};
+}
+
+bool FSeatMapLegacyMeshKeysTest::RunTest(const FString& Parameters)
+{
+	using namespace SeatMapLegacyFormat;
+
+	USeatMap* SeatMap = NewObject<USeatMap>(GetTransientPackage());
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(GetTransientPackage());
+
+	USeatSocket* Seat = NewObject<USeatSocket>(SeatMap);
+	Seat->Name = TEXT("Driver");
+	USeatSocket* MissingMeshSeat = NewObject<USeatSocket>(SeatMap);
+	MissingMeshSeat->Name = TEXT("Gunner");
+
+	// A mesh deleted since the seat map was saved loads as a null key.
+	FSeatMapLegacyFormat Legacy;
+	Legacy.SeatMap.Add(StaticMesh).Seats.Add(Seat);
+	Legacy.SeatMap.Add(nullptr).Seats.Add(MissingMeshSeat);
+
+	TArray<uint8> Bytes;
+	FWriter Writer(Bytes);
+	UScriptStruct* LegacyStruct = FSeatMapLegacyFormat::StaticStruct();
+	LegacyStruct->SerializeTaggedProperties(Writer, reinterpret_cast<uint8*>(&Legacy), LegacyStruct, nullptr);
+
+	FReader Reader(Bytes);
+	USeatMap::StaticClass()->SerializeTaggedProperties(Reader, reinterpret_cast<uint8*>(SeatMap),
+	                                                   USeatMap::StaticClass(), nullptr);
+	SeatMap->FixupLegacyMeshKeys();
+
+	TestEqual(TEXT("Meshes after loading"), SeatMap->SeatMap.Num(), 1);
+
+	const FSeats* Seats = SeatMap->FindSeats(StaticMesh);
+	if (!TestNotNull(TEXT("Seats found by the soft mesh reference"), Seats))
+		return false;
+
+	TestEqual(TEXT("Seats of the mesh"), Seats->Seats.Num(), 1);
+	TestTrue(TEXT("The mesh keeps its seat object"), Seats->Seats.Num() == 1 && Seats->Seats[0] == Seat);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
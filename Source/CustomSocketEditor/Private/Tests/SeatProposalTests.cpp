@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/AutomationTest.h"
+#include "SeatAnalysis/SeatCandidateGenerator.h"
+#include "SeatSocket/SeatSocket.h"
+#include "Widgets/SCustomSocketManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSeatProposalUniqueNamesTest, "CustomSocket.SeatMap.ProposedSeatNames",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSeatProposalUniqueNamesTest::RunTest(const FString& Parameters)
+{
+	USeatMap* SeatMap = NewObject<USeatMap>(GetTransientPackage());
+	const TSoftObjectPtr<UStaticMesh> StaticMesh(FSoftObjectPath(TEXT("/Game/Tests/SeatProposal.SeatProposal")));
+
+	// A hand placed seat already takes the first proposed name.
+	USeatSocket* PlacedSeat = NewObject<USeatSocket>(SeatMap);
+	PlacedSeat->Name = TEXT("Seat");
+	PlacedSeat->RelativeLocation = FVector(-10000.f, 0.f, 0.f);
+	SeatMap->AddSeat(StaticMesh, PlacedSeat);
+
+	// Spread far enough apart that no candidate overlaps another.
+	TArray<FSeatCandidate> Candidates;
+	for (int32 Index = 0; Index < 3; ++Index)
+	{
+		FSeatCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+		Candidate.Transform.SetLocation(FVector(Index * 10000.f, 0.f, 0.f));
+	}
+
+	const TArray<USeatSocket*> AddedSeats = SCustomSocketManager::AddSeatCandidates(SeatMap, StaticMesh, Candidates);
+	TestEqual(TEXT("Proposed seats"), AddedSeats.Num(), Candidates.Num());
+
+	TArray<FSeatInstance> Seats;
+	SeatMap->GatherSeats(StaticMesh, Seats);
+	TestEqual(TEXT("Seats of the mesh"), Seats.Num(), Candidates.Num() + 1);
+
+	TSet<FName> Names;
+	for (const FSeatInstance& Instance : Seats)
+	{
+		bool bAlreadyUsed = false;
+		Names.Add(Instance.Seat->Name, &bAlreadyUsed);
+		TestFalse(FString::Printf(TEXT("Name %s used once"), *Instance.Seat->Name.ToString()), bAlreadyUsed);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -3,18 +3,73 @@
 
 #include "Widgets/SCustomSocketEditorWidget.h"
 
+#include "ContentBrowserModule.h"
 #include "CustomSocketEditor.h"
+#include "CustomSocketStats.h"
+#include "EditorStyleSet.h"
+#include "IContentBrowserSingleton.h"
 #include "ISocketManager.h"
 #include "LevelEditor.h"
+#include "Logging/MessageLog.h"
 #include "SCustomSocketManager.h"
 #include "SlateOptMacros.h"
 #include "StaticMeshEditorModule.h"
 #include "PropertyCustomizationHelpers.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "SeatGizmoComponent.h"
+#include "SeatPosePool.h"
+#include "SeatPreviewWorld.h"
+#include "SeatPreviewRebuildScheduler.h"
 
 #define LOCTEXT_NAMESPACE "SocketEditor"
 
 const FName CustomSocketEditorAppIdentifier = FName(TEXT("CustomSocketEditorApp"));
 
+namespace SeatMeshPane
+{
+	/** Gap between tiled meshes. */
+	const float TileSpacing = 50.f;
+}
+
+/** Views the shared preview world but leaves out what other seat map editors placed in it. */
+class FSeatEditorViewportClient : public FEditorViewportClient
+{
+public:
+	FSeatEditorViewportClient(const TSharedRef<FSeatPreviewWorld>& InPreviewWorld, const void* InOwner,
+	                          const TSharedRef<SEditorViewport>& InEditorViewport)
+		: FEditorViewportClient(nullptr, InPreviewWorld->GetScene(), InEditorViewport)
+		, PreviewWorld(InPreviewWorld)
+		, Owner(InOwner)
+	{
+	}
+
+	virtual FSceneView* CalcSceneView(FSceneViewFamily* ViewFamily, const EStereoscopicPass StereoPass) override
+	{
+		FSceneView* View = FEditorViewportClient::CalcSceneView(ViewFamily, StereoPass);
+		PreviewWorld->GetHiddenPrimitives(Owner, View->HiddenPrimitives);
+		return View;
+	}
+
+	virtual void Tick(float DeltaSeconds) override
+	{
+		// The base ticks the preview scene's world, which every open editor shares, so it is ticked here once.
+		FPreviewScene* SharedScene = PreviewScene;
+		PreviewScene = nullptr;
+		FEditorViewportClient::Tick(DeltaSeconds);
+		PreviewScene = SharedScene;
+
+		if (!GIntraFrameDebuggingGameThread)
+		{
+			PreviewWorld->Tick(IsRealtime() ? LEVELTICK_ViewportsOnly : LEVELTICK_TimeOnly, DeltaSeconds);
+		}
+	}
+
+private:
+	TSharedRef<FSeatPreviewWorld> PreviewWorld;
+	const void* Owner;
+};
+
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 FStaticMeshSocketEditor::FStaticMeshSocketEditor(const FLinearColor& InWorldCentricTabColorScale,
@@ -25,16 +80,12 @@ FStaticMeshSocketEditor::FStaticMeshSocketEditor(const FLinearColor& InWorldCent
                                                  const EViewModeIndex ViewMode):
 	WorldCentricTabColorScale(InWorldCentricTabColorScale),
 	StaticMesh(InStaticMesh),
+	EditedMesh(InStaticMesh.Get()),
 	StaticMeshComponent(InStaticMeshComponent),
 	SelectedSockets(InSelectedSockets),
 	MutlipleSelect(InMutlipleSelect),
 	ViewMode(ViewMode)
 {
-	for (TObjectIterator<UStaticMesh> It; It; ++It)
-	{
-		StaticMesh = *It;
-		break;
-	}
 }
 
 void FStaticMeshSocketEditor::InitSocketEditor()
@@ -52,16 +103,99 @@ void FStaticMeshSocketEditor::InitSocketEditor()
 			)
 		);
 
+	UObject* ObjectToEdit = SeatMap ? static_cast<UObject*>(SeatMap) : StaticMesh.Get();
 	FAssetEditorToolkit::InitAssetEditor(EToolkitMode::Standalone, nullptr,
 	                                     CustomSocketEditorAppIdentifier,
 	                                     DefaultLayout, true, true,
-	                                     StaticMesh.Get());
+	                                     ObjectToEdit);
+
+	if (!StaticMesh.IsValid() && !InitialMesh.IsNull())
+	{
+		LoadStaticMesh(InitialMesh);
+	}
+}
+
+void FStaticMeshSocketEditor::LoadStaticMesh(const TSoftObjectPtr<UStaticMesh>& InStaticMesh)
+{
+	if (InStaticMesh.IsNull() || InStaticMesh.IsValid())
+	{
+		SetStaticMesh(InStaticMesh.Get());
+		return;
+	}
+
+	// A mesh picked while another one streams in replaces it, the earlier one is not shown anymore.
+	CancelStaticMeshLoad();
+
+	StaticMesh = nullptr;
+	EditedMesh = InStaticMesh;
+	if (SeatMap)
+	{
+		SeatMap->LastEditedMesh = InStaticMesh;
+	}
+
+	// Seats are keyed by the mesh path, the seat list and the seat previews do not wait for the mesh.
+	OnStaticMeshChanged.Broadcast(nullptr);
+
+	StaticMeshHandle = StreamableManager.RequestAsyncLoad(
+		InStaticMesh.ToSoftObjectPath(),
+		FStreamableDelegate::CreateSP(this, &FStaticMeshSocketEditor::OnStaticMeshLoaded));
+}
+
+void FStaticMeshSocketEditor::OnStaticMeshLoaded()
+{
+	StaticMeshHandle.Reset();
+
+	UStaticMesh* LoadedMesh = EditedMesh.Get();
+	if (LoadedMesh)
+	{
+		SetStaticMesh(LoadedMesh);
+		return;
+	}
+
+	// A missing or redirected package, the seats stay editable by the mesh path without a preview of the mesh.
+	UE_LOG(LogCustomSocket, Warning, TEXT("Failed to load static mesh %s."), *EditedMesh.ToString());
+
+	FMessageLog MessageLog("CustomSocket");
+	MessageLog.Warning(FText::Format(LOCTEXT("StaticMeshLoadFailed", "Failed to load static mesh {0}."),
+	                                 FText::FromString(EditedMesh.ToString())));
+	MessageLog.Notify(LOCTEXT("StaticMeshLoadFailedNotify", "Failed to load the static mesh"));
+
+	OnStaticMeshChanged.Broadcast(nullptr);
+}
+
+void FStaticMeshSocketEditor::CancelStaticMeshLoad()
+{
+	if (StaticMeshHandle.IsValid())
+	{
+		StaticMeshHandle->CancelHandle();
+		StaticMeshHandle.Reset();
+	}
+}
+
+bool FStaticMeshSocketEditor::IsLoadingStaticMesh() const
+{
+	return StaticMeshHandle.IsValid() && StaticMeshHandle->IsLoadingInProgress();
 }
 
 void FStaticMeshSocketEditor::SetStaticMesh(UStaticMesh* InStaticMesh)
 {
+	CancelStaticMeshLoad();
+
 	StaticMesh = InStaticMesh;
-	StaticMeshComponent->SetStaticMesh(StaticMesh.Get());
+	EditedMesh = InStaticMesh;
+
+	// Only set when editing a component's mesh, seat map editors preview the mesh in their viewport.
+	if (StaticMeshComponent.IsValid())
+	{
+		StaticMeshComponent->SetStaticMesh(StaticMesh.Get());
+	}
+
+	if (SeatMap && InStaticMesh)
+	{
+		// Remembered for the next time the seat map is opened, this alone does not dirty the package.
+		SeatMap->LastEditedMesh = InStaticMesh;
+	}
+
 	OnStaticMeshChanged.Broadcast(StaticMesh.Get());
 }
 
@@ -70,6 +204,20 @@ UStaticMesh* FStaticMeshSocketEditor::GetStaticMesh() const
 	return StaticMesh.Get();
 }
 
+void FStaticMeshSocketEditor::SetSelectedSeat(USeatSocket* InSelectedSeat)
+{
+	if (SelectedSeat.Get() == InSelectedSeat)
+		return;
+
+	SelectedSeat = InSelectedSeat;
+	OnSeatSelectionChanged.Broadcast(InSelectedSeat);
+}
+
+USeatSocket* FStaticMeshSocketEditor::GetSelectedSeat() const
+{
+	return SelectedSeat.Get();
+}
+
 const FName FStaticMeshSocketEditor::CustomSocketEditorViewportTabId(
 	TEXT("CustomSocketEditor_CustomSocketEditorViewport"));
 const FName FStaticMeshSocketEditor::CustomSocketEditorStaticMeshPickerTabId(
@@ -120,14 +268,10 @@ FStaticMeshSocketEditor::FStaticMeshSocketEditor(USeatMap* InSeatMap, UWorld* In
 	World(InWorld),
 	SeatMap(InSeatMap)
 {
-	for (TObjectIterator<UStaticMesh> It; It; ++It)
-	{
-		StaticMesh = *It;
-		break;
-	}
-
-	StaticMeshComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), NAME_None, RF_Transient);
-	StaticMeshComponent->SetStaticMesh(StaticMesh.Get());
+	// Only the initial mesh of the seat map is considered, it is streamed in by InitSocketEditor if needed.
+	InitialMesh = SeatMap ? SeatMap->GetInitialMesh() : TSoftObjectPtr<UStaticMesh>();
+	StaticMesh = InitialMesh.Get();
+	EditedMesh = InitialMesh;
 }
 
 FLinearColor FStaticMeshSocketEditor::GetWorldCentricTabColorScale() const
@@ -156,11 +300,17 @@ void SCustomSocketEditorWidget::Construct(const FArguments& InArgs)
 	SeatMap = InArgs._SeatMap;
 	StaticMeshSocketEditor = InArgs._StaticMeshSocketEditor;
 
-	PreviewScene = MakeShareable(new FAdvancedPreviewScene(FPreviewScene::ConstructionValues()));
+	PreviewWorld = FSeatPreviewWorld::Get();
+	RebuildScheduler = MakeUnique<FSeatPreviewRebuildScheduler>(
+		FBuildSeatPreview::CreateSP(this, &SCustomSocketEditorWidget::CreateSeatPreviewComponent));
 	StaticMeshComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), NAME_None, RF_Transient);
 	StaticMeshComponent->SetStaticMesh(StaticMesh);
 
-	PreviewScene->AddComponent(StaticMeshComponent, FTransform::Identity);
+	PreviewWorld->AddComponent(this, StaticMeshComponent, FTransform::Identity);
+
+	SeatGizmoComponent = NewObject<USeatGizmoComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+	SeatGizmoComponent->SetVisibility(bShowSeatGizmos);
+	PreviewWorld->AddComponent(this, SeatGizmoComponent, FTransform::Identity);
 
 	SEditorViewport::Construct(SEditorViewport::FArguments());
 
@@ -168,25 +318,98 @@ void SCustomSocketEditorWidget::Construct(const FArguments& InArgs)
 	[
 		SNew(SVerticalBox)
 		+ SVerticalBox::Slot()
+		.AutoHeight()
 		.VAlign(VAlign_Top)
 		[
 			SNew(SObjectPropertyEntryBox).AllowedClass(UStaticMesh::StaticClass()).ObjectPath_Lambda([this]()
 			                             {
-				                             return StaticMesh ? StaticMesh->GetPathName() : FString();
+				                             return StaticMeshSocketEditor->GetEditedMesh().ToString();
 			                             })
 			                             .OnObjectChanged_Lambda([this](const FAssetData& AssetData)
 			                             {
-				                             SetStaticMesh(Cast<UStaticMesh>(AssetData.GetAsset()));
+				                             // Large meshes would stall the editor, they stream in while their seats are edited.
+				                             StaticMeshSocketEditor->LoadStaticMesh(
+					                             TSoftObjectPtr<UStaticMesh>(AssetData.ToSoftObjectPath()));
 			                             })
 		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.VAlign(VAlign_Top)
+		.Padding(0, 4, 0, 0)
+		[
+			SNew(SHorizontalBox)
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(0, 0, 4, 0)
+			[
+				SNew(SButton)
+				.ButtonStyle(FEditorStyle::Get(), "FlatButton.Primary")
+				.ForegroundColor(FLinearColor::White)
+				.Text(LOCTEXT("CompareMeshes", "Compare Selected"))
+				.ToolTipText(LOCTEXT("CompareMeshesTooltip", "Shows the static meshes selected in the Content Browser and their seats next to this mesh."))
+				.OnClicked(this, &SCustomSocketEditorWidget::CompareSelectedMeshes_Execute)
+				.HAlign(HAlign_Center)
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(0, 0, 4, 0)
+			[
+				SNew(SButton)
+				.ButtonStyle(FEditorStyle::Get(), "FlatButton.Primary")
+				.ForegroundColor(FLinearColor::White)
+				.Text(LOCTEXT("ClearCompareMeshes", "Clear"))
+				.OnClicked(this, &SCustomSocketEditorWidget::ClearCompareMeshes_Execute)
+				.HAlign(HAlign_Center)
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &SCustomSocketEditorWidget::GetCompareOverlaidState)
+				.OnCheckStateChanged(this, &SCustomSocketEditorWidget::OnCompareOverlaidChanged)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("CompareOverlaid", "Overlay"))
+				]
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(8, 0, 0, 0)
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &SCustomSocketEditorWidget::GetShowSeatGizmosState)
+				.OnCheckStateChanged(this, &SCustomSocketEditorWidget::OnShowSeatGizmosChanged)
+				.ToolTipText(LOCTEXT("SeatGizmoOverviewTooltip", "Draws every seat as a lightweight gizmo, only the selected seat keeps its skeletal preview."))
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("SeatGizmoOverview", "Seat Gizmo Overview"))
+				]
+			]
+		]
+	];
+
+	ViewportOverlay->AddSlot()
+	.HAlign(HAlign_Center)
+	.VAlign(VAlign_Center)
+	[
+		SNew(STextBlock)
+		.Visibility(this, &SCustomSocketEditorWidget::GetLoadingMeshVisibility)
+		.Text(this, &SCustomSocketEditorWidget::GetLoadingMeshText)
 	];
 
+	StaticMeshSocketEditor->OnStaticMeshChanged.AddSP(this, &SCustomSocketEditorWidget::OnStaticMeshChanged);
+	StaticMeshSocketEditor->OnSeatSelectionChanged.AddSP(this, &SCustomSocketEditorWidget::OnSocketSelectionChanged);
 	FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &SCustomSocketEditorWidget::OnObjectPropertyChanged);
 }
 
 SCustomSocketEditorWidget::SCustomSocketEditorWidget()
-	: PreviewScene(nullptr),
-	  StaticMesh(nullptr),
+	: StaticMesh(nullptr),
 	  CurrentViewMode(VMI_Lit),
 	  LODSelection(0),
 	  StaticMeshComponent(nullptr)
@@ -195,6 +418,21 @@ SCustomSocketEditorWidget::SCustomSocketEditorWidget()
 
 SCustomSocketEditorWidget::~SCustomSocketEditorWidget()
 {
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+
+	if (!PreviewWorld.IsValid())
+		return;
+
+	// The scene outlives this editor when others are open, take back everything placed in it.
+	RebuildScheduler.Reset();
+	for (USeatPreviewComponent* SeatPreviewComponent : SeatPreviewComponents)
+	{
+		PreviewWorld->RemoveComponent(SeatPreviewComponent->GetPreviewComponent());
+		SeatPreviewComponent->DestroyComponent();
+	}
+	SeatPreviewComponents.Empty();
+
+	PreviewWorld->RemoveComponents(this);
 }
 
 void SCustomSocketEditorWidget::AddReferencedObjects(FReferenceCollector& Collector)
@@ -221,20 +459,63 @@ void SCustomSocketEditorWidget::OnFloatingButtonClicked()
 
 TSharedRef<FEditorViewportClient> SCustomSocketEditorWidget::MakeEditorViewportClient()
 {
-	EditorViewportClient = MakeShareable(new FEditorViewportClient(nullptr, PreviewScene.Get(), SharedThis(this)));
+	EditorViewportClient = MakeShareable(
+		new FSeatEditorViewportClient(PreviewWorld.ToSharedRef(), this, SharedThis(this)));
 	return EditorViewportClient.ToSharedRef();
 }
 
 void SCustomSocketEditorWidget::SetStaticMesh(UStaticMesh* InStaticMesh)
+{
+	StaticMeshSocketEditor->SetStaticMesh(InStaticMesh);
+}
+
+void SCustomSocketEditorWidget::OnStaticMeshChanged(UStaticMesh* InStaticMesh)
 {
 	StaticMesh = InStaticMesh;
 	StaticMeshComponent->SetStaticMesh(StaticMesh);
-	StaticMeshSocketEditor->SetStaticMesh(StaticMesh);
+	RebuildSeatPreviewComponents(SeatMap);
+	LayoutComparePanes();
+}
+
+EVisibility SCustomSocketEditorWidget::GetLoadingMeshVisibility() const
+{
+	return StaticMeshSocketEditor->IsLoadingStaticMesh() ? EVisibility::HitTestInvisible : EVisibility::Collapsed;
+}
+
+FText SCustomSocketEditorWidget::GetLoadingMeshText() const
+{
+	return FText::Format(LOCTEXT("LoadingMesh", "Loading {0}..."),
+	                     FText::FromString(StaticMeshSocketEditor->GetEditedMesh().GetAssetName()));
+}
+
+void SCustomSocketEditorWidget::OnSocketSelectionChanged(USeatSocket* InSelectedSocket)
+{
+	if (bShowSeatGizmos)
+	{
+		RebuildSeatPreviewComponents(SeatMap);
+	}
+}
+
+void SCustomSocketEditorWidget::SetShowSeatGizmos(bool bInShowSeatGizmos)
+{
+	if (bShowSeatGizmos == bInShowSeatGizmos)
+		return;
+
+	bShowSeatGizmos = bInShowSeatGizmos;
+	SeatGizmoComponent->SetVisibility(bShowSeatGizmos);
 	RebuildSeatPreviewComponents(SeatMap);
 }
 
-void SCustomSocketEditorWidget::OnSocketSelectionChanged()
+void SCustomSocketEditorWidget::RefreshSeatGizmos()
 {
+	if (!bShowSeatGizmos)
+		return;
+
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_RefreshSeatGizmos);
+
+	TArray<FSeatInstance> Seats;
+	SeatMap->GatherSeats(StaticMeshSocketEditor->GetEditedMesh(), Seats);
+	SeatGizmoComponent->SetSeats(Seats, StaticMeshSocketEditor->GetSelectedSeat());
 }
 
 void SCustomSocketEditorWidget::RebuildSeatPreviewComponents(UObject* Object)
@@ -242,36 +523,275 @@ void SCustomSocketEditorWidget::RebuildSeatPreviewComponents(UObject* Object)
 	if (Object != SeatMap)
 		return;
 
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_RebuildPreviews);
+
+	RefreshComparePaneSeats();
+
 	for (USeatPreviewComponent* SeatPreviewComponent : SeatPreviewComponents)
 	{
+		PreviewWorld->RemoveComponent(SeatPreviewComponent->GetPreviewComponent());
 		SeatPreviewComponent->DestroyComponent();
 	}
 	SeatPreviewComponents.Empty();
+	RefreshSeatGizmos();
 
-	const FSeats& Seats = SeatMap->GetSeats(StaticMesh);
-	int32 SeatsCount = Seats.Seats.Num();
+	TArray<FSeatInstance> Seats;
+	SeatMap->GatherSeats(StaticMeshSocketEditor->GetEditedMesh(), Seats);
 
-	for (USeatSocket* SeatSocket : Seats.Seats)
+	SeatTransforms.Reset();
+	for (const FSeatInstance& Instance : Seats)
 	{
-		USeatPreviewComponent* SeatPreviewComponent = NewObject<USeatPreviewComponent>(GetTransientPackage());
-		SeatPreviewComponent->SetSeatSocket(SeatSocket);
-		SeatPreviewComponents.Add(SeatPreviewComponent);
+		SeatTransforms.Add(Instance.Seat, Instance.Transform);
 	}
 
-	for (const USeatPreviewComponent* SeatPreviewComponent : SeatPreviewComponents)
+	const USeatSocket* SelectedSeat = StaticMeshSocketEditor->GetSelectedSeat();
+
+	TArray<USeatSocket*> SeatsToBuild;
+	for (const FSeatInstance& Instance : Seats)
 	{
-		PreviewScene->AddComponent(SeatPreviewComponent->GetPreviewComponent(), {
-			                           SeatPreviewComponent->SeatSocket->RelativeRotation,
-			                           SeatPreviewComponent->SeatSocket->RelativeLocation, FVector::OneVector
-		                           });
+		// The gizmo overview draws every seat, only the selected one keeps a full skeletal preview.
+		if (bShowSeatGizmos && Instance.Seat != SelectedSeat)
+			continue;
+
+		SeatsToBuild.Add(Instance.Seat);
 	}
+
+	// Previews are created over the next frames, a later rebuild replaces whatever is still pending.
+	SortSeatsByPreviewPriority(SeatsToBuild);
+	RebuildScheduler->Schedule(SeatsToBuild);
+}
+
+void SCustomSocketEditorWidget::CreateSeatPreviewComponent(USeatSocket* SeatSocket)
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_BuildSeatPreview);
+
+	// Template seats are stored relative to their template, the preview places them on the mesh.
+	const FTransform* SeatTransform = SeatTransforms.Find(SeatSocket);
+	const FTransform LayoutTransform = SeatTransform
+		                                   ? SeatSocket->GetRelativeTransform().Inverse() * *SeatTransform
+		                                   : FTransform::Identity;
+
+	USeatPreviewComponent* SeatPreviewComponent = NewObject<USeatPreviewComponent>(GetTransientPackage());
+	SeatPreviewComponent->SetPosePool(PreviewWorld->GetPosePool());
+	SeatPreviewComponent->SetSeatSocket(SeatSocket, LayoutTransform);
+	SeatPreviewComponents.Add(SeatPreviewComponent);
+
+	PreviewWorld->AddComponent(this, SeatPreviewComponent->GetPreviewComponent(),
+	                           SeatTransform ? *SeatTransform : SeatSocket->GetRelativeTransform());
+}
+
+void SCustomSocketEditorWidget::SortSeatsByPreviewPriority(TArray<USeatSocket*>& InOutSeats) const
+{
+	if (!EditorViewportClient.IsValid())
+		return;
+
+	const USeatSocket* SelectedSeat = StaticMeshSocketEditor->GetSelectedSeat();
+	const FVector ViewLocation = EditorViewportClient->GetViewLocation();
+	const FVector ViewDirection = EditorViewportClient->GetViewRotation().Vector();
+	const float CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(EditorViewportClient->ViewFOV * 0.5f));
+
+	auto GetPriority = [&](const USeatSocket& Seat)
+	{
+		if (&Seat == SelectedSeat)
+			return -1.f;
+
+		const FTransform* SeatTransform = SeatTransforms.Find(&Seat);
+		const FVector ToSeat = (SeatTransform ? SeatTransform->GetLocation() : Seat.RelativeLocation) - ViewLocation;
+		const float Distance = ToSeat.Size();
+		const bool bInView = FVector::DotProduct(ToSeat.GetSafeNormal(), ViewDirection) >= CosHalfFOV;
+		return bInView ? Distance : Distance + WORLD_MAX;
+	};
+
+	InOutSeats.Sort([&GetPriority](const USeatSocket& A, const USeatSocket& B)
+	{
+		return GetPriority(A) < GetPriority(B);
+	});
 }
 
 void SCustomSocketEditorWidget::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
 {
+	USeatSocket* ChangedSeat = Cast<USeatSocket>(Object);
+	if (bShowSeatGizmos && ChangedSeat && SeatTransforms.Contains(ChangedSeat))
+	{
+		RefreshSeatGizmos();
+	}
+
 	RebuildSeatPreviewComponents(Object);
 }
 
+void SCustomSocketEditorWidget::SetCompareMeshes(const TArray<FSoftObjectPath>& InStaticMeshes)
+{
+	for (int32 PaneIndex = ComparePanes.Num() - 1; PaneIndex >= 0; --PaneIndex)
+	{
+		if (!InStaticMeshes.Contains(ComparePanes[PaneIndex].StaticMesh.ToSoftObjectPath()))
+		{
+			RemoveComparePane(ComparePanes[PaneIndex]);
+			ComparePanes.RemoveAt(PaneIndex);
+		}
+	}
+
+	for (const FSoftObjectPath& MeshPath : InStaticMeshes)
+	{
+		const bool bShown = MeshPath == StaticMeshSocketEditor->GetEditedMesh().ToSoftObjectPath() ||
+			ComparePanes.ContainsByPredicate([&MeshPath](const FSeatMeshPane& Pane)
+			{
+				return Pane.StaticMesh.ToSoftObjectPath() == MeshPath;
+			});
+		if (bShown)
+			continue;
+
+		FSeatMeshPane& Pane = ComparePanes.AddDefaulted_GetRef();
+		Pane.StaticMesh = TSoftObjectPtr<UStaticMesh>(MeshPath);
+	}
+
+	TArray<FSoftObjectPath> MeshPaths;
+	for (const FSeatMeshPane& Pane : ComparePanes)
+	{
+		MeshPaths.Add(Pane.StaticMesh.ToSoftObjectPath());
+	}
+
+	// The new request holds the meshes that stay before the previous one lets go of them.
+	const TSharedPtr<FStreamableHandle> PreviousHandle = CompareMeshesHandle;
+	CompareMeshesHandle = MeshPaths.Num() > 0
+		                      ? CompareStreamableManager.RequestAsyncLoad(
+			                      MeshPaths,
+			                      FStreamableDelegate::CreateSP(this, &SCustomSocketEditorWidget::OnCompareMeshesLoaded))
+		                      : TSharedPtr<FStreamableHandle>();
+	if (PreviousHandle.IsValid())
+	{
+		PreviousHandle->CancelHandle();
+	}
+
+	LayoutComparePanes();
+}
+
+void SCustomSocketEditorWidget::SetCompareLayout(ESeatCompareLayout InCompareLayout)
+{
+	if (CompareLayout == InCompareLayout)
+		return;
+
+	CompareLayout = InCompareLayout;
+	LayoutComparePanes();
+}
+
+void SCustomSocketEditorWidget::OnCompareMeshesLoaded()
+{
+	for (FSeatMeshPane& Pane : ComparePanes)
+	{
+		UStaticMesh* PaneMesh = Pane.StaticMesh.Get();
+		if (Pane.MeshComponent || !PaneMesh)
+			continue;
+
+		Pane.MeshComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+		Pane.MeshComponent->SetStaticMesh(PaneMesh);
+		PreviewWorld->AddComponent(this, Pane.MeshComponent, FTransform::Identity);
+
+		Pane.GizmoComponent = NewObject<USeatGizmoComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+		PreviewWorld->AddComponent(this, Pane.GizmoComponent, FTransform::Identity);
+	}
+
+	RefreshComparePaneSeats();
+	LayoutComparePanes();
+}
+
+void SCustomSocketEditorWidget::RemoveComparePane(FSeatMeshPane& Pane)
+{
+	if (Pane.MeshComponent)
+	{
+		PreviewWorld->RemoveComponent(Pane.MeshComponent);
+		Pane.MeshComponent = nullptr;
+	}
+
+	if (Pane.GizmoComponent)
+	{
+		PreviewWorld->RemoveComponent(Pane.GizmoComponent);
+		Pane.GizmoComponent = nullptr;
+	}
+}
+
+void SCustomSocketEditorWidget::LayoutComparePanes()
+{
+	// Tiles start past the edited mesh on the Y axis, each one is as wide as its mesh's bounds.
+	float TileStart = StaticMesh ? StaticMesh->GetBounds().GetBox().Max.Y + SeatMeshPane::TileSpacing : 0.f;
+
+	for (FSeatMeshPane& Pane : ComparePanes)
+	{
+		if (!Pane.MeshComponent)
+			continue;
+
+		FVector Location = FVector::ZeroVector;
+		if (CompareLayout == ESeatCompareLayout::Tiled)
+		{
+			const FBox Bounds = Pane.MeshComponent->GetStaticMesh()->GetBounds().GetBox();
+			Location.Y = TileStart - Bounds.Min.Y;
+			TileStart += Bounds.GetSize().Y + SeatMeshPane::TileSpacing;
+		}
+
+		Pane.MeshComponent->SetWorldLocation(Location);
+		Pane.MeshComponent->SetVisibility(CompareLayout == ESeatCompareLayout::Tiled);
+		Pane.GizmoComponent->SetWorldLocation(Location);
+	}
+}
+
+void SCustomSocketEditorWidget::RefreshComparePaneSeats()
+{
+	for (const FSeatMeshPane& Pane : ComparePanes)
+	{
+		if (!Pane.GizmoComponent)
+			continue;
+
+		TArray<FSeatInstance> Seats;
+		SeatMap->GatherSeats(Pane.StaticMesh, Seats);
+		Pane.GizmoComponent->SetSeats(Seats, nullptr);
+	}
+}
+
+FReply SCustomSocketEditorWidget::CompareSelectedMeshes_Execute()
+{
+	TArray<FAssetData> SelectedAssets;
+	FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser").Get().GetSelectedAssets(SelectedAssets);
+
+	TArray<FSoftObjectPath> StaticMeshes;
+	for (const FAssetData& SelectedAsset : SelectedAssets)
+	{
+		if (SelectedAsset.AssetClass == UStaticMesh::StaticClass()->GetFName())
+		{
+			StaticMeshes.Add(SelectedAsset.ToSoftObjectPath());
+		}
+	}
+
+	SetCompareMeshes(StaticMeshes);
+
+	return FReply::Handled();
+}
+
+FReply SCustomSocketEditorWidget::ClearCompareMeshes_Execute()
+{
+	SetCompareMeshes(TArray<FSoftObjectPath>());
+
+	return FReply::Handled();
+}
+
+ECheckBoxState SCustomSocketEditorWidget::GetCompareOverlaidState() const
+{
+	return CompareLayout == ESeatCompareLayout::Overlaid ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SCustomSocketEditorWidget::OnCompareOverlaidChanged(ECheckBoxState InState)
+{
+	SetCompareLayout(InState == ECheckBoxState::Checked ? ESeatCompareLayout::Overlaid : ESeatCompareLayout::Tiled);
+}
+
+ECheckBoxState SCustomSocketEditorWidget::GetShowSeatGizmosState() const
+{
+	return bShowSeatGizmos ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SCustomSocketEditorWidget::OnShowSeatGizmosChanged(ECheckBoxState InState)
+{
+	SetShowSeatGizmos(InState == ECheckBoxState::Checked);
+}
+
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 #undef LOCTEXT_NAMESPACE
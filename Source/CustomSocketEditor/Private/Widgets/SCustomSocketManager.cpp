@@ -1,4 +1,4 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SCustomSocketManager.h"
 #include "Widgets/Layout/SSplitter.h"
@@ -8,8 +8,12 @@
 #include "UObject/UObjectHash.h"
 #include "UObject/UObjectIterator.h"
 #include "Widgets/Layout/SSeparator.h"
+#include "Widgets/Layout/SBox.h"
 #include "Widgets/Input/SButton.h"
-#include "Widgets/Views/SListView.h"
+#include "Widgets/Input/SComboBox.h"
+#include "Widgets/Input/SVectorInputBox.h"
+#include "Widgets/Views/STreeView.h"
+#include "Widgets/Input/SSearchBox.h"
 #include "EditorStyleSet.h"
 #include "Components/StaticMeshComponent.h"
 #include "Editor/UnrealEdEngine.h"
@@ -26,36 +30,34 @@
 #include "EngineAnalytics.h"
 #include "Widgets/Text/SInlineEditableTextBlock.h"
 #include "Framework/Commands/GenericCommands.h"
+#include "CustomSocketEditor.h"
+#include "CustomSocketStats.h"
+#include "Logging/MessageLog.h"
+#include "SeatSettings.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "Import/SeatSocketImporter.h"
+#include "SeatAnalysis/SeatBoardingBaker.h"
+#include "SeatAnalysis/SeatCandidateGenerator.h"
+#include "SeatAnalysis/SeatFireArcBaker.h"
+#include "SeatAnalysis/SeatValidator.h"
 #include "SeatSocket/SeatSocket.h"
-#include "Windows/WindowsPlatformApplicationMisc.h"
+#include "HAL/PlatformApplicationMisc.h"
 
 #define LOCTEXT_NAMESPACE "SSCSSocketManagerEditor"
 
-struct SocketListItem
-{
-public:
-	SocketListItem(USeatSocket* InSocket)
-		: Socket(InSocket)
-	{
-	}
-
-	/** The static mesh socket this represents */
-	USeatSocket* Socket;
-
-	/** Delegate for when the context menu requests a rename */
-	DECLARE_DELEGATE(FOnRenameRequested);
-	FOnRenameRequested OnRenameRequested;
-};
-
-class SSocketDisplayItem : public STableRow<TSharedPtr<FString>>
+class SSocketDisplayItem : public STableRow<FSeatListItem>
 {
 public:
 	SLATE_BEGIN_ARGS(SSocketDisplayItem)
 		{
 		}
 
-		/** The socket this item displays. */
-		SLATE_ARGUMENT(TWeakPtr< SocketListItem >, SocketItem)
+		/** The row this item displays. */
+		SLATE_ARGUMENT(FSeatListItem, Item)
+
+		/** Rows of the socket manager's list */
+		SLATE_ARGUMENT(TSharedPtr<const FSeatListModel>, Model)
 
 		/** Pointer back to the socket manager */
 		SLATE_ARGUMENT(TWeakPtr< SCustomSocketManager >, SocketManagerPtr)
@@ -68,41 +70,87 @@ public:
 	 */
 	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
 	{
-		SocketItem = InArgs._SocketItem;
+		Item = InArgs._Item;
+		Model = InArgs._Model;
 		SocketManagerPtr = InArgs._SocketManagerPtr;
 
-		TSharedPtr<SInlineEditableTextBlock> InlineWidget;
+		if (Model->GetSeat(Item))
+		{
+			this->ChildSlot
+			    .Padding(0.0f, 3.0f, 6.0f, 3.0f)
+			    .VAlign(VAlign_Center)
+			[
+				SNew(SHorizontalBox)
 
-		this->ChildSlot
-		    .Padding(0.0f, 3.0f, 6.0f, 3.0f)
-		    .VAlign(VAlign_Center)
-		[
-			SAssignNew(InlineWidget, SInlineEditableTextBlock)
-				.Text(this, &SSocketDisplayItem::GetSocketName)
-				.OnVerifyTextChanged(this, &SSocketDisplayItem::OnVerifySocketNameChanged)
-				.OnTextCommitted(this, &SSocketDisplayItem::OnCommitSocketName)
-				.IsSelected(this, &STableRow<TSharedPtr<FString>>::IsSelectedExclusively)
-		];
-
-		TSharedPtr<SocketListItem> SocketItemPinned = SocketItem.Pin();
-		if (SocketItemPinned.IsValid())
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.0f)
+				[
+					SAssignNew(InlineWidget, SInlineEditableTextBlock)
+					.OnVerifyTextChanged(this, &SSocketDisplayItem::OnVerifySocketNameChanged)
+					.OnTextCommitted(this, &SSocketDisplayItem::OnCommitSocketName)
+					.IsSelected(this, &STableRow<FSeatListItem>::IsSelectedExclusively)
+				]
+
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SAssignNew(TemplateLabel, STextBlock)
+					.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+					.Text(LOCTEXT("TemplateSeat", "Template"))
+				]
+			];
+		}
+		else
 		{
-			SocketItemPinned->OnRenameRequested.BindSP(InlineWidget.Get(), &SInlineEditableTextBlock::EnterEditingMode);
+			this->ChildSlot
+			    .Padding(0.0f, 3.0f, 6.0f, 3.0f)
+			    .VAlign(VAlign_Center)
+			[
+				SAssignNew(GroupLabel, STextBlock)
+				.Font(FEditorStyle::GetFontStyle("BoldFont"))
+			];
 		}
 
-		STableRow<TSharedPtr<FString>>::ConstructInternal(
+		Refresh();
+
+		STableRow<FSeatListItem>::ConstructInternal(
 			STableRow::FArguments()
 			.ShowSelection(true),
 			InOwnerTableView
 		);
 	}
 
+	/** Updates the row from the model, rows show fixed values so an idle list doesn't poll the seats. */
+	void Refresh()
+	{
+		if (InlineWidget.IsValid())
+		{
+			InlineWidget->SetText(GetSocketName());
+			TemplateLabel->SetVisibility(Model->GetRow(Item).bFromTemplate ? EVisibility::Visible : EVisibility::Collapsed);
+		}
+		else if (GroupLabel.IsValid())
+		{
+			const FSeatListModel::FRow& Row = Model->GetRow(Item);
+			GroupLabel->SetText(FText::Format(LOCTEXT("GroupRowFmt", "{0} ({1})"), Row.Label,
+			                                  FText::AsNumber(Row.NumVisibleSeats)));
+		}
+	}
+
+	/** Starts editing the seat's name. */
+	void RequestRename()
+	{
+		if (InlineWidget.IsValid())
+		{
+			InlineWidget->EnterEditingMode();
+		}
+	}
+
 private:
 	/** Returns the socket name */
 	FText GetSocketName() const
 	{
-		TSharedPtr<SocketListItem> SocketItemPinned = SocketItem.Pin();
-		return SocketItemPinned.IsValid() ? FText::FromName(SocketItemPinned->Socket->Name) : FText();
+		const USeatSocket* Socket = Model->GetSeat(Item);
+		return Socket ? FText::FromName(Socket->Name) : FText();
 	}
 
 	bool OnVerifySocketNameChanged(const FText& InNewText, FText& OutErrorMessage)
@@ -117,11 +165,10 @@ private:
 		}
 		else
 		{
-			TSharedPtr<SocketListItem> SocketItemPinned = SocketItem.Pin();
+			const USeatSocket* Socket = Model->GetSeat(Item);
 			TSharedPtr<SCustomSocketManager> SocketManagerPinned = SocketManagerPtr.Pin();
 
-			if (SocketItemPinned.IsValid() && SocketItemPinned->Socket != nullptr && SocketItemPinned->Socket->
-				Name.ToString() != NewText.ToString() &&
+			if (Socket != nullptr && Socket->Name.ToString() != NewText.ToString() &&
 				SocketManagerPinned.IsValid() && SocketManagerPinned->CheckForDuplicateSocket(NewText.ToString()))
 			{
 				OutErrorMessage = LOCTEXT("DuplicateSocket_Error", "Socket name in use!");
@@ -136,32 +183,28 @@ private:
 	{
 		FText NewText = FText::TrimPrecedingAndTrailing(InText);
 
-		TSharedPtr<SocketListItem> PinnedSocketItem = SocketItem.Pin();
-		if (PinnedSocketItem.IsValid())
+		USeatSocket* SelectedSocket = Model->GetSeat(Item);
+		if (SelectedSocket != NULL)
 		{
-			USeatSocket* SelectedSocket = PinnedSocketItem->Socket;
-			if (SelectedSocket != NULL)
-			{
-				FScopedTransaction Transaction(LOCTEXT("SetSocketName", "Set Socket Name"));
-
-				FProperty* ChangedProperty = FindFProperty<FProperty>(UStaticMeshSocket::StaticClass(), "SocketName");
-
-				// Pre edit, calls modify on the object
-				SelectedSocket->PreEditChange(ChangedProperty);
+			FScopedTransaction Transaction(LOCTEXT("SetSocketName", "Set Socket Name"));
 
-				// Edit the property itself
-				SelectedSocket->Name = FName(*NewText.ToString());
-
-				// Post edit
-				FPropertyChangedEvent PropertyChangedEvent(ChangedProperty);
-				SelectedSocket->PostEditChangeProperty(PropertyChangedEvent);
+			TSharedPtr<SCustomSocketManager> SocketManagerPinned = SocketManagerPtr.Pin();
+			if (SocketManagerPinned.IsValid())
+			{
+				SocketManagerPinned->RenameSocket(SelectedSocket, FName(*NewText.ToString()));
 			}
 		}
 	}
 
 private:
-	/** The Socket to display. */
-	TWeakPtr<SocketListItem> SocketItem;
+	/** The row to display. */
+	FSeatListItem Item;
+
+	TSharedPtr<const FSeatListModel> Model;
+
+	TSharedPtr<SInlineEditableTextBlock> InlineWidget;
+	TSharedPtr<STextBlock> TemplateLabel;
+	TSharedPtr<STextBlock> GroupLabel;
 
 	/** Pointer back to the socket manager */
 	TWeakPtr<SCustomSocketManager> SocketManagerPtr;
@@ -175,6 +218,10 @@ void SCustomSocketManager::Construct(const FArguments& InArgs)
 	SeatMap = InArgs._SeatMap;
 
 	StaticMeshSocketEditor->OnStaticMeshChanged.AddRaw(this, &SCustomSocketManager::SetStaticMesh);
+	if (SeatMap)
+	{
+		SeatMap->OnSeatsReplaced().AddRaw(this, &SCustomSocketManager::OnSeatsReplaced);
+	}
 
 	FDetailsViewArgs Args;
 	Args.bHideSelectionTip = true;
@@ -231,18 +278,167 @@ void SCustomSocketManager::Construct(const FArguments& InArgs)
 						.HAlign(HAlign_Center)
 					]
 
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SNew(SButton)
+						.ButtonStyle(FEditorStyle::Get(), "FlatButton.Success")
+						.ForegroundColor(FLinearColor::White)
+						.Text(LOCTEXT("ProposeSeats", "Propose Seats"))
+						.ToolTipText(LOCTEXT("ProposeSeatsTooltip", "Adds seats on flat surfaces of the mesh that have room for an occupant."))
+						.OnClicked(this, &SCustomSocketManager::ProposeSeats_Execute)
+						.HAlign(HAlign_Center)
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SAssignNew(ImportMeshSocketsButton, SButton)
+						.ButtonStyle(FEditorStyle::Get(), "FlatButton.Success")
+						.ForegroundColor(FLinearColor::White)
+						.Text(LOCTEXT("ImportMeshSockets", "Import Mesh Sockets"))
+						.ToolTipText(LOCTEXT("ImportMeshSocketsTooltip", "Imports the seat sockets of the static meshes selected in the Content Browser, or of the current mesh."))
+						.OnClicked(this, &SCustomSocketManager::ImportMeshSockets_Execute)
+						.HAlign(HAlign_Center)
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SNew(SButton)
+						.ButtonStyle(FEditorStyle::Get(), "FlatButton.Primary")
+						.ForegroundColor(FLinearColor::White)
+						.Text(LOCTEXT("ValidateSeats", "Validate Seats"))
+						.ToolTipText(LOCTEXT("ValidateSeatsTooltip", "Checks every seat's occupant capsule against the mesh collision."))
+						.OnClicked(this, &SCustomSocketManager::ValidateSeats_Execute)
+						.HAlign(HAlign_Center)
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SNew(SButton)
+						.ButtonStyle(FEditorStyle::Get(), "FlatButton.Primary")
+						.ForegroundColor(FLinearColor::White)
+						.Text(LOCTEXT("BakeSeatData", "Bake Seat Data"))
+						.ToolTipText(LOCTEXT("BakeSeatDataTooltip", "Bakes the entry and exit paths of every seat around the mesh collision and the firing arcs of fireable seats."))
+						.OnClicked(this, &SCustomSocketManager::BakeSeatData_Execute)
+						.HAlign(HAlign_Center)
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SNew(SHorizontalBox)
+
+						+ SHorizontalBox::Slot()
+						  .AutoWidth()
+						  .VAlign(VAlign_Center)
+						  .Padding(0, 0, 4, 0)
+						[
+							SNew(STextBlock)
+							.Text(LOCTEXT("Template", "Template"))
+						]
+
+						+ SHorizontalBox::Slot()
+						.FillWidth(1.0f)
+						[
+							SNew(SComboBox<TSharedPtr<FName>>)
+							.OptionsSource(&TemplateOptions)
+							.OnComboBoxOpening(this, &SCustomSocketManager::RefreshTemplateOptions)
+							.OnGenerateWidget(this, &SCustomSocketManager::MakeTemplateOptionWidget)
+							.OnSelectionChanged(this, &SCustomSocketManager::OnTemplateSelected)
+							[
+								SAssignNew(TemplateText, STextBlock)
+							]
+						]
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SAssignNew(TemplateOffsetRow, SHorizontalBox)
+
+						+ SHorizontalBox::Slot()
+						  .AutoWidth()
+						  .VAlign(VAlign_Center)
+						  .Padding(0, 0, 4, 0)
+						[
+							SNew(STextBlock)
+							.Text(LOCTEXT("TemplateOffset", "Offset"))
+						]
+
+						+ SHorizontalBox::Slot()
+						.FillWidth(1.0f)
+						[
+							SAssignNew(TemplateOffsetBox, SBox)
+						]
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SNew(SHorizontalBox)
+
+						+ SHorizontalBox::Slot()
+						  .FillWidth(1.0f)
+						  .Padding(0, 0, 2, 0)
+						[
+							SNew(SButton)
+							.ButtonStyle(FEditorStyle::Get(), "FlatButton.Primary")
+							.ForegroundColor(FLinearColor::White)
+							.Text(LOCTEXT("MakeTemplate", "Make Template"))
+							.ToolTipText(LOCTEXT("MakeTemplateTooltip", "Moves the mesh's seats into a template other meshes can use."))
+							.OnClicked(this, &SCustomSocketManager::MakeTemplate_Execute)
+							.HAlign(HAlign_Center)
+						]
+
+						+ SHorizontalBox::Slot()
+						  .FillWidth(1.0f)
+						  .Padding(2, 0, 0, 0)
+						[
+							SNew(SButton)
+							.ButtonStyle(FEditorStyle::Get(), "FlatButton.Primary")
+							.ForegroundColor(FLinearColor::White)
+							.Text(LOCTEXT("MirrorSeats", "Mirror Seats"))
+							.ToolTipText(LOCTEXT("MirrorSeatsTooltip", "Adds a copy of the mesh's own seats mirrored across its XZ plane."))
+							.OnClicked(this, &SCustomSocketManager::MirrorSeats_Execute)
+							.HAlign(HAlign_Center)
+						]
+					]
+
+					+ SVerticalBox::Slot()
+					  .AutoHeight()
+					  .Padding(0, 0, 0, 4)
+					[
+						SAssignNew(SearchBox, SSearchBox)
+						.HintText(LOCTEXT("SearchSeats", "Search Seats"))
+						.OnTextChanged(this, &SCustomSocketManager::OnFilterTextChanged)
+					]
+
 					+ SVerticalBox::Slot()
 					.FillHeight(1.0f)
 					[
-						SAssignNew(SocketListView, SListView<TSharedPtr< SocketListItem > >)
+						SAssignNew(SocketListView, STreeView<FSeatListItem>)
 
 						.SelectionMode(ESelectionMode::Single)
 
-						.ListItemsSource(&SocketList)
+						.TreeItemsSource(&SeatListModel->GetRootItems())
 
 						// Generates the actual widget for a tree item
 						.OnGenerateRow(this, &SCustomSocketManager::MakeWidgetFromOption)
 
+						.OnGetChildren(this, &SCustomSocketManager::GetSeatListChildren)
+
+						.OnExpansionChanged(this, &SCustomSocketManager::OnSeatListExpansionChanged)
+
 						// Find out when the user selects something in the tree
 						.OnSelectionChanged(this, &SCustomSocketManager::SocketSelectionChanged_Execute)
 
@@ -269,8 +465,7 @@ void SCustomSocketManager::Construct(const FArguments& InArgs)
 					+ SVerticalBox::Slot()
 					.AutoHeight()
 					[
-						SNew(STextBlock)
-						.Text(this, &SCustomSocketManager::GetSocketHeaderText)
+						SAssignNew(SocketHeaderText, STextBlock)
 					]
 				]
 			]
@@ -282,11 +477,10 @@ void SCustomSocketManager::Construct(const FArguments& InArgs)
 
 				+ SOverlay::Slot()
 				[
-					SNew(SBorder)
+					SAssignNew(SelectSocketMessage, SBorder)
 					.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
 					.HAlign(HAlign_Center)
 					.VAlign(VAlign_Center)
-					.Visibility(this, &SCustomSocketManager::GetSelectSocketMessageVisibility)
 					[
 						SNew(STextBlock)
 						.Text(LOCTEXT("NoSocketSelected", "Select a Socket"))
@@ -302,20 +496,29 @@ void SCustomSocketManager::Construct(const FArguments& InArgs)
 	];
 
 	RefreshSocketList();
-
-	AddPropertyChangeListenerToSockets();
 }
 
 SCustomSocketManager::~SCustomSocketManager()
 {
 	RemovePropertyChangeListenerFromSockets();
+	if (SeatMap)
+	{
+		SeatMap->OnSeatsReplaced().RemoveAll(this);
+	}
 }
 
 USeatSocket* SCustomSocketManager::GetSelectedSocket() const
 {
-	if (SocketListView->GetSelectedItems().Num())
+	const FSeatListModel::FRow* SelectedRow = GetSelectedRow();
+	return SelectedRow ? SelectedRow->Seat : nullptr;
+}
+
+const FSeatListModel::FRow* SCustomSocketManager::GetSelectedRow() const
+{
+	const TArray<FSeatListItem> SelectedItems = SocketListView->GetSelectedItems();
+	if (SelectedItems.Num() && SeatListModel->GetSeat(SelectedItems[0]))
 	{
-		return SocketListView->GetSelectedItems()[0]->Socket;
+		return &SeatListModel->GetRow(SelectedItems[0]);
 	}
 
 	return nullptr;
@@ -323,50 +526,145 @@ USeatSocket* SCustomSocketManager::GetSelectedSocket() const
 
 EVisibility SCustomSocketManager::GetSelectSocketMessageVisibility() const
 {
-	return SocketListView->GetSelectedItems().Num() > 0 ? EVisibility::Hidden : EVisibility::Visible;
+	return GetSelectedSocket() ? EVisibility::Hidden : EVisibility::Visible;
 }
 
-void SCustomSocketManager::SetSelectedSocket(USeatSocket* InSelectedSocket)
+void SCustomSocketManager::InvalidateSeatListStatus()
+{
+	// Several changes in one frame update the widgets once, on the next tick.
+	if (!bSeatListStatusPending)
+	{
+		bSeatListStatusPending = true;
+		RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SCustomSocketManager::UpdateSeatListStatus));
+	}
+}
+
+EActiveTimerReturnType SCustomSocketManager::UpdateSeatListStatus(double InCurrentTime, float InDeltaTime)
 {
-	if (InSelectedSocket)
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_UpdateSocketListStatus);
+
+	bSeatListStatusPending = false;
+
+	SocketHeaderText->SetText(GetSocketHeaderText());
+	SelectSocketMessage->SetVisibility(GetSelectSocketMessageVisibility());
+	TemplateText->SetText(GetTemplateText());
+	ImportMeshSocketsButton->SetEnabled(CanImportMeshSockets());
+
+	const EVisibility TemplateOffsetVisibility = GetTemplateOffsetVisibility();
+	TemplateOffsetRow->SetVisibility(TemplateOffsetVisibility);
+	const FVector TemplateOffset = GetTemplateOffset();
+	if (TemplateOffsetVisibility == EVisibility::Visible &&
+		(!DisplayedTemplateOffset.IsSet() || DisplayedTemplateOffset.GetValue() != TemplateOffset))
 	{
-		for (int32 i = 0; i < SocketList.Num(); i++)
+		// Rebuilt only when the offset changed, so the boxes keep focus while the user edits them.
+		DisplayedTemplateOffset = TemplateOffset;
+		TemplateOffsetBox->SetContent(MakeTemplateOffsetWidget(TemplateOffset));
+	}
+
+	// Generated rows show what the model held when they were built, only visible rows have widgets.
+	TArray<FSeatListItem> Children;
+	for (const FSeatListItem& Group : SeatListModel->GetRootItems())
+	{
+		RefreshSeatListRow(Group);
+
+		SeatListModel->GetChildren(Group, Children);
+		for (const FSeatListItem& Child : Children)
 		{
-			if (SocketList[i]->Socket == InSelectedSocket)
-			{
-				SocketListView->SetSelection(SocketList[i]);
+			RefreshSeatListRow(Child);
+		}
+	}
 
-				SocketListView->RequestListRefresh();
+	return EActiveTimerReturnType::Stop;
+}
 
-				SocketSelectionChanged(InSelectedSocket);
+void SCustomSocketManager::RefreshSeatListRow(FSeatListItem InItem)
+{
+	const TSharedPtr<ITableRow> Row = SocketListView->WidgetFromItem(InItem);
+	if (Row.IsValid())
+	{
+		StaticCastSharedPtr<SSocketDisplayItem>(Row)->Refresh();
+	}
+}
 
-				break;
-			}
+void SCustomSocketManager::SetSelectedSocket(USeatSocket* InSelectedSocket)
+{
+	const FSeatListItem Item = SeatListModel->FindSeat(InSelectedSocket);
+	if (Item.IsValid())
+	{
+		// A seat the filter hides can't be selected, show all seats again.
+		if (!SeatListModel->GetRow(Item).bPassesFilter)
+		{
+			SearchBox->SetText(FText::GetEmpty());
+			OnFilterTextChanged(FText::GetEmpty());
 		}
+
+		SocketListView->SetItemExpansion(SeatListModel->GetGroup(Item), true);
+		SocketListView->SetSelection(Item);
+		SocketListView->RequestScrollIntoView(Item);
+
+		SocketSelectionChanged(InSelectedSocket);
 	}
-	else
+	else if (!InSelectedSocket)
 	{
 		SocketListView->ClearSelection();
 
-		SocketListView->RequestListRefresh();
-
 		SocketSelectionChanged(NULL);
 	}
 }
 
-TSharedRef<ITableRow> SCustomSocketManager::MakeWidgetFromOption(TSharedPtr<SocketListItem> InItem,
+TSharedRef<ITableRow> SCustomSocketManager::MakeWidgetFromOption(FSeatListItem InItem,
                                                                  const TSharedRef<STableViewBase>& OwnerTable)
 {
 	return SNew(SSocketDisplayItem, OwnerTable)
-				.SocketItem(InItem)
+				.Item(InItem)
+				.Model(SeatListModel)
 				.SocketManagerPtr(SharedThis(this));
 }
 
+void SCustomSocketManager::GetSeatListChildren(FSeatListItem InItem, TArray<FSeatListItem>& OutChildren)
+{
+	SeatListModel->GetChildren(InItem, OutChildren);
+}
+
+void SCustomSocketManager::OnSeatListExpansionChanged(FSeatListItem InItem, bool bExpanded)
+{
+	if (bExpanded)
+	{
+		CollapsedGroups.Remove(InItem);
+	}
+	else
+	{
+		CollapsedGroups.Add(InItem);
+	}
+}
+
+void SCustomSocketManager::OnFilterTextChanged(const FText& InFilterText)
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_FilterSocketList);
+
+	if (SeatListModel->SetFilterText(InFilterText.ToString()))
+	{
+		RequestSeatListRefresh();
+		InvalidateSeatListStatus();
+	}
+}
+
+void SCustomSocketManager::RequestSeatListRefresh()
+{
+	// Groups appear when their first seat does, they open unless the user closed them.
+	for (const FSeatListItem& Group : SeatListModel->GetRootItems())
+	{
+		SocketListView->SetItemExpansion(Group, !CollapsedGroups.Contains(Group));
+	}
+
+	SocketListView->RequestTreeRefresh();
+}
+
 void SCustomSocketManager::CreateSeatSocket()
 {
 	if (StaticMeshSocketEditor)
 	{
-		UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
+		const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
 
 		const FScopedTransaction Transaction(LOCTEXT("CreateSocket", "Create Socket"));
 
@@ -392,25 +690,111 @@ void SCustomSocketManager::CreateSeatSocket()
 
 		NewSocket->Name = SocketName;
 		NewSocket->SetFlags(RF_Transactional);
-		NewSocket->OnPropertyChanged().AddSP(this, &SCustomSocketManager::OnSocketPropertyChanged);
 
 		SeatMap->PreEditChange(NULL);
 		SeatMap->AddSeat(CurrentStaticMesh, NewSocket);
 		SeatMap->PostEditChange();
 		SeatMap->MarkPackageDirty();
 
-		TSharedPtr<SocketListItem> SocketItem = MakeShareable(new SocketListItem(NewSocket));
-		SocketList.Add(SocketItem);
-		SocketListView->RequestListRefresh();
+		RefreshSocketList();
 
-		SocketListView->SetSelection(SocketItem);
+		SetSelectedSocket(NewSocket);
 		RequestRenameSelectedSocket();
 	}
 }
 
+void SCustomSocketManager::ProposeSeats()
+{
+	UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor ? StaticMeshSocketEditor->GetStaticMesh() : nullptr;
+	if (!CurrentStaticMesh)
+		return;
+
+	TArray<FSeatCandidate> Candidates;
+	FSeatCandidateGenerator::Get().Generate(CurrentStaticMesh, Candidates);
+
+	const FScopedTransaction Transaction(LOCTEXT("ProposeSeats", "Propose Seats"));
+	SeatMap->PreEditChange(NULL);
+
+	const int32 NumProposed = AddSeatCandidates(SeatMap, CurrentStaticMesh, Candidates).Num();
+
+	SeatMap->PostEditChange();
+	if (NumProposed > 0)
+	{
+		SeatMap->MarkPackageDirty();
+		RefreshSocketList();
+	}
+
+	UE_LOG(LogCustomSocket, Display, TEXT("Proposed %d of %d seat candidates for %s."), NumProposed,
+	       Candidates.Num(), *CurrentStaticMesh->GetName());
+}
+
+TArray<USeatSocket*> SCustomSocketManager::AddSeatCandidates(USeatMap* InSeatMap,
+                                                             const TSoftObjectPtr<UStaticMesh>& InStaticMesh,
+                                                             const TArray<FSeatCandidate>& InCandidates)
+{
+	const USeatSettings* Settings = GetDefault<USeatSettings>();
+
+	TArray<FSeatInstance> Seats;
+	InSeatMap->GatherSeats(InStaticMesh, Seats);
+
+	// The list only shows the new seats after the refresh, so the names in use are tracked here.
+	TArray<FVector> OccupiedLocations;
+	TSet<FName> UsedNames;
+	for (const FSeatInstance& Instance : Seats)
+	{
+		OccupiedLocations.Add(Instance.Transform.GetLocation());
+		UsedNames.Add(Instance.Seat->Name);
+	}
+
+	TArray<USeatSocket*> AddedSeats;
+	int32 NameIndex = 0;
+	for (const FSeatCandidate& Candidate : InCandidates)
+	{
+		// Leave spots that already have a seat to the hand placed one.
+		const FVector Location = Candidate.Transform.GetLocation();
+		const float Radius = Settings->GetPostureShape(Candidate.Posture).Radius;
+		const bool bOccupied = OccupiedLocations.ContainsByPredicate([&](const FVector& Occupied)
+		{
+			return FVector::DistSquared(Occupied, Location) < FMath::Square(Radius * 2.f);
+		});
+		if (bOccupied)
+			continue;
+
+		FName SocketName = TEXT("Seat");
+		while (UsedNames.Contains(SocketName))
+		{
+			SocketName = FName(*FString::Printf(TEXT("Seat%i"), NameIndex));
+			++NameIndex;
+		}
+		UsedNames.Add(SocketName);
+
+		USeatSocket* NewSocket = NewObject<USeatSocket>(InSeatMap);
+		NewSocket->Name = SocketName;
+		NewSocket->RelativeLocation = Location;
+		NewSocket->RelativeRotation = Candidate.Transform.Rotator();
+		NewSocket->Posture = Candidate.Posture;
+		NewSocket->SetFlags(RF_Transactional);
+
+		InSeatMap->AddSeat(InStaticMesh, NewSocket);
+		OccupiedLocations.Add(Location);
+		AddedSeats.Add(NewSocket);
+	}
+
+	return AddedSeats;
+}
+
 void SCustomSocketManager::CopySeat()
 {
-	FSeats Seats = SeatMap->GetSeats(StaticMesh.Get());
+	// Template seats are copied with their template transform applied, the copy describes the mesh as placed.
+	TArray<FSeatInstance> Seats;
+	SeatMap->GatherSeats(StaticMesh, Seats);
+
+	FPlatformApplicationMisc::ClipboardCopy(*ExportSeats(Seats));
+}
+
+FString SCustomSocketManager::ExportSeats(const TArray<FSeatInstance>& InSeats)
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_ExportSeats);
 
 	FString Names;
 	FString Types;
@@ -419,8 +803,12 @@ void SCustomSocketManager::CopySeat()
 	FString Postures;
 	FString Scopes;
 
-	for (const USeatSocket* Seat : Seats.Seats)
+	for (const FSeatInstance& Instance : InSeats)
 	{
+		const USeatSocket* Seat = Instance.Seat;
+		const FVector Location = Instance.Transform.GetLocation();
+		const FRotator Rotation = Instance.Transform.Rotator();
+
 		if (!Names.IsEmpty())
 			Names.Append(",");
 
@@ -434,15 +822,12 @@ void SCustomSocketManager::CopySeat()
 		if (!Positions.IsEmpty())
 			Positions.Append(",");
 
-		Positions.Append(FString::Printf(TEXT("(%f,%f,%f)"), Seat->RelativeLocation.X, Seat->RelativeLocation.Y,
-		                                 Seat->RelativeLocation.Z));
+		Positions.Append(FString::Printf(TEXT("(%f,%f,%f)"), Location.X, Location.Y, Location.Z));
 
 		if (!Rotations.IsEmpty())
 			Rotations.Append(",");
 
-		Rotations.Append(FString::Printf(TEXT("(%f,%f,%f)"),
-		                                 Seat->RelativeRotation.Pitch, Seat->RelativeRotation.Yaw,
-		                                 Seat->RelativeRotation.Roll));
+		Rotations.Append(FString::Printf(TEXT("(%f,%f,%f)"), Rotation.Pitch, Rotation.Yaw, Rotation.Roll));
 
 		if (!Postures.IsEmpty())
 			Postures.Append(",");
@@ -456,8 +841,7 @@ void SCustomSocketManager::CopySeat()
 		                              Seat->YawScope * 0.5, Seat->YawScope * -0.5));
 	}
 
-	FString SeatString = Names + "\t" + Types + "\t" + Positions + "\t" + Rotations + "\t" + Postures + "\t" + Scopes;
-	FPlatformApplicationMisc::ClipboardCopy(*SeatString);
+	return Names + "\t" + Types + "\t" + Positions + "\t" + Rotations + "\t" + Postures + "\t" + Scopes;
 }
 
 void SCustomSocketManager::DuplicateSelectedSocket()
@@ -468,13 +852,32 @@ void SCustomSocketManager::DuplicateSelectedSocket()
 	{
 		const FScopedTransaction Transaction(LOCTEXT("SocketManager_DuplicateSocket", "Duplicate Socket"));
 
-		UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
+		const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
 
-		USeatSocket* NewSocket = DuplicateObject(SelectedSocket, CurrentStaticMesh);
+		// Seats live in the seat map, which is the package they are saved with.
+		USeatSocket* NewSocket = DuplicateObject(SelectedSocket, SeatMap);
 
 		// Create a unique name for this socket
-		NewSocket->Name = MakeUniqueObjectName(CurrentStaticMesh, UStaticMeshSocket::StaticClass(),
-		                                       NewSocket->Name);
+		const FString SocketNameString = SelectedSocket->Name.ToString();
+		for (int32 Index = 0; CheckForDuplicateSocket(NewSocket->Name.ToString()); ++Index)
+		{
+			NewSocket->Name = FName(*FString::Printf(TEXT("%s%i"), *SocketNameString, Index));
+		}
+
+		// A copy of a template socket belongs to the mesh, so it takes the template's placement with it.
+		const FTransform* SeatTransform = nullptr;
+		TArray<FSeatInstance> Seats;
+		SeatMap->GatherSeats(CurrentStaticMesh, Seats);
+		for (const FSeatInstance& Instance : Seats)
+		{
+			if (Instance.Seat == SelectedSocket && Instance.bFromTemplate)
+				SeatTransform = &Instance.Transform;
+		}
+		if (SeatTransform)
+		{
+			NewSocket->RelativeLocation = SeatTransform->GetLocation();
+			NewSocket->RelativeRotation = SeatTransform->Rotator();
+		}
 
 		// Add the new socket to the static mesh
 		SeatMap->PreEditChange(NULL);
@@ -491,6 +894,33 @@ void SCustomSocketManager::DuplicateSelectedSocket()
 }
 
 
+void SCustomSocketManager::OverrideSelectedSocket()
+{
+	const FSeatListModel::FRow* SelectedRow = GetSelectedRow();
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	if (!Seats || !SelectedRow || !SelectedRow->bFromTemplate)
+		return;
+
+	const FScopedTransaction Transaction(LOCTEXT("OverrideSocket", "Override Template Socket"));
+
+	// The override keeps the template socket's name, which is what replaces the template socket on this mesh.
+	const USeatSocket* TemplateSocket = SelectedRow->Seat;
+	const FTransform MeshTransform = TemplateSocket->GetRelativeTransform() * Seats->TemplateTransform;
+
+	USeatSocket* NewSocket = DuplicateObject(TemplateSocket, SeatMap);
+	NewSocket->RelativeLocation = MeshTransform.GetLocation();
+	NewSocket->RelativeRotation = MeshTransform.Rotator();
+
+	SeatMap->PreEditChange(NULL);
+	SeatMap->AddSeat(CurrentStaticMesh, NewSocket);
+	SeatMap->PostEditChange();
+	SeatMap->MarkPackageDirty();
+
+	RefreshSocketList();
+	SetSelectedSocket(NewSocket);
+}
+
 void SCustomSocketManager::UpdateStaticMesh()
 {
 	RefreshSocketList();
@@ -498,9 +928,9 @@ void SCustomSocketManager::UpdateStaticMesh()
 
 void SCustomSocketManager::RequestRenameSelectedSocket()
 {
-	if (SocketListView->GetSelectedItems().Num() == 1)
+	const FSeatListItem SocketItem = SeatListModel->FindSeat(GetSelectedSocket());
+	if (SocketItem.IsValid())
 	{
-		TSharedPtr<SocketListItem> SocketItem = SocketListView->GetSelectedItems()[0];
 		SocketListView->RequestScrollIntoView(SocketItem);
 		DeferredRenameRequest = SocketItem;
 	}
@@ -508,15 +938,14 @@ void SCustomSocketManager::RequestRenameSelectedSocket()
 
 void SCustomSocketManager::DeleteSelectedSocket()
 {
-	if (SocketListView->GetSelectedItems().Num())
+	if (USeatSocket* SelectedSocket = GetSelectedSocket())
 	{
 		const FScopedTransaction Transaction(LOCTEXT("DeleteSocket", "Delete Socket"));
 
 		if (StaticMeshSocketEditor)
 		{
-			UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
+			const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
 			SeatMap->PreEditChange(NULL);
-			USeatSocket* SelectedSocket = SocketListView->GetSelectedItems()[0]->Socket;
 			SelectedSocket->OnPropertyChanged().RemoveAll(this);
 			SeatMap->RemoveSeat(CurrentStaticMesh, SelectedSocket);
 			SeatMap->PostEditChange();
@@ -528,56 +957,75 @@ void SCustomSocketManager::DeleteSelectedSocket()
 
 void SCustomSocketManager::RefreshSocketList()
 {
+	UpdateSeatList();
+
+	// Set the socket on the detail view to keep it in sync with the sockets properties
+	if (USeatSocket* Socket = GetSelectedSocket())
+	{
+		TArray<UObject*> ObjectList;
+		ObjectList.Add(Socket);
+		SocketDetailsView->SetObjects(ObjectList, true);
+	}
+}
+
+void SCustomSocketManager::UpdateSeatList()
+{
+	SEAT_SCOPE_CYCLE_COUNTER(STAT_CustomSocket_RefreshSocketList);
+
+	TArray<FSeatInstance> Sockets;
+	bool bIsSameStaticMesh = true;
 	if (StaticMeshSocketEditor)
 	{
-		bool bIsSameStaticMesh = true;
-		UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
-		if (!StaticMesh.IsValid() || CurrentStaticMesh != StaticMesh.Get())
+		const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+		if (StaticMesh.IsNull() || CurrentStaticMesh != StaticMesh)
 		{
 			StaticMesh = CurrentStaticMesh;
 			bIsSameStaticMesh = false;
 		}
-		// Only rebuild the socket list if it differs from the static meshes socket list
-		// This is done so that an undo on a socket property doesn't cause the selected
-		// socket to be de-selected, thus hiding the socket properties on the detail view.
-		// NB: Also force a rebuild if the underlying StaticMesh has been changed.
-		const TArray<USeatSocket*>& Sockets = SeatMap->GetSeats(CurrentStaticMesh).Seats;
-		if (Sockets.Num() != SocketList.Num() || !bIsSameStaticMesh)
-		{
-			SocketList.Empty();
-			for (int32 i = 0; i < Sockets.Num(); i++)
-			{
-				USeatSocket* Socket = Sockets[i];
-				SocketList.Add(MakeShareable(new SocketListItem(Socket)));
-			}
 
-			SocketListView->RequestListRefresh();
-		}
+		SeatMap->GatherSeats(CurrentStaticMesh, Sockets);
+	}
 
-		// Set the socket on the detail view to keep it in sync with the sockets properties
-		if (SocketListView->GetSelectedItems().Num())
+	// Rows are patched in place rather than rebuilt, so an undo on a socket property doesn't cause the
+	// selected socket to be de-selected, thus hiding the socket properties on the detail view.
+	USeatSocket* SelectedSocket = bIsSameStaticMesh ? GetSelectedSocket() : nullptr;
+	const bool bIsSameSocketList = SeatListModel->HasSameSeats(Sockets);
+	if (!bIsSameSocketList)
+	{
+		RemovePropertyChangeListenerFromSockets();
+	}
+
+	if (SeatListModel->Update(Sockets))
+	{
+		// Items are row indices, after seats were added or removed the selected seat may sit in another row.
+		const FSeatListItem SelectedItem = SeatListModel->FindSeat(SelectedSocket);
+		const TArray<FSeatListItem> SelectedItems = SocketListView->GetSelectedItems();
+		if (!SelectedItem.IsValid())
 		{
-			TArray<UObject*> ObjectList;
-			ObjectList.Add(SocketListView->GetSelectedItems()[0]->Socket);
-			SocketDetailsView->SetObjects(ObjectList, true);
+			SocketListView->ClearSelection();
+		}
+		else if (SelectedItems.Num() == 0 || SelectedItems[0] != SelectedItem)
+		{
+			SocketListView->SetSelection(SelectedItem);
 		}
 
-		// TODO
-		// StaticMeshEditorPinned->RefreshViewport();
+		DeferredRenameRequest = FSeatListItem();
+		RequestSeatListRefresh();
 	}
-	else
+
+	if (!bIsSameSocketList)
 	{
-		SocketList.Empty();
-		SocketListView->ClearSelection();
-		SocketListView->RequestListRefresh();
+		AddPropertyChangeListenerToSockets();
 	}
+
+	InvalidateSeatListStatus();
 }
 
 bool SCustomSocketManager::CheckForDuplicateSocket(const FString& InSocketName)
 {
-	for (int32 i = 0; i < SocketList.Num(); i++)
+	for (const FSeatListModel::FRow& Row : SeatListModel->GetSeatRows())
 	{
-		if (SocketList[i]->Socket->Name.ToString() == InSocketName)
+		if (Row.Seat->Name.ToString() == InSocketName)
 		{
 			return true;
 		}
@@ -597,48 +1045,291 @@ void SCustomSocketManager::SocketSelectionChanged(USeatSocket* InSocket)
 
 	SocketDetailsView->SetObjects(SelectedObject);
 
+	if (StaticMeshSocketEditor)
+	{
+		StaticMeshSocketEditor->SetSelectedSeat(InSocket);
+	}
+
+	InvalidateSeatListStatus();
+
 	// Notify listeners
 	OnSocketSelectionChanged.ExecuteIfBound();
 }
 
-void SCustomSocketManager::SocketSelectionChanged_Execute(TSharedPtr<SocketListItem> InItem,
+void SCustomSocketManager::SocketSelectionChanged_Execute(FSeatListItem InItem,
                                                           ESelectInfo::Type /*SelectInfo*/)
 {
-	if (InItem.IsValid())
+	// Group rows select no socket.
+	SocketSelectionChanged(SeatListModel->GetSeat(InItem));
+}
+
+FReply SCustomSocketManager::CreateSeatSocket_Execute()
+{
+	CreateSeatSocket();
+
+	return FReply::Handled();
+}
+
+FReply SCustomSocketManager::CopySeats_Execute()
+{
+	CopySeat();
+
+	return FReply::Handled();
+}
+
+FReply SCustomSocketManager::ProposeSeats_Execute()
+{
+	ProposeSeats();
+
+	return FReply::Handled();
+}
+
+FReply SCustomSocketManager::ValidateSeats_Execute()
+{
+	TArray<FSeatMeshValidationResult> Results;
+	FSeatValidator::Get().ValidateSeatMap(SeatMap, Results);
+	FSeatValidator::ReportResults(SeatMap, Results);
+
+	FMessageLog("CustomSocket").Open();
+
+	return FReply::Handled();
+}
+
+FReply SCustomSocketManager::BakeSeatData_Execute()
+{
+	const FScopedTransaction Transaction(LOCTEXT("BakeSeatDataTransaction", "Bake Seat Data"));
+	SeatMap->PreEditChange(NULL);
+	const FSeatBoardingBakeStats Stats = FSeatBoardingBaker::Get().BakeSeatMap(SeatMap);
+	const FSeatFireArcBakeStats FireArcStats = FSeatFireArcBaker::Get().BakeSeatMap(SeatMap);
+	SeatMap->PostEditChange();
+	SeatMap->MarkPackageDirty();
+
+	FFormatNamedArguments Arguments;
+	Arguments.Add(TEXT("SeatMap"), FText::FromString(SeatMap->GetName()));
+	Arguments.Add(TEXT("NumBaked"), Stats.NumMeshesBaked);
+	Arguments.Add(TEXT("NumCached"), Stats.NumMeshesFromCache);
+	Arguments.Add(TEXT("NumUnreachable"), Stats.NumUnreachableSeats);
+
+	FMessageLog MessageLog("CustomSocket");
+	const FText Message = FText::Format(
+		LOCTEXT("BoardingBaked", "{SeatMap}: boarding paths of {NumBaked} meshes baked, {NumCached} taken from the cache, {NumUnreachable} seats cannot be reached."),
+		Arguments);
+	if (Stats.NumUnreachableSeats > 0)
 	{
-		SocketSelectionChanged(InItem->Socket);
+		MessageLog.Warning(Message);
 	}
 	else
 	{
-		SocketSelectionChanged(NULL);
+		MessageLog.Info(Message);
+	}
+
+	Arguments.Add(TEXT("NumBaked"), FireArcStats.NumMeshesBaked);
+	Arguments.Add(TEXT("NumCached"), FireArcStats.NumMeshesFromCache);
+	Arguments.Add(TEXT("NumBlocked"), FireArcStats.NumBlockedSeats);
+	const FText FireArcMessage = FText::Format(
+		LOCTEXT("FireArcsBaked", "{SeatMap}: firing arcs of {NumBaked} meshes baked, {NumCached} taken from the cache, {NumBlocked} fireable seats are blocked in every direction."),
+		Arguments);
+	if (FireArcStats.NumBlockedSeats > 0)
+	{
+		MessageLog.Warning(FireArcMessage);
+	}
+	else
+	{
+		MessageLog.Info(FireArcMessage);
 	}
+	MessageLog.Open();
+
+	return FReply::Handled();
 }
 
-FReply SCustomSocketManager::CreateSeatSocket_Execute()
+bool SCustomSocketManager::CanImportMeshSockets() const
 {
-	CreateSeatSocket();
+	return !SocketImporter.IsValid() || !SocketImporter->IsRunning();
+}
+
+FReply SCustomSocketManager::ImportMeshSockets_Execute()
+{
+	TArray<FAssetData> SelectedAssets;
+	FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser").Get().GetSelectedAssets(SelectedAssets);
+
+	// Only the asset data is read here, the importer loads the meshes in batches.
+	TArray<FSoftObjectPath> StaticMeshes;
+	for (const FAssetData& SelectedAsset : SelectedAssets)
+	{
+		if (SelectedAsset.AssetClass == UStaticMesh::StaticClass()->GetFName())
+		{
+			StaticMeshes.Add(SelectedAsset.ToSoftObjectPath());
+		}
+	}
+
+	if (StaticMeshes.Num() == 0 && !GetEditedMesh().IsNull())
+	{
+		StaticMeshes.Add(GetEditedMesh().ToSoftObjectPath());
+	}
+
+	if (StaticMeshes.Num() > 0)
+	{
+		SocketImporter = FSeatSocketImporter::Import(
+			SeatMap, StaticMeshes,
+			FSeatSocketImporter::FOnImportFinished::CreateSP(this, &SCustomSocketManager::OnMeshSocketsImported));
+		InvalidateSeatListStatus();
+	}
 
 	return FReply::Handled();
 }
 
-FReply SCustomSocketManager::CopySeats_Execute()
+void SCustomSocketManager::OnMeshSocketsImported(int32 NumImportedSeats)
 {
-	CopySeat();
+	if (NumImportedSeats > 0)
+	{
+		RefreshSocketList();
+	}
+
+	InvalidateSeatListStatus();
+}
+
+FReply SCustomSocketManager::MakeTemplate_Execute()
+{
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	if (!Seats || Seats->Seats.Num() == 0 || !Seats->Template.IsNone())
+		return FReply::Handled();
+
+	const FScopedTransaction Transaction(LOCTEXT("MakeTemplate", "Make Template"));
+	SeatMap->PreEditChange(NULL);
+	SeatMap->MakeTemplate(CurrentStaticMesh, FName(*CurrentStaticMesh.GetAssetName()));
+	SeatMap->PostEditChange();
+	SeatMap->MarkPackageDirty();
+
+	RefreshSocketList();
 
 	return FReply::Handled();
 }
 
-FText SCustomSocketManager::GetSocketHeaderText() const
+FReply SCustomSocketManager::MirrorSeats_Execute()
 {
-	UStaticMesh* CurrentStaticMesh = nullptr;
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	if (CurrentStaticMesh.IsNull())
+		return FReply::Handled();
 
-	if (StaticMeshSocketEditor)
+	const FScopedTransaction Transaction(LOCTEXT("MirrorSeats", "Mirror Seats"));
+	SeatMap->PreEditChange(NULL);
+	const TArray<USeatSocket*> MirroredSeats = SeatMap->MirrorSeats(CurrentStaticMesh, FPlane(FVector::RightVector, 0.f));
+	SeatMap->PostEditChange();
+
+	if (MirroredSeats.Num() > 0)
+	{
+		SeatMap->MarkPackageDirty();
+		RefreshSocketList();
+	}
+
+	return FReply::Handled();
+}
+
+void SCustomSocketManager::RefreshTemplateOptions()
+{
+	TemplateOptions.Reset();
+	TemplateOptions.Add(MakeShared<FName>(NAME_None));
+
+	TArray<FName> TemplateNames;
+	SeatMap->Templates.GetKeys(TemplateNames);
+	TemplateNames.Sort(FNameLexicalLess());
+	for (const FName TemplateName : TemplateNames)
+	{
+		TemplateOptions.Add(MakeShared<FName>(TemplateName));
+	}
+}
+
+TSharedRef<SWidget> SCustomSocketManager::MakeTemplateOptionWidget(TSharedPtr<FName> InTemplateName) const
+{
+	return SNew(STextBlock)
+		.Text(InTemplateName->IsNone() ? LOCTEXT("NoTemplate", "None") : FText::FromName(*InTemplateName));
+}
+
+void SCustomSocketManager::OnTemplateSelected(TSharedPtr<FName> InTemplateName, ESelectInfo::Type SelectInfo)
+{
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	if (!InTemplateName.IsValid() || CurrentStaticMesh.IsNull() || (Seats && Seats->Template == *InTemplateName))
+		return;
+
+	const FScopedTransaction Transaction(LOCTEXT("SetTemplate", "Set Seat Template"));
+	SeatMap->PreEditChange(NULL);
+	SeatMap->SetTemplate(CurrentStaticMesh, *InTemplateName, Seats ? Seats->TemplateTransform : FTransform::Identity);
+	SeatMap->PostEditChange();
+	SeatMap->MarkPackageDirty();
+
+	RefreshSocketList();
+}
+
+FText SCustomSocketManager::GetTemplateText() const
+{
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	return Seats && !Seats->Template.IsNone() ? FText::FromName(Seats->Template) : LOCTEXT("NoTemplate", "None");
+}
+
+EVisibility SCustomSocketManager::GetTemplateOffsetVisibility() const
+{
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	return Seats && !Seats->Template.IsNone() ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+FVector SCustomSocketManager::GetTemplateOffset() const
+{
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	return Seats ? Seats->TemplateTransform.GetLocation() : FVector::ZeroVector;
+}
+
+TSharedRef<SWidget> SCustomSocketManager::MakeTemplateOffsetWidget(const FVector& Offset)
+{
+	return SNew(SVectorInputBox)
+		.AllowSpin(false)
+		.X(Offset.X)
+		.Y(Offset.Y)
+		.Z(Offset.Z)
+		.OnXCommitted(this, &SCustomSocketManager::OnTemplateOffsetCommitted, EAxis::X)
+		.OnYCommitted(this, &SCustomSocketManager::OnTemplateOffsetCommitted, EAxis::Y)
+		.OnZCommitted(this, &SCustomSocketManager::OnTemplateOffsetCommitted, EAxis::Z);
+}
+
+void SCustomSocketManager::OnTemplateOffsetCommitted(float InValue, ETextCommit::Type CommitType, EAxis::Type Axis)
+{
+	const TSoftObjectPtr<UStaticMesh> CurrentStaticMesh = GetEditedMesh();
+	const FSeats* Seats = SeatMap->FindSeats(CurrentStaticMesh);
+	if (!Seats)
+		return;
+
+	FTransform TemplateTransform = Seats->TemplateTransform;
+	FVector Offset = TemplateTransform.GetLocation();
+	if (Offset.GetComponentForAxis(Axis) == InValue)
+		return;
+
+	Offset.SetComponentForAxis(Axis, InValue);
+	TemplateTransform.SetLocation(Offset);
+
+	const FScopedTransaction Transaction(LOCTEXT("SetTemplateOffset", "Set Seat Template Offset"));
+	SeatMap->PreEditChange(NULL);
+	SeatMap->SetTemplate(CurrentStaticMesh, Seats->Template, TemplateTransform);
+	SeatMap->PostEditChange();
+	SeatMap->MarkPackageDirty();
+
+	InvalidateSeatListStatus();
+}
+
+FText SCustomSocketManager::GetSocketHeaderText() const
+{
+	const int32 NumSeats = SeatListModel->GetNumSeats();
+	const int32 NumVisibleSeats = SeatListModel->GetNumVisibleSeats();
+	if (NumVisibleSeats != NumSeats)
 	{
-		CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
+		return FText::Format(LOCTEXT("SocketHeader_FilteredFmt", "{0} of {1} sockets"),
+		                     FText::AsNumber(NumVisibleSeats), FText::AsNumber(NumSeats));
 	}
-	return FText::Format(
-		LOCTEXT("SocketHeader_TotalFmt", "{0} sockets"),
-		FText::AsNumber((CurrentStaticMesh != nullptr) ? CurrentStaticMesh->Sockets.Num() : 0));
+
+	return FText::Format(LOCTEXT("SocketHeader_TotalFmt", "{0} sockets"), FText::AsNumber(NumSeats));
 }
 
 void SCustomSocketManager::SocketName_TextChanged(const FText& InText)
@@ -665,6 +1356,16 @@ TSharedPtr<SWidget> SCustomSocketManager::OnContextMenuOpening()
 			MenuBuilder.AddMenuEntry(FGenericCommands::Get().Delete);
 			MenuBuilder.AddMenuEntry(FGenericCommands::Get().Duplicate);
 			MenuBuilder.AddMenuEntry(FGenericCommands::Get().Rename);
+
+			const FSeatListModel::FRow* SelectedRow = GetSelectedRow();
+			if (SelectedRow && SelectedRow->bFromTemplate)
+			{
+				MenuBuilder.AddMenuEntry(
+					LOCTEXT("OverrideSocket", "Override For This Mesh"),
+					LOCTEXT("OverrideSocketTooltip", "Copies the template socket into this mesh, where it replaces the template's."),
+					FSlateIcon(),
+					FUIAction(FExecuteAction::CreateSP(this, &SCustomSocketManager::OverrideSelectedSocket)));
+			}
 		}
 		MenuBuilder.EndSection();
 	}
@@ -672,48 +1373,80 @@ TSharedPtr<SWidget> SCustomSocketManager::OnContextMenuOpening()
 	return MenuBuilder.MakeWidget();
 }
 
+void SCustomSocketManager::MakeSocketUnique(USeatSocket* InSocket)
+{
+	if (InSocket && StaticMeshSocketEditor)
+	{
+		SeatMap->MakeSeatUnique(StaticMeshSocketEditor->GetEditedMesh(), InSocket);
+	}
+}
+
+void SCustomSocketManager::RenameSocket(USeatSocket* InSocket, FName InName)
+{
+	if (!InSocket || !StaticMeshSocketEditor)
+		return;
+
+	RenameSeat(SeatMap, StaticMeshSocketEditor->GetEditedMesh(), InSocket, InName);
+
+	// The name decides the seat's place in the list and whether it passes the filter.
+	RefreshSocketList();
+}
+
+void SCustomSocketManager::RenameSeat(USeatMap* InSeatMap, const TSoftObjectPtr<UStaticMesh>& InStaticMesh,
+                                      USeatSocket* InSeat, FName InName)
+{
+	InSeatMap->MakeSeatUnique(InStaticMesh, InSeat);
+
+	FProperty* ChangedProperty = FindFProperty<FProperty>(USeatSocket::StaticClass(),
+	                                                      GET_MEMBER_NAME_CHECKED(USeatSocket, Name));
+
+	// Pre edit, calls modify on the object
+	InSeat->PreEditChange(ChangedProperty);
+
+	// Edit the property itself
+	InSeat->Name = InName;
+
+	// Post edit
+	FPropertyChangedEvent PropertyChangedEvent(ChangedProperty);
+	InSeat->PostEditChangeProperty(PropertyChangedEvent);
+}
+
+void SCustomSocketManager::NotifyPreChange(FProperty* PropertyAboutToChange)
+{
+	// Meshes with identical seats share seat objects, the edit must only reach the mesh being edited.
+	MakeSocketUnique(GetSelectedSocket());
+}
+
 void SCustomSocketManager::NotifyPostChange(const FPropertyChangedEvent& PropertyChangedEvent,
                                             FProperty* PropertyThatChanged)
 {
-	TArray<TSharedPtr<SocketListItem>> SelectedList = SocketListView->GetSelectedItems();
-	if (SelectedList.Num())
+	if (const USeatSocket* Socket = GetSelectedSocket())
 	{
 		if (PropertyThatChanged->GetName() == TEXT("Pitch") || PropertyThatChanged->GetName() == TEXT("Yaw") ||
 			PropertyThatChanged->GetName() == TEXT("Roll"))
 		{
-			const USeatSocket* Socket = SelectedList[0]->Socket;
 			WorldSpaceRotation.Set(Socket->RelativeRotation.Pitch, Socket->RelativeRotation.Yaw,
 			                       Socket->RelativeRotation.Roll);
 		}
 	}
+
+	// Name, type and posture decide where the seat is listed.
+	UpdateSeatList();
 }
 
 void SCustomSocketManager::AddPropertyChangeListenerToSockets()
 {
-	if (StaticMeshSocketEditor)
+	for (const FSeatListModel::FRow& Row : SeatListModel->GetSeatRows())
 	{
-		UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
-		FSeats Seats = SeatMap->GetSeats(CurrentStaticMesh);
-		for (int32 i = 0; i < Seats.Seats.Num(); ++i)
-		{
-			Seats.Seats[i]->OnPropertyChanged().AddSP(
-				this, &SCustomSocketManager::OnSocketPropertyChanged);
-		}
+		Row.Seat->OnPropertyChanged().AddSP(this, &SCustomSocketManager::OnSocketPropertyChanged);
 	}
 }
 
 void SCustomSocketManager::RemovePropertyChangeListenerFromSockets()
 {
-	if (StaticMeshSocketEditor)
+	for (const FSeatListModel::FRow& Row : SeatListModel->GetSeatRows())
 	{
-		UStaticMesh* CurrentStaticMesh = StaticMeshSocketEditor->GetStaticMesh();
-		if (CurrentStaticMesh)
-		{
-			for (int32 i = 0; i < CurrentStaticMesh->Sockets.Num(); ++i)
-			{
-				CurrentStaticMesh->Sockets[i]->OnPropertyChanged().RemoveAll(this);
-			}
-		}
+		Row.Seat->OnPropertyChanged().RemoveAll(this);
 	}
 }
 
@@ -786,14 +1519,26 @@ void SCustomSocketManager::PostUndo()
 	RefreshSocketList();
 }
 
-void SCustomSocketManager::OnItemScrolledIntoView(TSharedPtr<SocketListItem> InItem,
-                                                  const TSharedPtr<ITableRow>& InWidget)
+void SCustomSocketManager::OnSeatsReplaced(const TMap<USeatSocket*, USeatSocket*>& Replacements)
 {
-	TSharedPtr<SocketListItem> DeferredRenameRequestPinned = DeferredRenameRequest.Pin();
-	if (DeferredRenameRequestPinned.IsValid())
+	USeatSocket* SelectedSocket = GetSelectedSocket();
+	USeatSocket* const* Replacement = SelectedSocket ? Replacements.Find(SelectedSocket) : nullptr;
+
+	RefreshSocketList();
+
+	// The list drops a selected seat that left the mesh, its replacement is the same seat to the user.
+	if (Replacement && !SeatListModel->FindSeat(SelectedSocket).IsValid())
 	{
-		DeferredRenameRequestPinned->OnRenameRequested.ExecuteIfBound();
-		DeferredRenameRequest.Reset();
+		SetSelectedSocket(*Replacement);
+	}
+}
+
+void SCustomSocketManager::OnItemScrolledIntoView(FSeatListItem InItem, const TSharedPtr<ITableRow>& InWidget)
+{
+	if (DeferredRenameRequest.IsValid() && InItem == DeferredRenameRequest && InWidget.IsValid())
+	{
+		StaticCastSharedPtr<SSocketDisplayItem>(InWidget)->RequestRename();
+		DeferredRenameRequest = FSeatListItem();
 	}
 }
 
@@ -802,4 +1547,9 @@ void SCustomSocketManager::SetStaticMesh(UStaticMesh* InStaticMesh)
 	RefreshSocketList();
 }
 
+TSoftObjectPtr<UStaticMesh> SCustomSocketManager::GetEditedMesh() const
+{
+	return StaticMeshSocketEditor ? StaticMeshSocketEditor->GetEditedMesh() : TSoftObjectPtr<UStaticMesh>();
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -1,4 +1,4 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #pragma once
 
@@ -9,16 +9,19 @@
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/Views/STableViewBase.h"
 #include "Widgets/Views/STableRow.h"
+#include "Widgets/Views/STreeView.h"
 #include "Widgets/Input/SSpinBox.h"
 #include "IDetailsView.h"
 #include "SeatSocket/SeatSocket.h"
 #include "Widgets/SCustomSocketEditorWidget.h"
+#include "SeatListModel.h"
 
 class IStaticMeshEditor;
 class UStaticMesh;
 class UStaticMeshSocket;
 struct FPropertyChangedEvent;
-struct SocketListItem;
+struct FSeatCandidate;
+class SSearchBox;
 
 class SCustomSocketManager : public SCompoundWidget, public FNotifyHook
 {
@@ -44,6 +47,15 @@ public:
 	virtual void UpdateStaticMesh();
 	// End of ISocketManager
 
+	/** Copies the selected template socket into the mesh so it can be changed for this mesh only. */
+	void OverrideSelectedSocket();
+
+	/** Call before editing a socket in place, other meshes that share the socket get a copy of their own. */
+	void MakeSocketUnique(USeatSocket* InSocket);
+
+	/** Renames the seat of the edited mesh and refreshes the list. */
+	void RenameSocket(USeatSocket* InSocket, FName InName);
+
 	/**
  *	Checks for a duplicate socket using the name for comparison.
  *
@@ -53,22 +65,70 @@ public:
  */
 	bool CheckForDuplicateSocket(const FString& InSocketName);
 
+	/** Refreshes the socket list and the details of the selected socket. */
+	void RefreshSocketList();
+
+	/** Formats the seats as one tab separated line per field, the text Copy Seats puts on the clipboard. */
+	static FString ExportSeats(const TArray<FSeatInstance>& InSeats);
+
+	/**
+	 * Adds a seat for each candidate that does not overlap a seat of the mesh or an earlier candidate.
+	 * The new seats are named Seat, Seat0, Seat1, ... skipping every name the mesh already uses.
+	 * Call between PreEditChange and PostEditChange of the seat map.
+	 *
+	 * @return					The seats that were added.
+	 */
+	/**
+	 * Renames a seat as the seat list does, other meshes sharing the seat keep a copy with the old name.
+	 * Call inside a transaction.
+	 */
+	static void RenameSeat(USeatMap* InSeatMap, const TSoftObjectPtr<UStaticMesh>& InStaticMesh, USeatSocket* InSeat,
+	                       FName InName);
+
+	static TArray<USeatSocket*> AddSeatCandidates(USeatMap* InSeatMap, const TSoftObjectPtr<UStaticMesh>& InStaticMesh,
+	                                              const TArray<FSeatCandidate>& InCandidates);
+
 private:
 	/** Creates a widget from the list item. */
-	TSharedRef<ITableRow> MakeWidgetFromOption(TSharedPtr<struct SocketListItem> InItem,
-	                                           const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> MakeWidgetFromOption(FSeatListItem InItem, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Tree callbacks, groups list their seats and remember being collapsed. */
+	void GetSeatListChildren(FSeatListItem InItem, TArray<FSeatListItem>& OutChildren);
+	void OnSeatListExpansionChanged(FSeatListItem InItem, bool bExpanded);
+
+	/** Callback for the search box, filters the seats by name. */
+	void OnFilterTextChanged(const FText& InFilterText);
+
+	/** Expands new groups and refreshes the tree's items. */
+	void RequestSeatListRefresh();
+
+	/** The row of the selected seat, null if none or a group is selected. */
+	const FSeatListModel::FRow* GetSelectedRow() const;
 
 	/**	Creates a socket with a specified name. */
 	void CreateSeatSocket();
 
+	/** Adds the seat candidates of the current mesh that do not overlap an existing seat. */
+	void ProposeSeats();
+
 	void CopySeat();
 
-	/** Refreshes the socket list. */
-	void RefreshSocketList();
+	/** Patches the list's rows to the current mesh's seats. */
+	void UpdateSeatList();
 
 	/** Gets the visibility of the select a socket message */
 	EVisibility GetSelectSocketMessageVisibility() const;
 
+	/**
+	 * The header, the select a socket message and the template widgets show fixed values rather than polling
+	 * bindings every paint. Call after seats, the selection or the filter changed, the widgets update next tick.
+	 */
+	void InvalidateSeatListStatus();
+	EActiveTimerReturnType UpdateSeatListStatus(double InCurrentTime, float InDeltaTime);
+
+	/** Updates the row widget of the item, if the tree generated one. */
+	void RefreshSeatListRow(FSeatListItem InItem);
+
 	/** 
 	 *	Updates the details to the selected socket.
 	 *
@@ -77,12 +137,40 @@ private:
 	void SocketSelectionChanged(USeatSocket* InSocket);
 
 	/** Callback for the list view when an item is selected. */
-	void SocketSelectionChanged_Execute(TSharedPtr<SocketListItem> InItem, ESelectInfo::Type SelectInfo);
+	void SocketSelectionChanged_Execute(FSeatListItem InItem, ESelectInfo::Type SelectInfo);
 
 	/** Callback for the Create Socket button. */
 	FReply CreateSeatSocket_Execute();
 	FReply CopySeats_Execute();
 
+	FReply ProposeSeats_Execute();
+
+	/** Imports the sockets of the Content Browser's selected meshes, or of the current mesh, as seats. */
+	bool CanImportMeshSockets() const;
+	FReply ImportMeshSockets_Execute();
+	void OnMeshSocketsImported(int32 NumImportedSeats);
+
+	FReply MakeTemplate_Execute();
+	FReply MirrorSeats_Execute();
+
+	/** Seat template combo box callbacks, the first option is NAME_None for no template. */
+	void RefreshTemplateOptions();
+	TSharedRef<SWidget> MakeTemplateOptionWidget(TSharedPtr<FName> InTemplateName) const;
+	void OnTemplateSelected(TSharedPtr<FName> InTemplateName, ESelectInfo::Type SelectInfo);
+	FText GetTemplateText() const;
+
+	/** Offset of the template's seats on the current mesh. */
+	EVisibility GetTemplateOffsetVisibility() const;
+	FVector GetTemplateOffset() const;
+	TSharedRef<SWidget> MakeTemplateOffsetWidget(const FVector& Offset);
+	void OnTemplateOffsetCommitted(float InValue, ETextCommit::Type CommitType, EAxis::Type Axis);
+
+	/** Callback for the Validate Seats button, reports seats clipping into the mesh collision. */
+	FReply ValidateSeats_Execute();
+
+	/** Callback for the Bake Seat Data button, brings the seat map's boarding paths and firing arcs up to date. */
+	FReply BakeSeatData_Execute();
+
 	FText GetSocketHeaderText() const;
 
 	/** Callback for when the socket name textbox is changed, verifies the name is not a duplicate. */
@@ -92,6 +180,7 @@ private:
 	TSharedPtr<SWidget> OnContextMenuOpening();
 
 	/** FNotifyHook interface */
+	virtual void NotifyPreChange(FProperty* PropertyAboutToChange) override;
 	virtual void NotifyPostChange(const FPropertyChangedEvent& PropertyChangedEvent,
 	                              FProperty* PropertyThatChanged) override;
 
@@ -99,9 +188,12 @@ private:
 	void PostUndo();
 
 	/** Callback when an item is scrolled into view, handling calls to rename items */
-	void OnItemScrolledIntoView(TSharedPtr<SocketListItem> InItem, const TSharedPtr<ITableRow>& InWidget);
+	void OnItemScrolledIntoView(FSeatListItem InItem, const TSharedPtr<ITableRow>& InWidget);
 private:
 	void SetStaticMesh(UStaticMesh* InStaticMesh);
+
+	/** The mesh whose seats are listed, known before the mesh has finished loading. */
+	TSoftObjectPtr<UStaticMesh> GetEditedMesh() const;
 	
 	/** Add a property change listener to each socket. */
 	void AddPropertyChangeListenerToSockets();
@@ -112,23 +204,41 @@ private:
 	/** Called when a socket property has changed. */
 	void OnSocketPropertyChanged(const USeatSocket* Socket, const FProperty* ChangedProperty);
 
+	/** Lists the seat objects that replaced the shown ones and keeps the selection on the replacement. */
+	void OnSeatsReplaced(const TMap<USeatSocket*, USeatSocket*>& Replacements);
+
 	/** Called when socket selection changes */
 	FSimpleDelegate OnSocketSelectionChanged;
 	
 	/** Details panel for the selected socket. */
 	TSharedPtr<class IDetailsView> SocketDetailsView;
 
-	/** List of sockets for for the associated static mesh or anim set. */
-	TArray<TSharedPtr<SocketListItem>> SocketList;
+	/** Rows of the sockets for the associated static mesh, grouped by seat type and posture. */
+	TSharedRef<FSeatListModel> SeatListModel = MakeShared<FSeatListModel>();
+
+	/** Tree view for displaying the sockets. */
+	TSharedPtr<STreeView<FSeatListItem>> SocketListView;
 
-	/** Listview for displaying the sockets. */
-	TSharedPtr<SListView<TSharedPtr<SocketListItem>>> SocketListView;
+	TSharedPtr<SSearchBox> SearchBox;
+
+	/** Widgets updated by UpdateSeatListStatus. */
+	TSharedPtr<STextBlock> SocketHeaderText;
+	TSharedPtr<SWidget> SelectSocketMessage;
+	TSharedPtr<STextBlock> TemplateText;
+	TSharedPtr<SWidget> TemplateOffsetRow;
+	TSharedPtr<class SBox> TemplateOffsetBox;
+	TOptional<FVector> DisplayedTemplateOffset;
+	TSharedPtr<class SButton> ImportMeshSocketsButton;
+	bool bSeatListStatusPending = false;
+
+	/** Groups the user collapsed, new groups are expanded. */
+	TSet<FSeatListItem> CollapsedGroups;
 
 	/** Helper variable for rotating in world space. */
 	FVector WorldSpaceRotation;
 
 	/** The static mesh being edited. */
-	TWeakObjectPtr<UStaticMesh> StaticMesh;
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
 
 	/** Widgets for the World Space Rotation */
 	TSharedPtr<SSpinBox<float>> PitchRotation;
@@ -136,9 +246,15 @@ private:
 	TSharedPtr<SSpinBox<float>> RollRotation;
 
 	/** Points to an item that is being requested to be renamed */
-	TWeakPtr<SocketListItem> DeferredRenameRequest;
+	FSeatListItem DeferredRenameRequest;
 
 	USeatMap* SeatMap;
+
+	/** Runs while mesh sockets are being imported. */
+	TSharedPtr<class FSeatSocketImporter> SocketImporter;
+
+	/** Options of the seat template combo box. */
+	TArray<TSharedPtr<FName>> TemplateOptions;
 	
 	TSharedPtr<FStaticMeshSocketEditor> StaticMeshSocketEditor;
 };
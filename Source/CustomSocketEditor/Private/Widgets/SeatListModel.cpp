@@ -0,0 +1,208 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SeatListModel.h"
+
+#define LOCTEXT_NAMESPACE "SeatListModel"
+
+FSeatListModel::FSeatListModel()
+{
+	const UEnum* SeatTypeEnum = StaticEnum<ESeatType>();
+	const UEnum* PostureEnum = StaticEnum<EPosture>();
+	NumPostures = PostureEnum->NumEnums() - 1;
+	NumGroups = (SeatTypeEnum->NumEnums() - 1) * NumPostures;
+
+	Rows.SetNum(NumGroups);
+	GroupChildren.SetNum(NumGroups);
+	for (int32 TypeIndex = 0; TypeIndex < SeatTypeEnum->NumEnums() - 1; ++TypeIndex)
+	{
+		for (int32 PostureIndex = 0; PostureIndex < NumPostures; ++PostureIndex)
+		{
+			FRow& Group = Rows[TypeIndex * NumPostures + PostureIndex];
+			Group.SeatType = static_cast<ESeatType>(SeatTypeEnum->GetValueByIndex(TypeIndex));
+			Group.Posture = static_cast<EPosture>(PostureEnum->GetValueByIndex(PostureIndex));
+			Group.Label = FText::Format(LOCTEXT("GroupLabel", "{0} / {1}"),
+			                            SeatTypeEnum->GetDisplayNameTextByIndex(TypeIndex),
+			                            PostureEnum->GetDisplayNameTextByIndex(PostureIndex));
+		}
+	}
+}
+
+bool FSeatListModel::HasSameSeats(const TArray<FSeatInstance>& InSeats) const
+{
+	if (InSeats.Num() != GetNumSeats())
+		return false;
+
+	for (int32 SeatIndex = 0; SeatIndex < InSeats.Num(); ++SeatIndex)
+	{
+		if (Rows[NumGroups + SeatIndex].Seat != InSeats[SeatIndex].Seat)
+			return false;
+	}
+
+	return true;
+}
+
+bool FSeatListModel::Update(const TArray<FSeatInstance>& InSeats)
+{
+	bool bItemsChanged = !HasSameSeats(InSeats);
+	if (bItemsChanged)
+	{
+		Rows.SetNum(NumGroups + InSeats.Num());
+		SeatRows.Reset();
+		for (int32 SeatIndex = 0; SeatIndex < InSeats.Num(); ++SeatIndex)
+		{
+			FRow& Row = Rows[NumGroups + SeatIndex];
+			Row = FRow();
+			Row.Seat = InSeats[SeatIndex].Seat;
+			Row.SeatType = Row.Seat->SeatType;
+			Row.Posture = Row.Seat->Posture;
+			Row.Name = Row.Seat->Name;
+			Row.bPassesFilter = PassesFilter(Row);
+			SeatRows.Add(Row.Seat, NumGroups + SeatIndex);
+		}
+	}
+
+	// Rows whose seat was only edited keep their index, so the tree keeps their widgets and selection.
+	for (int32 SeatIndex = 0; SeatIndex < InSeats.Num(); ++SeatIndex)
+	{
+		FRow& Row = Rows[NumGroups + SeatIndex];
+		const USeatSocket* Seat = Row.Seat;
+		Row.bFromTemplate = InSeats[SeatIndex].bFromTemplate;
+
+		if (Row.SeatType != Seat->SeatType || Row.Posture != Seat->Posture || Row.Name != Seat->Name)
+		{
+			Row.SeatType = Seat->SeatType;
+			Row.Posture = Seat->Posture;
+			Row.Name = Seat->Name;
+			Row.bPassesFilter = PassesFilter(Row);
+			bItemsChanged = true;
+		}
+	}
+
+	if (bItemsChanged)
+	{
+		RebuildItems();
+	}
+
+	return bItemsChanged;
+}
+
+bool FSeatListModel::SetFilterText(const FString& InFilterText)
+{
+	if (InFilterText == FilterText)
+		return false;
+
+	// Seats hidden by the previous text are hidden by any text containing it.
+	const bool bNarrowing = InFilterText.Contains(FilterText);
+	FilterText = InFilterText;
+
+	bool bVisibilityChanged = false;
+	auto UpdateRow = [this, &bVisibilityChanged](FRow& Row)
+	{
+		const bool bPassesFilter = PassesFilter(Row);
+		bVisibilityChanged |= bPassesFilter != Row.bPassesFilter;
+		Row.bPassesFilter = bPassesFilter;
+	};
+
+	if (bNarrowing)
+	{
+		for (const TArray<FSeatListItem>& Children : GroupChildren)
+		{
+			for (const FSeatListItem& Child : Children)
+			{
+				UpdateRow(Rows[Child.Index]);
+			}
+		}
+	}
+	else
+	{
+		for (int32 RowIndex = NumGroups; RowIndex < Rows.Num(); ++RowIndex)
+		{
+			UpdateRow(Rows[RowIndex]);
+		}
+	}
+
+	if (bVisibilityChanged)
+	{
+		RebuildItems();
+	}
+
+	return bVisibilityChanged;
+}
+
+void FSeatListModel::GetChildren(FSeatListItem InItem, TArray<FSeatListItem>& OutChildren) const
+{
+	if (InItem.IsValid() && InItem.Index < NumGroups)
+	{
+		OutChildren = GroupChildren[InItem.Index];
+	}
+}
+
+USeatSocket* FSeatListModel::GetSeat(FSeatListItem InItem) const
+{
+	return Rows.IsValidIndex(InItem.Index) ? Rows[InItem.Index].Seat : nullptr;
+}
+
+FSeatListItem FSeatListModel::FindSeat(const USeatSocket* InSeat) const
+{
+	const int32* RowIndex = SeatRows.Find(InSeat);
+	return RowIndex ? FSeatListItem(*RowIndex) : FSeatListItem();
+}
+
+FSeatListItem FSeatListModel::GetGroup(FSeatListItem InItem) const
+{
+	if (!Rows.IsValidIndex(InItem.Index) || InItem.Index < NumGroups)
+		return InItem;
+
+	const FRow& Row = Rows[InItem.Index];
+	return FSeatListItem(GetGroupIndex(Row.SeatType, Row.Posture));
+}
+
+int32 FSeatListModel::GetGroupIndex(ESeatType SeatType, EPosture Posture) const
+{
+	const int32 TypeIndex = StaticEnum<ESeatType>()->GetIndexByValue(static_cast<int64>(SeatType));
+	const int32 PostureIndex = StaticEnum<EPosture>()->GetIndexByValue(static_cast<int64>(Posture));
+	return TypeIndex * NumPostures + PostureIndex;
+}
+
+bool FSeatListModel::PassesFilter(const FRow& Row) const
+{
+	return FilterText.IsEmpty() || Row.Name.ToString().Contains(FilterText);
+}
+
+void FSeatListModel::RebuildItems()
+{
+	for (TArray<FSeatListItem>& Children : GroupChildren)
+	{
+		Children.Reset();
+	}
+
+	for (int32 RowIndex = NumGroups; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		const FRow& Row = Rows[RowIndex];
+		if (Row.bPassesFilter)
+		{
+			GroupChildren[GetGroupIndex(Row.SeatType, Row.Posture)].Add(FSeatListItem(RowIndex));
+		}
+	}
+
+	RootItems.Reset();
+	NumVisibleSeats = 0;
+	for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+	{
+		TArray<FSeatListItem>& Children = GroupChildren[GroupIndex];
+		Children.Sort([this](const FSeatListItem& A, const FSeatListItem& B)
+		{
+			return FNameLexicalLess()(Rows[A.Index].Name, Rows[B.Index].Name);
+		});
+
+		Rows[GroupIndex].NumVisibleSeats = Children.Num();
+		NumVisibleSeats += Children.Num();
+		if (Children.Num() > 0)
+		{
+			RootItems.Add(FSeatListItem(GroupIndex));
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
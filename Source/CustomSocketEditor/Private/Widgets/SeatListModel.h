@@ -0,0 +1,165 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Views/TableViewTypeTraits.h"
+#include "SeatSocket/SeatSocket.h"
+
+class ITableRow;
+struct FSparseItemInfo;
+
+/** Index of a row in FSeatListModel, the seat tree holds these instead of a heap allocated item per seat. */
+struct FSeatListItem
+{
+	FSeatListItem() = default;
+
+	explicit FSeatListItem(int32 InIndex)
+		: Index(InIndex)
+	{
+	}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	bool operator==(const FSeatListItem& Other) const { return Index == Other.Index; }
+	bool operator!=(const FSeatListItem& Other) const { return Index != Other.Index; }
+
+	friend uint32 GetTypeHash(const FSeatListItem& Item) { return ::GetTypeHash(Item.Index); }
+
+	int32 Index = INDEX_NONE;
+};
+
+template <>
+struct TIsValidListItem<FSeatListItem>
+{
+	enum
+	{
+		Value = true
+	};
+};
+
+/** Lets list and tree views hold row indices, INDEX_NONE plays the part of the null pointer. */
+template <>
+struct TListTypeTraits<FSeatListItem>
+{
+public:
+	typedef FSeatListItem NullableType;
+
+	using MapKeyFuncs = TDefaultMapHashableKeyFuncs<FSeatListItem, TSharedRef<ITableRow>, false>;
+	using MapKeyFuncsSparse = TDefaultMapHashableKeyFuncs<FSeatListItem, FSparseItemInfo, false>;
+	using SetKeyFuncs = DefaultKeyFuncs<FSeatListItem>;
+
+	/** Rows reference no objects, the seats are held by the seat map. */
+	template <typename... ArgTypes>
+	static void AddReferencedObjects(FReferenceCollector& Collector, ArgTypes&...)
+	{
+	}
+
+	static bool IsPtrValid(const FSeatListItem& InItem) { return InItem.IsValid(); }
+	static void ResetPtr(FSeatListItem& InItem) { InItem = FSeatListItem(); }
+	static FSeatListItem MakeNullPtr() { return FSeatListItem(); }
+	static FSeatListItem NullableItemTypeConvertToItemType(const FSeatListItem& InItem) { return InItem; }
+	static FString DebugDump(FSeatListItem InItem) { return FString::FromInt(InItem.Index); }
+
+	class SerializerType
+	{
+	};
+};
+
+/**
+ * Rows of the seat list, one group per seat type and posture followed by one row per seat.
+ * Rows live in a single array the tree refers to by index. Updating from the gathered seats patches rows
+ * in place, the tree only has to refresh its items when seats were added, removed, renamed or regrouped.
+ */
+class FSeatListModel
+{
+public:
+	struct FRow
+	{
+		/** The seat, null for group rows. */
+		USeatSocket* Seat = nullptr;
+
+		/** Whether the seat belongs to the mesh's template. */
+		bool bFromTemplate = false;
+
+		ESeatType SeatType = ESeatType::Normal;
+		EPosture Posture = EPosture::StandUp;
+
+		/** Seat name as of the last update, seats are sorted and filtered by it. */
+		FName Name;
+
+		/** Display name of group rows. */
+		FText Label;
+
+		/** Seat rows: whether the seat passes the filter. Group rows: number of seats that do. */
+		bool bPassesFilter = true;
+		int32 NumVisibleSeats = 0;
+	};
+
+	FSeatListModel();
+
+	/** Whether the rows hold exactly these seats in this order. */
+	bool HasSameSeats(const TArray<FSeatInstance>& InSeats) const;
+
+	/**
+	 * Matches the rows to the seats of a mesh.
+	 *
+	 * @return		TRUE if the tree's items changed, FALSE if rows were at most patched in place.
+	 */
+	bool Update(const TArray<FSeatInstance>& InSeats);
+
+	/**
+	 * Hides seats whose name does not contain the text.
+	 * A text that extends the previous one only rechecks the seats that passed before.
+	 *
+	 * @return		TRUE if any seat was shown or hidden.
+	 */
+	bool SetFilterText(const FString& InFilterText);
+
+	/** Groups with at least one seat passing the filter. */
+	const TArray<FSeatListItem>& GetRootItems() const { return RootItems; }
+
+	/** Seats of a group that pass the filter, sorted by name. */
+	void GetChildren(FSeatListItem InItem, TArray<FSeatListItem>& OutChildren) const;
+
+	const FRow& GetRow(FSeatListItem InItem) const { return Rows[InItem.Index]; }
+
+	/** The item's seat, null for groups and invalid items. */
+	USeatSocket* GetSeat(FSeatListItem InItem) const;
+
+	/** The seat's row, invalid if the seat is not listed. */
+	FSeatListItem FindSeat(const USeatSocket* InSeat) const;
+
+	/** The group the seat row belongs to. */
+	FSeatListItem GetGroup(FSeatListItem InItem) const;
+
+	/** Rows of all seats, including the ones the filter hides. */
+	TArrayView<const FRow> GetSeatRows() const { return MakeArrayView(Rows).Slice(NumGroups, Rows.Num() - NumGroups); }
+
+	int32 GetNumSeats() const { return Rows.Num() - NumGroups; }
+
+	/** Number of seats passing the filter. */
+	int32 GetNumVisibleSeats() const { return NumVisibleSeats; }
+
+private:
+	int32 GetGroupIndex(ESeatType SeatType, EPosture Posture) const;
+
+	bool PassesFilter(const FRow& Row) const;
+
+	/** Rebuilds the groups' children and the root items from the rows. */
+	void RebuildItems();
+
+	/** Groups first, then seats in gathered order. */
+	TArray<FRow> Rows;
+	int32 NumGroups = 0;
+	int32 NumPostures = 0;
+
+	TMap<const USeatSocket*, int32> SeatRows;
+
+	/** Visible seats per group. */
+	TArray<TArray<FSeatListItem>> GroupChildren;
+	TArray<FSeatListItem> RootItems;
+	int32 NumVisibleSeats = 0;
+
+	FString FilterText;
+};
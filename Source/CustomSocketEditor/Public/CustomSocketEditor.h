@@ -6,6 +6,8 @@
 #include "AssetTypeCategories.h"
 #include "Modules/ModuleManager.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogCustomSocket, Log, All);
+
 class ISocketManager;
 class FToolBarBuilder;
 class FMenuBuilder;
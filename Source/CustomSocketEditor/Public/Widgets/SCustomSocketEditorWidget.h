@@ -7,12 +7,34 @@
 #include "IStaticMeshEditor.h"
 #include "SAssetEditorViewport.h"
 #include "SCommonEditorViewportToolbarBase.h"
+#include "Engine/StreamableManager.h"
 #include "SeatPreviewComponent.h"
 
+class FSeatPosePool;
+class FSeatPreviewWorld;
+class FSeatPreviewRebuildScheduler;
 class FStaticMeshSocketEditor;
 class ICustomSocketToolkitHost;
+class USeatGizmoComponent;
 class USeatMap;
 
+/** How comparison meshes are placed relative to the edited mesh. */
+enum class ESeatCompareLayout : uint8
+{
+	/** Side by side along the Y axis. */
+	Tiled,
+	/** On the edited mesh, only their seats are drawn, to spot seats that differ between variants. */
+	Overlaid
+};
+
+/** A comparison mesh in the editor's preview scene, its seats are drawn as gizmos. */
+struct FSeatMeshPane
+{
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
+	UStaticMeshComponent* MeshComponent = nullptr;
+	USeatGizmoComponent* GizmoComponent = nullptr;
+};
+
 class CUSTOMSOCKETEDITOR_API SCustomSocketEditorWidget : public SAssetEditorViewport, public FGCObject,
                                                          public ICommonEditorViewportToolbarInfoProvider
 {
@@ -39,12 +61,56 @@ public:
 	virtual TSharedRef<FEditorViewportClient> MakeEditorViewportClient() override;
 
 	void SetStaticMesh(UStaticMesh* InStaticMesh);
-	void OnSocketSelectionChanged();
+	void OnSocketSelectionChanged(USeatSocket* InSelectedSocket);
 	void RebuildSeatPreviewComponents(UObject* Object);
+	void OnStaticMeshChanged(UStaticMesh* InStaticMesh);
 	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+	/** Shown over the empty viewport while the edited mesh streams in. */
+	EVisibility GetLoadingMeshVisibility() const;
+	FText GetLoadingMeshText() const;
+
+	/** Draws all seats as lightweight gizmos and keeps a skeletal preview for the selected seat only. */
+	void SetShowSeatGizmos(bool bInShowSeatGizmos);
+	bool IsShowingSeatGizmos() const { return bShowSeatGizmos; }
+
+	/**
+	 * Shows other meshes of the seat map with their seats next to the edited mesh.
+	 * The panes share this editor's preview scene, and meshes that stay in the list are not reloaded.
+	 */
+	void SetCompareMeshes(const TArray<FSoftObjectPath>& InStaticMeshes);
+	void SetCompareLayout(ESeatCompareLayout InCompareLayout);
+	ESeatCompareLayout GetCompareLayout() const { return CompareLayout; }
 private:
+	/** Adds panes for the comparison meshes that finished loading. */
+	void OnCompareMeshesLoaded();
+
+	void RemoveComparePane(FSeatMeshPane& Pane);
+
+	/** Places the panes for the current layout. */
+	void LayoutComparePanes();
+
+	/** Updates the seat gizmos of the comparison meshes. */
+	void RefreshComparePaneSeats();
+
+	FReply CompareSelectedMeshes_Execute();
+	FReply ClearCompareMeshes_Execute();
+	ECheckBoxState GetCompareOverlaidState() const;
+	void OnCompareOverlaidChanged(ECheckBoxState InState);
+	ECheckBoxState GetShowSeatGizmosState() const;
+	void OnShowSeatGizmosChanged(ECheckBoxState InState);
+
+	void RefreshSeatGizmos();
+
+	/** Creates and registers the preview of one seat, called by the rebuild scheduler. */
+	void CreateSeatPreviewComponent(USeatSocket* SeatSocket);
+
+	/** Orders seats so the selected seat comes first, then seats in view, nearest first. */
+	void SortSeatsByPreviewPriority(TArray<USeatSocket*>& InOutSeats) const;
+
 	TSharedPtr<FEditorViewportClient> EditorViewportClient;
-	TSharedPtr<FAdvancedPreviewScene> PreviewScene;
+	/** Scene and posture poses shared with the other open seat map editors. */
+	TSharedPtr<FSeatPreviewWorld> PreviewWorld;
 	UStaticMesh* StaticMesh;
 	EViewModeIndex CurrentViewMode;
 	int32 LODSelection;
@@ -52,11 +118,22 @@ private:
 	TSharedPtr<FStaticMeshSocketEditor> StaticMeshSocketEditor;
 	USeatMap* SeatMap = nullptr;
 	TArray<USeatPreviewComponent*> SeatPreviewComponents;
+	TUniquePtr<FSeatPreviewRebuildScheduler> RebuildScheduler;
+	/** Mesh relative transform of every shown seat, template seats are placed by the mesh's template transform. */
+	TMap<const USeatSocket*, FTransform> SeatTransforms;
+	USeatGizmoComponent* SeatGizmoComponent = nullptr;
+	bool bShowSeatGizmos = false;
+	TArray<FSeatMeshPane> ComparePanes;
+	ESeatCompareLayout CompareLayout = ESeatCompareLayout::Tiled;
+	/** Keeps the comparison meshes loaded while they are shown. */
+	FStreamableManager CompareStreamableManager;
+	TSharedPtr<FStreamableHandle> CompareMeshesHandle;
 };
 
 class USeatMap;
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FStaticMeshChanged, UStaticMesh*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FSeatSelectionChanged, USeatSocket*);
 
 class FStaticMeshSocketEditor : public FAssetEditorToolkit
 {
@@ -76,8 +153,21 @@ public:
 	virtual FString GetWorldCentricTabPrefix() const override;
 	void InitSocketEditor();
 	void SetStaticMesh(UStaticMesh* InStaticMesh);
+
+	/**
+	 * Edits the mesh at once and streams it in if it is not loaded yet, its seats can be edited meanwhile.
+	 * OnStaticMeshChanged is broadcast with null right away and with the mesh once it has loaded.
+	 */
+	void LoadStaticMesh(const TSoftObjectPtr<UStaticMesh>& InStaticMesh);
+
 	UStaticMesh* GetStaticMesh() const;
 
+	/** The mesh whose seats are edited, set before the mesh itself has loaded. */
+	const TSoftObjectPtr<UStaticMesh>& GetEditedMesh() const { return EditedMesh; }
+	bool IsLoadingStaticMesh() const;
+	void SetSelectedSeat(USeatSocket* InSelectedSeat);
+	USeatSocket* GetSelectedSeat() const;
+
 	virtual void RegisterTabSpawners(const TSharedRef<FTabManager>& InTabManager) override;
 
 	TSharedRef<SDockTab> SpawnTab_CustomSocketEditorViewport(const FSpawnTabArgs& Args);
@@ -87,14 +177,23 @@ public:
 	static const FName CustomSocketEditorStaticMeshPickerTabId;
 
 	FStaticMeshChanged OnStaticMeshChanged;
+	FSeatSelectionChanged OnSeatSelectionChanged;
 private:
+	void OnStaticMeshLoaded();
+	void CancelStaticMeshLoad();
+
 	FLinearColor WorldCentricTabColorScale;
 	TWeakObjectPtr<UStaticMesh> StaticMesh;
+	TSoftObjectPtr<UStaticMesh> EditedMesh;
 	TWeakObjectPtr<UStaticMeshComponent> StaticMeshComponent;
 	TArray<TWeakObjectPtr<UStaticMeshSocket>> SelectedSockets;
+	TWeakObjectPtr<USeatSocket> SelectedSeat;
 	bool MutlipleSelect = false;
 	EViewModeIndex ViewMode = VMI_Lit;
 	UWorld* World = nullptr;
 	USeatMap* SeatMap = nullptr;
 	TSharedPtr<IStaticMeshEditor> StaticMeshEditor;
+	TSoftObjectPtr<UStaticMesh> InitialMesh;
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> StaticMeshHandle;
 };